@@ -0,0 +1,135 @@
+#include "bootstrap/Assemblies.h"
+#include "bootstrap/instances/BasePart.h"
+#include "bootstrap/instances/WeldConstraint.h"
+#include <algorithm>
+#include <unordered_map>
+
+Assemblies& Assemblies::Get() {
+    static Assemblies* a = new Assemblies(); // leaked: welds and parts may outlive static destruction order
+    return *a;
+}
+
+void Assemblies::NoteWelded(BasePart* p) {
+    if (p && p->AssemblySlot == kNone) p->AssemblySlot = kPending;
+}
+
+void Assemblies::AddWeld(WeldConstraint* w) {
+    w->Reg.index = (uint32_t)welds.size();
+    welds.push_back(w);
+    dirty = true;
+}
+
+void Assemblies::RemoveWeld(WeldConstraint* w) {
+    const uint32_t i = w->Reg.index;
+    if (i >= welds.size() || welds[i] != w) return;
+    welds[i] = welds.back();
+    welds[i]->Reg.index = i;
+    welds.pop_back();
+    w->Reg.index = kNone;
+    dirty = true;
+}
+
+uint32_t Assemblies::AssemblyOf(const BasePart* p) {
+    Update();
+    const uint32_t s = p->AssemblySlot;
+    return (s < parts.size() && parts[s] == p) ? owner[s] : kNone;
+}
+
+// Union-find over the active welds; each set becomes an assembly rooted at
+// its first part in weld order, and offsets come from the current CFrames.
+void Assemblies::rebuild() {
+    dirty = false;
+    ++version;
+    parts.clear();
+    offsets.clear();
+    owner.clear();
+    start.clear();
+
+    std::vector<BasePart*> nodes;
+    std::vector<uint32_t> parent;
+    std::unordered_map<const BasePart*, uint32_t> ids;
+    auto id = [&](BasePart* p){
+        auto [it, inserted] = ids.try_emplace(p, (uint32_t)nodes.size());
+        if (inserted) { nodes.push_back(p); parent.push_back(it->second); }
+        return it->second;
+    };
+    auto find = [&](uint32_t x){
+        while (parent[x] != x) { parent[x] = parent[parent[x]]; x = parent[x]; }
+        return x;
+    };
+    for (WeldConstraint* w : welds) {
+        if (!w->Active()) continue;
+        const uint32_t a = find(id(w->Part0.lock().get())), b = find(id(w->Part1.lock().get()));
+        // the earlier node stays the root, so roots follow weld order
+        if (a != b) parent[std::max(a, b)] = std::min(a, b);
+    }
+
+    // bucket the nodes by root; roots come first in their bucket since they are the lowest id
+    const uint32_t n = (uint32_t)nodes.size();
+    std::vector<uint32_t> assemblyOfRoot(n, kNone);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < n; ++i) if (find(i) == i) assemblyOfRoot[i] = count++;
+    start.assign(count + 1, 0);
+    for (uint32_t i = 0; i < n; ++i) ++start[assemblyOfRoot[find(i)] + 1];
+    for (uint32_t a = 0; a < count; ++a) start[a + 1] += start[a];
+    parts.resize(n);
+    offsets.resize(n);
+    owner.resize(n);
+    std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint32_t a = assemblyOfRoot[find(i)];
+        const uint32_t s = fill[a]++;
+        parts[s] = nodes[i];
+        owner[s] = a;
+        nodes[i]->AssemblySlot = s;
+    }
+    for (uint32_t a = 0; a < count; ++a) {
+        const CFrame toRoot = parts[start[a]]->CF.inverse();
+        offsets[start[a]] = CFrame();
+        for (uint32_t s = start[a] + 1; s < start[a + 1]; ++s) offsets[s] = toRoot * parts[s]->CF;
+    }
+    seen.assign(count, 0);
+    transforms = 0;
+}
+
+void Assemblies::place(uint32_t a, const CFrame& rootCFrame, uint32_t exact, const CFrame& exactCFrame) {
+    const uint32_t root = start[a];
+    for (uint32_t s = root; s < start[a + 1]; ++s) {
+        BasePart* p = parts[s];
+        p->CF = s == exact ? exactCFrame : s == root ? rootCFrame : rootCFrame * offsets[s];
+        p->PropertyChanged(kTransformProps);
+    }
+}
+
+void Assemblies::Move(uint32_t a, const CFrame& rootCFrame) {
+    Update();
+    if (a + 1 >= start.size()) return;
+    place(a, rootCFrame, kNone, rootCFrame);
+}
+
+void Assemblies::SetPartCFrame(BasePart* p, const CFrame& cf) {
+    const uint32_t a = p->AssemblySlot == kNone ? kNone : AssemblyOf(p);
+    if (a == kNone) {
+        p->CF = cf;
+        p->PropertyChanged(kTransformProps);
+        return;
+    }
+    const uint32_t s = p->AssemblySlot;
+    place(a, s == start[a] ? cf : cf * offsets[s].inverse(), s, cf);
+}
+
+void Assemblies::Transform(BasePart* const* list, size_t count, const CFrame& delta) {
+    Update();
+    if (++transforms == 0) { std::fill(seen.begin(), seen.end(), 0); transforms = 1; }
+    for (size_t i = 0; i < count; ++i) {
+        BasePart* p = list[i];
+        const uint32_t a = AssemblyOf(p);
+        if (a == kNone) {
+            p->CF = delta * p->CF;
+            p->PropertyChanged(kTransformProps);
+        } else if (seen[a] != transforms) {
+            seen[a] = transforms;
+            place(a, delta * parts[start[a]]->CF, kNone, CFrame());
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "core/datatypes/CFrame.h"
+
+struct BasePart;
+struct WeldConstraint;
+
+// Rigid assemblies: parts joined by enabled WeldConstraints, flattened into
+// arrays grouped by assembly. Each member keeps its offset from the
+// assembly's root part, so moving an assembly is one pass over its slice of
+// the arrays instead of a CFrame set per part from Lua. The PhysicsWorld
+// simulates each unanchored assembly as a single body built from the same
+// grouping.
+//
+// Welds only mark the table dirty; it is rebuilt on the next query. Parts that
+// are not welded to anything are not in the table, and a part's AssemblySlot
+// is only trusted if the member there points back at it. A part that no weld
+// has ever named keeps kNone, which lets its CFrame sets skip the rebuild.
+class Assemblies {
+public:
+    static constexpr uint32_t kNone    = 0xFFFFFFFFu;
+    static constexpr uint32_t kPending = 0xFFFFFFFEu;  // named by a weld since the last rebuild
+
+    // Called when a weld starts naming 'p'.
+    static void NoteWelded(BasePart* p);
+
+    static Assemblies& Get();
+
+    void AddWeld(WeldConstraint* w);
+    void RemoveWeld(WeldConstraint* w);
+    void MarkDirty() { dirty = true; }
+
+    // Rebuild from the welds if anything changed since the last call.
+    void Update() { if (dirty) rebuild(); }
+    // Moves on every rebuild, so other systems can tell when to regroup.
+    uint64_t Version() { Update(); return version; }
+
+    // Assembly of a welded part, kNone for parts welded to nothing.
+    uint32_t AssemblyOf(const BasePart* p);
+
+    uint32_t Count() { Update(); return (uint32_t)(start.size() ? start.size() - 1 : 0); }
+    // Members of assembly a are [Begin(a), End(a)) of Parts()/Offsets(); the root comes first.
+    uint32_t Begin(uint32_t a) const { return start[a]; }
+    uint32_t End(uint32_t a) const { return start[a + 1]; }
+    BasePart* const* Parts() const { return parts.data(); }
+    const CFrame*    Offsets() const { return offsets.data(); }  // in the root part's space
+
+    // Put assembly 'a' where its root part is at 'rootCFrame'.
+    void Move(uint32_t a, const CFrame& rootCFrame);
+    // Set one part's CFrame; the rest of its assembly keeps its offsets.
+    void SetPartCFrame(BasePart* p, const CFrame& cf);
+    // Apply 'delta' (in world space) to the listed parts, moving each
+    // assembly they belong to once and as a whole.
+    void Transform(BasePart* const* list, size_t count, const CFrame& delta);
+
+private:
+    void rebuild();
+    void place(uint32_t a, const CFrame& rootCFrame, uint32_t exact, const CFrame& exactCFrame);
+
+    std::vector<WeldConstraint*> welds;
+
+    std::vector<BasePart*> parts;     // members, grouped by assembly
+    std::vector<CFrame>    offsets;   // by member
+    std::vector<uint32_t>  owner;     // by member: its assembly
+    std::vector<uint32_t>  start;     // by assembly, plus one
+    std::vector<uint32_t>  seen;      // by assembly: last Transform that moved it
+    uint32_t transforms{0};
+    uint64_t version{0};
+    bool     dirty{false};
+};
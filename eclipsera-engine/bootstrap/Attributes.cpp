@@ -0,0 +1,166 @@
+#include "bootstrap/Attributes.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+static_assert(sizeof(AttributeList::Entry) <= 24, "attribute entries should stay small");
+
+// -------- interning --------
+namespace {
+struct AttrRegistry {
+    std::unordered_map<std::string, AttrId> ids;
+    std::vector<const std::string*> names; // id -> key in ids
+};
+AttrRegistry& registry() {
+    static AttrRegistry* r = new AttrRegistry(); // leaked: instances may outlive static dtors
+    return *r;
+}
+}
+
+AttrId InternAttribute(std::string_view name) {
+    auto& r = registry();
+    auto it = r.ids.find(std::string(name));
+    if (it != r.ids.end()) return it->second;
+    if (r.names.size() >= kInvalidAttr) return kInvalidAttr;
+    const AttrId id = (AttrId)r.names.size();
+    auto ins = r.ids.emplace(std::string(name), id).first;
+    r.names.push_back(&ins->first);
+    return id;
+}
+
+AttrId FindAttribute(std::string_view name) {
+    auto& r = registry();
+    auto it = r.ids.find(std::string(name));
+    return it == r.ids.end() ? kInvalidAttr : it->second;
+}
+
+const std::string& AttributeName(AttrId id) {
+    static const std::string empty;
+    auto& r = registry();
+    return id < r.names.size() ? *r.names[id] : empty;
+}
+
+// -------- Entry --------
+using Entry = AttributeList::Entry;
+
+Entry::Entry(AttrId id_, const Attribute& v) : id(id_), type(Type::Bool), slen(0) { u.d = 0; assign(v); }
+Entry::Entry(const Entry& o) : id(o.id), type(Type::Bool), slen(0) { u.d = 0; copyFrom(o); }
+Entry::Entry(Entry&& o) noexcept : u(o.u), id(o.id), type(o.type), slen(o.slen) { o.type = Type::Bool; }
+Entry::~Entry() { release(); }
+
+Entry& Entry::operator=(const Entry& o) {
+    if (this != &o) { release(); id = o.id; copyFrom(o); }
+    return *this;
+}
+Entry& Entry::operator=(Entry&& o) noexcept {
+    if (this != &o) {
+        release();
+        u = o.u; id = o.id; type = o.type; slen = o.slen;
+        o.type = Type::Bool;
+    }
+    return *this;
+}
+
+void Entry::release() {
+    if (type == Type::String && slen == kHeapLen) delete[] u.heap.ptr;
+    type = Type::Bool;
+}
+
+void Entry::copyFrom(const Entry& o) {
+    if (o.type == Type::String && o.slen == kHeapLen) {
+        u.heap.len = o.u.heap.len;
+        u.heap.ptr = new char[u.heap.len];
+        std::memcpy(u.heap.ptr, o.u.heap.ptr, u.heap.len);
+    } else {
+        u = o.u;
+    }
+    type = o.type;
+    slen = o.slen;
+}
+
+void Entry::assign(const Attribute& v) {
+    release();
+    if (auto* b = std::get_if<bool>(&v))            { u.b = *b; type = Type::Bool; }
+    else if (auto* d = std::get_if<double>(&v))     { u.d = *d; type = Type::Number; }
+    else if (auto* s = std::get_if<std::string>(&v)) {
+        if (s->size() <= kInlineChars) {
+            std::memcpy(u.sso, s->data(), s->size());
+            slen = (uint8_t)s->size();
+        } else {
+            u.heap.len = (uint32_t)s->size();
+            u.heap.ptr = new char[u.heap.len];
+            std::memcpy(u.heap.ptr, s->data(), u.heap.len);
+            slen = kHeapLen;
+        }
+        type = Type::String;
+    }
+    else if (auto* p = std::get_if<::Vector3>(&v))  { u.v3[0] = p->x; u.v3[1] = p->y; u.v3[2] = p->z; type = Type::Vector3; }
+    else if (auto* c = std::get_if<::Color>(&v))    { u.c = *c; type = Type::Color; }
+}
+
+std::string_view Entry::Str() const {
+    if (type != Type::String) return {};
+    return slen == kHeapLen ? std::string_view(u.heap.ptr, u.heap.len) : std::string_view(u.sso, slen);
+}
+
+Attribute Entry::Get() const {
+    switch (type) {
+        case Type::Bool:    return u.b;
+        case Type::Number:  return u.d;
+        case Type::String:  return std::string(Str());
+        case Type::Vector3: return ::Vector3{ u.v3[0], u.v3[1], u.v3[2] };
+        case Type::Color:   return u.c;
+    }
+    return false;
+}
+
+bool Entry::Equals(const Attribute& v) const {
+    switch (type) {
+        case Type::Bool:    { auto* b = std::get_if<bool>(&v);        return b && *b == u.b; }
+        case Type::Number:  { auto* d = std::get_if<double>(&v);      return d && *d == u.d; }
+        case Type::String:  { auto* s = std::get_if<std::string>(&v); return s && Str() == *s; }
+        case Type::Vector3: { auto* p = std::get_if<::Vector3>(&v);
+                              return p && p->x == u.v3[0] && p->y == u.v3[1] && p->z == u.v3[2]; }
+        case Type::Color:   { auto* c = std::get_if<::Color>(&v);
+                              return c && c->r == u.c.r && c->g == u.c.g && c->b == u.c.b && c->a == u.c.a; }
+    }
+    return false;
+}
+
+// -------- AttributeList --------
+static auto lowerBound(const std::vector<Entry>& v, AttrId id) {
+    return std::lower_bound(v.begin(), v.end(), id, [](const Entry& e, AttrId k){ return e.Id() < k; });
+}
+
+const Entry* AttributeList::Find(AttrId id) const {
+    auto it = lowerBound(entries, id);
+    return (it != entries.end() && it->Id() == id) ? &*it : nullptr;
+}
+
+bool AttributeList::Set(AttrId id, const Attribute& v) {
+    auto it = lowerBound(entries, id);
+    const size_t i = (size_t)(it - entries.begin());
+    if (it != entries.end() && it->Id() == id) {
+        if (it->Equals(v)) return false;
+        entries[i] = Entry(id, v);
+        return true;
+    }
+    entries.insert(entries.begin() + i, Entry(id, v));
+    return true;
+}
+
+bool AttributeList::Remove(AttrId id) {
+    auto it = lowerBound(entries, id);
+    if (it == entries.end() || it->Id() != id) return false;
+    entries.erase(entries.begin() + (it - entries.begin()));
+    return true;
+}
+
+size_t AttributeList::HeapBytes() const {
+    size_t n = entries.capacity() * sizeof(Entry);
+    for (auto& e : entries) {
+        auto s = e.Str();
+        if (s.size() > kInlineChars) n += s.size();
+    }
+    return n;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+// Raylib
+#include <raylib.h>
+
+// Value type exchanged with scripts; storage uses the compact AttributeList below.
+using Attribute = std::variant<bool,double,std::string,::Vector3,::Color>;
+
+// -------- interned attribute names --------
+using AttrId = uint16_t;
+constexpr AttrId kInvalidAttr = 0xFFFF;
+
+AttrId InternAttribute(std::string_view name);
+AttrId FindAttribute(std::string_view name);   // kInvalidAttr if never used
+const std::string& AttributeName(AttrId id);
+
+// -------- compact per-instance storage --------
+// One 24-byte entry per attribute, sorted by id. Strings up to kInlineChars
+// live inside the entry; longer ones take a single heap block.
+class AttributeList {
+public:
+    static constexpr size_t kInlineChars = 16;
+
+    struct Entry {
+        enum class Type : uint8_t { Bool, Number, String, Vector3, Color };
+
+        Entry(AttrId id, const Attribute& v);
+        Entry(const Entry& o);
+        Entry(Entry&& o) noexcept;
+        Entry& operator=(const Entry& o);
+        Entry& operator=(Entry&& o) noexcept;
+        ~Entry();
+
+        Attribute Get() const;
+        bool Equals(const Attribute& v) const;
+        std::string_view Str() const;
+
+        AttrId Id() const { return id; }
+
+    private:
+        static constexpr uint8_t kHeapLen = 0xFF;
+
+        union {
+            bool   b;
+            double d;
+            float  v3[3];
+            ::Color c;
+            char   sso[kInlineChars];
+            struct { char* ptr; uint32_t len; } heap;
+        } u;
+        AttrId  id;
+        Type    type;
+        uint8_t slen; // inline length, or kHeapLen
+
+        void assign(const Attribute& v);
+        void copyFrom(const Entry& o);
+        void release();
+    };
+
+    const Entry* Find(AttrId id) const;
+    // Returns false if the stored value was already equal.
+    bool Set(AttrId id, const Attribute& v);
+    bool Remove(AttrId id);
+    void Clear() { entries.clear(); entries.shrink_to_fit(); }
+
+    bool   Empty() const { return entries.empty(); }
+    size_t Size() const { return entries.size(); }
+    size_t HeapBytes() const;
+
+    auto begin() const { return entries.begin(); }
+    auto end()   const { return entries.end(); }
+
+private:
+    std::vector<Entry> entries;
+};
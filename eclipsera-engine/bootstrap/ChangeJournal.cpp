@@ -0,0 +1,76 @@
+#include "bootstrap/ChangeJournal.h"
+#include "bootstrap/Instance.h"
+#include <algorithm>
+
+ChangeJournal& ChangeJournal::Get() {
+    static ChangeJournal* j = new ChangeJournal(); // leaked: outlives static subscribers
+    return *j;
+}
+
+uint32_t ChangeJournal::GroupsForProps(uint64_t props) {
+    uint32_t g = 0;
+    if (props & kTransformProps) g |= Change_Transform;
+    if (props & PropBit(Prop::Size)) g |= Change_Shape;
+    if (props & (PropBit(Prop::Color) | PropBit(Prop::Transparency) |
+                 PropBit(Prop::Reflectance) | PropBit(Prop::CastShadow))) g |= Change_Appearance;
+    if (props & (PropBit(Prop::Anchored) | PropBit(Prop::CanCollide) | PropBit(Prop::CanTouch) |
+                 PropBit(Prop::Density) | PropBit(Prop::Friction) | PropBit(Prop::Elasticity) |
+                 PropBit(Prop::CollisionGroup))) g |= Change_Physics;
+    if (props & (PropBit(Prop::ClockTime) | PropBit(Prop::Brightness) | PropBit(Prop::Ambient))) g |= Change_Lighting;
+    if (props & PropBit(Prop::Parent)) g |= Change_Hierarchy;
+    if (props & (PropBit(Prop::Name) | PropBit(Prop::MouseIconEnabled))) g |= Change_Other;
+    return g;
+}
+
+ChangeJournal::Cursor ChangeJournal::Subscribe() {
+    const uint64_t head = base + records.size();
+    Cursor c = kNoCursor;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        if (cursors[i] == kNoSeq) { c = (Cursor)i; break; }
+    }
+    if (c == kNoCursor) { c = (Cursor)cursors.size(); cursors.push_back(head); }
+    else cursors[c] = head;
+
+    // never merge into records a new cursor has already skipped
+    if (head > readHigh) readHigh = head;
+    if (liveCursors++ == 0) Instance::JournaledProps = kAllProps;
+    return c;
+}
+
+void ChangeJournal::Unsubscribe(Cursor c) {
+    if (c >= cursors.size() || cursors[c] == kNoSeq) return;
+    cursors[c] = kNoSeq;
+    if (--liveCursors == 0) {
+        Instance::JournaledProps = 0;
+        records.clear();
+        base = readHigh = 0;
+        cursors.clear();
+    }
+}
+
+void ChangeJournal::Append(Instance* inst, uint32_t groups) {
+    if (!inst || !groups || liveCursors == 0) return;
+
+    // merge while no cursor has read the instance's latest record
+    const uint64_t seq = inst->JournalSeq;
+    if (seq != kNoSeq && seq >= base && seq >= readHigh && seq < base + records.size()) {
+        auto& r = records[(size_t)(seq - base)];
+        if (r.inst.get() == inst) { r.groups |= groups; return; }
+    }
+
+    auto sp = inst->weak_from_this().lock();
+    if (!sp) return; // under construction or being torn down
+    inst->JournalSeq = base + records.size();
+    records.push_back(Record{ std::move(sp), groups });
+}
+
+void ChangeJournal::EndFrame() {
+    if (records.empty()) return;
+    uint64_t minSeq = base + records.size();
+    for (uint64_t c : cursors) if (c != kNoSeq) minSeq = std::min(minSeq, c);
+    const size_t drop = (size_t)(minSeq - base);
+    if (drop == 0) return;
+    if (drop == records.size()) records.clear();
+    else records.erase(records.begin(), records.begin() + drop);
+    base = minSeq;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "bootstrap/Properties.h"
+
+struct Instance;
+
+// Property groups recorded by the journal.
+enum ChangeGroup : uint32_t {
+    Change_Hierarchy  = 1u << 0,  // parent changed (instance or one of its ancestors)
+    Change_Removed    = 1u << 1,  // destroyed
+    Change_Transform  = 1u << 2,  // CFrame / Position / Orientation
+    Change_Shape      = 1u << 3,  // Size
+    Change_Appearance = 1u << 4,  // Color / Transparency / Reflectance / CastShadow
+    Change_Physics    = 1u << 5,  // Anchored / CanCollide / CanTouch / Density / Friction / Elasticity / CollisionGroup
+    Change_Lighting   = 1u << 6,  // Lighting service properties
+    Change_Other      = 1u << 7,
+};
+
+// DataModel change journal.
+//
+// Setters, SetParent and Destroy append (instance, group mask) records while at
+// least one subscriber exists. Each subscriber owns a read cursor, so the
+// renderer, physics or a replication layer can each do O(changes) work per
+// frame. Repeated changes to the same instance merge into one record as long
+// as no cursor has read past it yet.
+class ChangeJournal {
+public:
+    struct Record {
+        std::shared_ptr<Instance> inst; // keeps the instance alive until every cursor has seen it
+        uint32_t groups;
+    };
+    using Cursor = uint32_t;
+    static constexpr Cursor   kNoCursor = 0xFFFFFFFFu;
+    static constexpr uint64_t kNoSeq    = ~uint64_t(0);
+
+    static ChangeJournal& Get();
+    static uint32_t GroupsForProps(uint64_t props);
+
+    bool Active() const { return liveCursors > 0; }
+
+    // New cursors start at the current head; callers sync existing state themselves.
+    Cursor Subscribe();
+    void   Unsubscribe(Cursor c);
+
+    // Visit every record appended since this cursor last read, then advance it.
+    template<class F>
+    void Read(Cursor c, F&& f) {
+        if (c >= cursors.size() || cursors[c] == kNoSeq) return;
+        const uint64_t head = base + records.size();
+        for (uint64_t s = cursors[c]; s < head; ++s) f(records[(size_t)(s - base)]);
+        cursors[c] = head;
+        if (head > readHigh) readHigh = head;
+    }
+
+    void Append(Instance* inst, uint32_t groups);
+
+    // Drop records every cursor has consumed. Called once per frame.
+    void EndFrame();
+
+    size_t PendingRecords() const { return records.size(); }
+    uint64_t TotalRecords() const { return base + records.size(); }
+
+private:
+    std::vector<Record>   records;
+    std::vector<uint64_t> cursors;   // next sequence to read, kNoSeq for free slots
+    uint64_t base{0};                // sequence number of records[0]
+    uint64_t readHigh{0};            // records below this were seen by some cursor
+    uint32_t liveCursors{0};
+};
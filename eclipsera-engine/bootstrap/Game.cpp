@@ -41,7 +41,7 @@ void Game::Init() {
     }
 
     // --- Precreate core services under 'game'
-    const char* defaults[] = { "Workspace", "RunService", "Lighting", "UserInputService" };
+    const char* defaults[] = { "Workspace", "RunService", "Lighting", "UserInputService", "CollectionService", "PhysicsService" };
     for (const char* n : defaults) {
         Service::Create(n);
     }
@@ -1,11 +1,18 @@
 #include "bootstrap/Instance.h"
+#include "bootstrap/services/CollectionService.h"
+#include "bootstrap/ChangeJournal.h"
+#include "bootstrap/signals/Signal.h"
+#include "bootstrap/Game.h"
 #include "core/logging/Logging.h"
 #include <algorithm>
+#include <bit>
 #include <unordered_map>
 
 // -------- ctors --------
 Instance::Instance(std::string name, InstanceClass c) : Name(std::move(name)), Class(c) {}
-Instance::~Instance() = default;
+Instance::~Instance() {
+    if (!Tags.empty()) CollectionService::Forget(this);
+}
 
 // instance classname mapping
 static const char* ToClassName(InstanceClass c) {
@@ -20,6 +27,10 @@ static const char* ToClassName(InstanceClass c) {
         case InstanceClass::RunService:  return "RunService";
         case InstanceClass::UserInputService:    return "UserInputService";
         case InstanceClass::Lighting:    return "Lighting";
+        case InstanceClass::CollectionService: return "CollectionService";
+        case InstanceClass::PhysicsService:    return "PhysicsService";
+        case InstanceClass::Model:             return "Model";
+        case InstanceClass::WeldConstraint:    return "WeldConstraint";
         default:                         return "Unknown";
     }
 }
@@ -27,13 +38,20 @@ static const char* ToClassName(InstanceClass c) {
 // -------- attributes --------
 void Instance::SetAttribute(const std::string& name, const Attribute& value) {
     if (name.empty()) return;
-    Attributes[name] = value;
-    LOGI("SetAttribute: %s.%s", Name.c_str(), name.c_str());
+    const AttrId id = InternAttribute(name);
+    if (id == kInvalidAttr) return;
+    if (Attributes.Set(id, value)) fireAttributeChanged(id);
+}
+void Instance::RemoveAttribute(const std::string& name) {
+    const AttrId id = FindAttribute(name);
+    if (id != kInvalidAttr && Attributes.Remove(id)) fireAttributeChanged(id);
 }
 std::optional<Attribute> Instance::GetAttribute(const std::string& name) const {
-    auto it = Attributes.find(name);
-    if (it == Attributes.end()) return std::nullopt;
-    return it->second;
+    const AttrId id = FindAttribute(name);
+    if (id == kInvalidAttr) return std::nullopt;
+    auto* e = Attributes.Find(id);
+    if (!e) return std::nullopt;
+    return e->Get();
 }
 
 // -------- tiny signal system --------
@@ -43,12 +61,150 @@ size_t Instance::OnDescendantAdded(CB cb){ auto id=nextId++; descAdded_[id]=std:
 size_t Instance::OnDescendantRemoved(CB cb){ auto id=nextId++; descRemoved_[id]=std::move(cb); return id; }
 void   Instance::Disconnect(size_t id){
     childAdded_.erase(id); childRemoved_.erase(id); descAdded_.erase(id); descRemoved_.erase(id);
+    if (propObs_) {
+        auto& subs = propObs_->subs;
+        auto it = std::find_if(subs.begin(), subs.end(), [id](const PropertyObservers::Sub& s){ return s.id == id; });
+        if (it != subs.end()) { subs.erase(it); recomputeObservedProps(); }
+    }
 }
 void Instance::fireChildAdded(const std::shared_ptr<Instance>& c){ for(auto& kv:childAdded_) kv.second(c); }
 void Instance::fireChildRemoved(const std::shared_ptr<Instance>& c){ for(auto& kv:childRemoved_) kv.second(c); }
 void Instance::fireDescendantAdded(const std::shared_ptr<Instance>& c){ for(auto& kv:descAdded_) kv.second(c); }
 void Instance::fireDescendantRemoved(const std::shared_ptr<Instance>& c){ for(auto& kv:descRemoved_) kv.second(c); }
 
+// -------- property change signals --------
+static LuaScheduler* currentScheduler() {
+    return (g_game && g_game->luaScheduler) ? g_game->luaScheduler.get() : nullptr;
+}
+
+// per-instance signals rarely see more than a couple of listeners; the default
+// capacity would reserve hundreds of KB each
+static constexpr size_t kInstanceSignalCapacity = 4;
+
+// property signals keep ObservedProps in step as their first listener arrives
+// or their last one leaves, so firing never has to rescan
+std::shared_ptr<RTScriptSignal> Instance::newPropSignal() {
+    auto sig = std::make_shared<RTScriptSignal>(currentScheduler(), kInstanceSignalCapacity);
+    sig->OnListenersChanged = [w = weak_from_this()] {
+        if (auto self = w.lock()) self->recomputeObservedProps();
+    };
+    return sig;
+}
+
+size_t Instance::OnPropertyChanged(uint64_t mask, PropCB cb) {
+    if (!propObs_) propObs_ = std::make_shared<PropertyObservers>();
+    auto id = nextId++;
+    propObs_->subs.push_back({ id, mask, std::move(cb) });
+    ObservedProps |= mask;
+    return id;
+}
+
+std::shared_ptr<RTScriptSignal> Instance::GetChangedSignal() {
+    if (!propObs_) propObs_ = std::make_shared<PropertyObservers>();
+    if (!propObs_->changed) propObs_->changed = newPropSignal();
+    return propObs_->changed;
+}
+
+std::shared_ptr<RTScriptSignal> Instance::GetPropertyChangedSignal(Prop p) {
+    if (p >= Prop::Count) return nullptr;
+    if (!propObs_) propObs_ = std::make_shared<PropertyObservers>();
+    auto& sig = propObs_->byProp[(int)p];
+    if (!sig) sig = newPropSignal();
+    return sig;
+}
+
+std::shared_ptr<RTScriptSignal> Instance::GetAttributeChangedSignal(AttrId id) {
+    if (id == kInvalidAttr) return nullptr;
+    if (!propObs_) propObs_ = std::make_shared<PropertyObservers>();
+    for (auto& [aid, sig] : propObs_->byAttr) if (aid == id) return sig;
+    auto sig = std::make_shared<RTScriptSignal>(currentScheduler(), kInstanceSignalCapacity);
+    propObs_->byAttr.emplace_back(id, sig);
+    return sig;
+}
+
+std::shared_ptr<RTScriptSignal> Instance::GetAttributeChangedAnySignal() {
+    if (!propObs_) propObs_ = std::make_shared<PropertyObservers>();
+    if (!propObs_->attrChanged) propObs_->attrChanged = std::make_shared<RTScriptSignal>(currentScheduler(), kInstanceSignalCapacity);
+    return propObs_->attrChanged;
+}
+
+void Instance::fireAttributeChanged(AttrId id) {
+    auto obs = propObs_;
+    if (!obs || (!obs->attrChanged && obs->byAttr.empty())) return;
+    auto self = weak_from_this().lock();
+
+    LuaScheduler* sch = currentScheduler();
+    lua_State* Lm = sch ? sch->GetMainState() : nullptr;
+    if (!Lm) return;
+
+    for (size_t i = 0; i < obs->byAttr.size(); ++i) {
+        if (obs->byAttr[i].first != id) continue;
+        auto sig = obs->byAttr[i].second;
+        if (!sig->IsClosed()) sig->Fire(Lm, lua_gettop(Lm) + 1, 0);
+        break;
+    }
+    if (auto sig = obs->attrChanged; sig && !sig->IsClosed()) {
+        const std::string& name = AttributeName(id);
+        lua_pushlstring(Lm, name.data(), name.size());
+        sig->Fire(Lm, lua_gettop(Lm), 1);
+        lua_pop(Lm, 1);
+    }
+
+    // forget per-attribute signals scripts can no longer reach
+    auto& v = obs->byAttr;
+    v.erase(std::remove_if(v.begin(), v.end(), [](const auto& e){
+        return e.second.use_count() == 1 && !e.second->HasListeners();
+    }), v.end());
+}
+
+void Instance::recomputeObservedProps() {
+    uint64_t m = 0;
+    if (propObs_) {
+        // only signals someone is listening to count; this can run from inside
+        // a signal's Fire, so it must not drop any of them
+        for (auto& s : propObs_->subs) m |= s.mask;
+        if (propObs_->changed && propObs_->changed->HasListeners()) m = kAllProps;
+        for (int i = 0; i < (int)Prop::Count; ++i)
+            if (propObs_->byProp[i] && propObs_->byProp[i]->HasListeners()) m |= PropBit((Prop)i);
+    }
+    ObservedProps = m;
+}
+
+void Instance::firePropertyChanged(uint64_t props) {
+    if (props & JournaledProps) ChangeJournal::Get().Append(this, ChangeJournal::GroupsForProps(props));
+
+    // handlers may disconnect, reparent or destroy us
+    auto self = weak_from_this().lock();
+    auto obs  = propObs_;
+    if (!obs || !(props & ObservedProps)) return;
+
+    LuaScheduler* sch = currentScheduler();
+    lua_State* Lm = sch ? sch->GetMainState() : nullptr;
+
+    uint64_t pending = props & ObservedProps;
+    while (pending) {
+        const int bit = std::countr_zero(pending);
+        pending &= pending - 1;
+        const Prop p = (Prop)bit;
+        const uint64_t pb = PropBit(p);
+
+        for (size_t i = 0; i < obs->subs.size(); ++i) {
+            if (!(obs->subs[i].mask & pb)) continue;
+            auto cb = obs->subs[i].cb; // the vector may shrink under us
+            cb(this, p);
+        }
+        if (!Lm) continue;
+        if (auto& sig = obs->byProp[bit]; sig && !sig->IsClosed()) {
+            sig->Fire(Lm, lua_gettop(Lm) + 1, 0);
+        }
+        if (obs->changed && !obs->changed->IsClosed()) {
+            lua_pushstring(Lm, PropName(p));
+            obs->changed->Fire(Lm, lua_gettop(Lm), 1);
+            lua_pop(Lm, 1);
+        }
+    }
+}
+
 // helper: apply f to node and all descendants
 static void forEachDesc(const std::shared_ptr<Instance>& n,
                         const std::function<void(const std::shared_ptr<Instance>&)>& f){
@@ -66,6 +222,10 @@ void Instance::SetParent(const std::shared_ptr<Instance>& parent) {
         if (!(parent && parent->Class == InstanceClass::Game)) return;
     }
 
+    // tag index only cares about DataModel membership changes
+    const bool tracksTags = CollectionService::TagCount() > 0;
+    const bool wasInGame  = tracksTags && CollectionService::IsInDataModel(this);
+
     // detach from old
     if (auto old = Parent.lock()) {
         old->Children.erase(std::remove(old->Children.begin(), old->Children.end(), self), old->Children.end());
@@ -94,6 +254,21 @@ void Instance::SetParent(const std::shared_ptr<Instance>& parent) {
             forEachDesc(self, [&](const std::shared_ptr<Instance>& d){ a->fireDescendantAdded(d); });
         }
     }
+
+    if (tracksTags) {
+        const bool nowInGame = CollectionService::IsInDataModel(this);
+        if (nowInGame != wasInGame) CollectionService::OnAncestryChanged(this, nowInGame);
+    }
+
+    // descendants moved with us; the Parent notification below records this instance
+    if (JournaledProps) {
+        auto& journal = ChangeJournal::Get();
+        for (auto& c : Children) {
+            forEachDesc(c, [&](const std::shared_ptr<Instance>& d){ journal.Append(d.get(), Change_Hierarchy); });
+        }
+    }
+
+    PropertyChanged(PropBit(Prop::Parent));
 }
 
 // -------- destroy --------
@@ -103,6 +278,7 @@ void Instance::Destroy() {
     LOGI("Instance::Destroy '%s'", Name.c_str());
 
     auto self = shared_from_this();
+    const bool wasInGame = CollectionService::TagCount() > 0 && CollectionService::IsInDataModel(this);
 
     // notify and detach from parent first
     if (auto p = Parent.lock()) {
@@ -116,12 +292,17 @@ void Instance::Destroy() {
         }
     }
     Parent.reset();
+    if (JournaledProps) ChangeJournal::Get().Append(this, Change_Removed | Change_Hierarchy);
+
+    // leave tag member lists before the subtree is torn down
+    if (wasInGame) CollectionService::OnAncestryChanged(this, false);
 
     // destroy children
     for (auto& c : Children) if (c) c->Destroy();
     Children.clear();
     ChildrenByName.clear();
-    Attributes.clear();
+    Attributes.Clear();
+    Tags.clear();
 }
 
 void Instance::LegacyFunctionRemove() {
@@ -156,6 +337,9 @@ std::shared_ptr<Instance> Instance::Clone() const {
         dst->childRemoved_.clear();
         dst->descAdded_.clear();
         dst->descRemoved_.clear();
+        dst->propObs_.reset();
+        dst->ObservedProps = 0;
+        dst->JournalSeq = ChangeJournal::kNoSeq;
         dst->nextId = 1;
 
         // Reapply canonical base values
@@ -163,6 +347,8 @@ std::shared_ptr<Instance> Instance::Clone() const {
         dst->Class      = src->Class;
         dst->Alive      = true;
         dst->Attributes = src->Attributes;
+        dst->Tags       = src->Tags;
+        for (auto& t : dst->Tags) t.slot = TagRef::npos; // indexed once parented into the DataModel
 
         map.emplace(src, dst);
 
@@ -197,6 +383,7 @@ void Instance::SetName(const std::string& newName) {
         p->ChildrenByName[newName] = shared_from_this();
     }
     Name = newName;
+    PropertyChanged(PropBit(Prop::Name));
 }
 
 std::string Instance::GetFullName() const {
@@ -227,6 +414,12 @@ bool Instance::IsA(const std::string& className) const {
         case InstanceClass::Game:
             if (className == "DataModel") return true; // Roblox alias
             break;
+        case InstanceClass::Part:
+            if (className == "BasePart" || className == "PVInstance") return true;
+            break;
+        case InstanceClass::Model:
+            if (className == "PVInstance") return true;
+            break;
         default:
             break;
     }
@@ -8,12 +8,17 @@
 #include <functional>
 #include <type_traits>
 #include <utility>
+#include <cstdint>
 
 // Raylib
 #include <raylib.h>
 
+#include "bootstrap/Properties.h"
+#include "bootstrap/Attributes.h"
+
 // Forward declare Lua to avoid coupling headers to Lua includes
 struct lua_State;
+struct RTScriptSignal;
 
 enum class InstanceClass {
     Game,
@@ -26,9 +31,12 @@ enum class InstanceClass {
     RunService,
     Lighting,
     Unknown,
-    UserInputService,    
+    UserInputService,
+    CollectionService,
+    PhysicsService,
+    Model,
+    WeldConstraint,
 };
-using Attribute = std::variant<bool,double,std::string,::Vector3,::Color>;
 
 struct Instance : std::enable_shared_from_this<Instance> {
     // -------- core state --------
@@ -39,8 +47,16 @@ struct Instance : std::enable_shared_from_this<Instance> {
     std::unordered_map<std::string, std::shared_ptr<Instance>> ChildrenByName;
     bool Alive{ true };
 
-    // Attributes
-    std::unordered_map<std::string, Attribute> Attributes;
+    // Attributes (sorted by interned id, see Attributes.h)
+    AttributeList Attributes;
+
+    // Tags (see CollectionService); slot is our index in the tag's member list, npos while outside the DataModel
+    struct TagRef {
+        static constexpr uint32_t npos = 0xFFFFFFFFu;
+        uint16_t id;
+        uint32_t slot;
+    };
+    std::vector<TagRef> Tags;
 
     // -------- ctor/dtor --------
     Instance(std::string name, InstanceClass c);
@@ -77,8 +93,11 @@ struct Instance : std::enable_shared_from_this<Instance> {
 
     // -------- attributes API --------
     void SetAttribute(const std::string& name, const Attribute& value);
+    void RemoveAttribute(const std::string& name);
     std::optional<Attribute> GetAttribute(const std::string& name) const;
-    const std::unordered_map<std::string, Attribute>& GetAttributes() const { return Attributes; }
+    const AttributeList& GetAttributes() const { return Attributes; }
+    std::shared_ptr<RTScriptSignal> GetAttributeChangedSignal(AttrId id); // fires with no arguments
+    std::shared_ptr<RTScriptSignal> GetAttributeChangedAnySignal();       // AttributeChanged(name)
 
     // -------- signals --------
     using CB = std::function<void(const std::shared_ptr<Instance>&)>;
@@ -88,6 +107,20 @@ struct Instance : std::enable_shared_from_this<Instance> {
     size_t OnDescendantRemoved(CB cb);
     void   Disconnect(size_t id);
 
+    // -------- property change notification --------
+    // One bit per Prop that has an observer; an unobserved set costs a single test.
+    uint64_t ObservedProps{0};
+    // Props recorded by the ChangeJournal; kAllProps while it has subscribers, 0 otherwise.
+    static inline uint64_t JournaledProps{0};
+    // Sequence number of our latest journal record (ChangeJournal::kNoSeq if none).
+    uint64_t JournalSeq{~uint64_t(0)};
+    void PropertyChanged(uint64_t props) { if ((ObservedProps | JournaledProps) & props) firePropertyChanged(props); }
+
+    using PropCB = std::function<void(Instance*, Prop)>;
+    size_t OnPropertyChanged(uint64_t mask, PropCB cb);   // C++ subscribers, remove with Disconnect(id)
+    std::shared_ptr<RTScriptSignal> GetChangedSignal();                // Changed(propertyName)
+    std::shared_ptr<RTScriptSignal> GetPropertyChangedSignal(Prop p);  // fires with no arguments
+
     // -------- cloning --------
     using CloneMap = std::unordered_map<const Instance*, std::shared_ptr<Instance>>;
 
@@ -164,5 +197,20 @@ private:
     void fireDescendantAdded(const std::shared_ptr<Instance>& c);
     void fireDescendantRemoved(const std::shared_ptr<Instance>& c);
 
+    // allocated on first observer so unobserved instances pay one pointer
+    struct PropertyObservers {
+        struct Sub { size_t id; uint64_t mask; PropCB cb; };
+        std::vector<Sub> subs;
+        std::shared_ptr<RTScriptSignal> changed;
+        std::shared_ptr<RTScriptSignal> byProp[(int)Prop::Count];
+        std::shared_ptr<RTScriptSignal> attrChanged;
+        std::vector<std::pair<AttrId, std::shared_ptr<RTScriptSignal>>> byAttr;
+    };
+    std::shared_ptr<PropertyObservers> propObs_;
+    void firePropertyChanged(uint64_t props);
+    void fireAttributeChanged(AttrId id);
+    void recomputeObservedProps();
+    std::shared_ptr<RTScriptSignal> newPropSignal();
+
     static std::unordered_map<std::string, TypeInfo>& types();
 };
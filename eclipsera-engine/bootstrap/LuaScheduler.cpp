@@ -2,14 +2,13 @@
 #include "bootstrap/LuaScheduler.h"
 #include "bootstrap/instances/BaseScript.h"
 #include "core/logging/Logging.h"
+#include "core/runtime/Time.h"
 
+#include <cmath>
 #include <cstdlib>
 #include <limits>
 #include <algorithm>
 
-// Raylib time
-#include <raylib.h>
-
 // Luau
 #include "lua.h"
 #include "lualib.h"
@@ -153,7 +152,7 @@ void LuaScheduler::AddScript(const std::shared_ptr<BaseScript>& script,
     st.co           = co;
     st.wakeTime     = 0.0;
     st.nextFrame    = false;
-    st.lastResumeTime = GetTime();
+    st.lastResumeTime = timing::Now();
     st.passDelta    = false;
     st.resumeDelta  = 0.0;
     st.firstResume  = true;
@@ -201,7 +200,7 @@ void LuaScheduler::ScheduleTaskNextFrame(lua_State* co, int registryRef, int ini
     st.registryRef  = registryRef;
     st.nextFrame    = true;
     st.wakeTime     = 0.0;
-    st.lastResumeTime = GetTime();
+    st.lastResumeTime = timing::Now();
     st.passDelta    = false;
     st.resumeDelta  = 0.0;
     st.firstResume  = true;
@@ -217,7 +216,7 @@ void LuaScheduler::ScheduleTaskAt(lua_State* co, int registryRef, double wakeTim
     st.registryRef  = registryRef;
     st.nextFrame    = false;
     st.wakeTime     = wakeTimeAbs;
-    st.lastResumeTime = GetTime();
+    st.lastResumeTime = timing::Now();
     st.passDelta    = false;
     st.resumeDelta  = 0.0;
     st.firstResume  = true;
@@ -379,7 +378,7 @@ void LuaScheduler::Step(double now, double /*dt*/) {
             st.status = Status::Error;
         }
 
-        if ((resumes & 7) == 0) t = GetTime();
+        if ((resumes & 7) == 0) t = timing::Now();
     }
 
     // Resume TASK coroutines
@@ -472,6 +471,6 @@ void LuaScheduler::Step(double now, double /*dt*/) {
             tasks.erase(it);
         }
 
-        if ((resumes & 7) == 0) t = GetTime();
+        if ((resumes & 7) == 0) t = timing::Now();
     }
 }
@@ -0,0 +1,37 @@
+#include "bootstrap/Properties.h"
+#include <cstring>
+
+static const char* const kPropNames[(int)Prop::Count] = {
+    "Name",
+    "Parent",
+    "CFrame",
+    "Position",
+    "Orientation",
+    "Size",
+    "Transparency",
+    "Reflectance",
+    "Color",
+    "Anchored",
+    "CanCollide",
+    "CanTouch",
+    "CastShadow",
+    "Density",
+    "Friction",
+    "Elasticity",
+    "CollisionGroup",
+    "ClockTime",
+    "Brightness",
+    "Ambient",
+    "MouseIconEnabled",
+};
+
+const char* PropName(Prop p) {
+    return p < Prop::Count ? kPropNames[(int)p] : "";
+}
+
+Prop PropFromName(const char* name) {
+    if (!name) return Prop::Count;
+    for (int i = 0; i < (int)Prop::Count; ++i)
+        if (std::strcmp(kPropNames[i], name) == 0) return (Prop)i;
+    return Prop::Count;
+}
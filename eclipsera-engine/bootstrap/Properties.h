@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+
+// Engine property ids. Each id owns one bit of Instance::ObservedProps, so
+// keep the list under 64 entries.
+enum class Prop : uint8_t {
+    Name,
+    Parent,
+    // BasePart
+    CFrame,
+    Position,
+    Orientation,
+    Size,
+    Transparency,
+    Reflectance,
+    Color,
+    Anchored,
+    CanCollide,
+    CanTouch,
+    CastShadow,
+    Density,
+    Friction,
+    Elasticity,
+    CollisionGroup,
+    // Lighting
+    ClockTime,
+    Brightness,
+    Ambient,
+    // UserInputService
+    MouseIconEnabled,
+
+    Count
+};
+static_assert((int)Prop::Count <= 64, "Prop ids must fit the observer bitmask");
+
+constexpr uint64_t PropBit(Prop p) { return uint64_t(1) << (unsigned)p; }
+constexpr uint64_t kAllProps = ~uint64_t(0);
+
+// setting CFrame/Position/Orientation changes all three
+constexpr uint64_t kTransformProps = PropBit(Prop::CFrame) | PropBit(Prop::Position) | PropBit(Prop::Orientation);
+
+const char* PropName(Prop p);
+// returns Prop::Count for unknown names
+Prop PropFromName(const char* name);
@@ -0,0 +1,383 @@
+#include "bootstrap/QueryParams.h"
+#include "bootstrap/ScriptingAPI.h"
+#include "bootstrap/instances/BasePart.h"
+#include "bootstrap/instances/Workspace.h"
+#include "core/datatypes/CFrame.h"
+#include "core/datatypes/Enum.h"
+#include "core/datatypes/LuaDatatypes.h"
+#include "core/datatypes/Vector3Game.h"
+#include "lua.h"
+#include "lualib.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <unordered_map>
+
+static constexpr const char* kRaycastMeta = "Librebox.RaycastParams";
+static constexpr const char* kOverlapMeta = "Librebox.OverlapParams";
+static constexpr const char* kResultMeta  = "Librebox.RaycastResult";
+
+// RaycastMany result record, little-endian: distance (-1 on a miss), position
+// xyz, normal xyz as f32, then the hit part's 1-based index into the returned
+// parts table (0 on a miss) as u32.
+static constexpr size_t kRayInStride  = 12;
+static constexpr size_t kRayOutStride = 32;
+
+struct RaycastResultData {
+    std::shared_ptr<Instance> instance;
+    Vector3Game position, normal;
+    float distance;
+};
+
+// Instance userdata at idx, or nullptr for any other value.
+static std::shared_ptr<Instance>* testInstance(lua_State* L, int idx) {
+    auto* p = static_cast<std::shared_ptr<Instance>*>(lb::luaL_testudata(L, idx, "Librebox.Instance"));
+    return (p && *p) ? p : nullptr;
+}
+
+static std::shared_ptr<Instance> checkInstanceArg(lua_State* L, int idx) {
+    auto* p = static_cast<std::shared_ptr<Instance>*>(luaL_checkudata(L, idx, "Librebox.Instance"));
+    if (!p || !*p) luaL_error(L, "expected Instance");
+    return *p;
+}
+
+void FilterParams::ToFilter(QueryFilter& out) const {
+    out.instances.clear();
+    for (const auto& w : filter) if (auto i = w.lock()) out.instances.push_back(i.get());
+    std::sort(out.instances.begin(), out.instances.end());
+    out.include = include;
+    out.respectCanCollide = respectCanCollide;
+}
+
+// -------- RaycastParams / OverlapParams --------
+static RaycastParams* checkRaycastParams(lua_State* L, int idx) {
+    return static_cast<RaycastParams*>(luaL_checkudata(L, idx, kRaycastMeta));
+}
+
+static OverlapParams* checkOverlapParams(lua_State* L, int idx) {
+    return static_cast<OverlapParams*>(luaL_checkudata(L, idx, kOverlapMeta));
+}
+
+static FilterParams* checkFilterParams(lua_State* L, int idx) {
+    if (void* p = lb::luaL_testudata(L, idx, kRaycastMeta)) return static_cast<RaycastParams*>(p);
+    if (void* p = lb::luaL_testudata(L, idx, kOverlapMeta)) return static_cast<OverlapParams*>(p);
+    luaL_typeerror(L, idx, "RaycastParams or OverlapParams");
+    return nullptr;
+}
+
+RaycastParams* Lua_OptRaycastParams(lua_State* L, int idx) {
+    if (lua_isnoneornil(L, idx)) return nullptr;
+    return checkRaycastParams(L, idx);
+}
+
+OverlapParams* Lua_OptOverlapParams(lua_State* L, int idx) {
+    if (lua_isnoneornil(L, idx)) return nullptr;
+    return checkOverlapParams(L, idx);
+}
+
+// Instances from an array table, or a single Instance; other values are skipped.
+static void appendInstances(lua_State* L, int idx, std::vector<std::weak_ptr<Instance>>& out) {
+    if (auto* one = testInstance(L, idx)) { out.push_back(*one); return; }
+    luaL_checktype(L, idx, LUA_TTABLE);
+    const int n = lua_objlen(L, idx);
+    for (int i = 1; i <= n; ++i) {
+        lua_rawgeti(L, idx, i);
+        if (auto* p = testInstance(L, -1)) out.push_back(*p);
+        lua_pop(L, 1);
+    }
+}
+
+// Enum.RaycastFilterType item ({Name, Value}) or its name.
+static bool checkFilterType(lua_State* L, int idx) {
+    if (lua_type(L, idx) == LUA_TSTRING) {
+        const char* s = lua_tostring(L, idx);
+        if (!strcmp(s, "Include") || !strcmp(s, "Whitelist")) return true;
+        if (!strcmp(s, "Exclude") || !strcmp(s, "Blacklist")) return false;
+    } else if (lua_istable(L, idx)) {
+        lua_getfield(L, idx, "Value");
+        const int v = (int)lua_tointeger(L, -1);
+        lua_pop(L, 1);
+        return v == 1;
+    }
+    luaL_error(L, "FilterType expects Enum.RaycastFilterType");
+    return false;
+}
+
+static int fp_addToFilter(lua_State* L) {
+    appendInstances(L, 2, checkFilterParams(L, 1)->filter);
+    return 0;
+}
+
+// Shared members; false when 'k' is not one of them.
+static bool filterIndex(lua_State* L, const FilterParams& p, const char* k) {
+    if (!strcmp(k, "FilterDescendantsInstances")) {
+        lua_createtable(L, (int)p.filter.size(), 0);
+        int n = 0;
+        for (const auto& w : p.filter)
+            if (auto i = w.lock()) { Lua_PushInstance(L, i); lua_rawseti(L, -2, ++n); }
+        return true;
+    }
+    if (!strcmp(k, "FilterType")) {
+        Enum* e = EnumRegistry::Instance().GetEnum("RaycastFilterType");
+        Lua_PushEnumItem(L, e ? e->GetItem(p.include ? "Include" : "Exclude") : nullptr);
+        return true;
+    }
+    if (!strcmp(k, "RespectCanCollide")) { lua_pushboolean(L, p.respectCanCollide); return true; }
+    if (!strcmp(k, "AddToFilter"))       { lua_pushcfunction(L, fp_addToFilter, "AddToFilter"); return true; }
+    return false;
+}
+
+static bool filterNewIndex(lua_State* L, FilterParams& p, const char* k) {
+    if (!strcmp(k, "FilterDescendantsInstances")) { p.filter.clear(); appendInstances(L, 3, p.filter); return true; }
+    if (!strcmp(k, "FilterType"))        { p.include = checkFilterType(L, 3); return true; }
+    if (!strcmp(k, "RespectCanCollide")) { p.respectCanCollide = lua_toboolean(L, 3) != 0; return true; }
+    return false;
+}
+
+template <class T>
+static int newParams(lua_State* L, const char* meta) {
+    void* mem = lua_newuserdatadtor(L, sizeof(T), [](void* p){ static_cast<T*>(p)->~T(); });
+    new (mem) T();
+    luaL_getmetatable(L, meta);
+    lua_setmetatable(L, -2);
+    return 1;
+}
+
+static int rp_new(lua_State* L) { return newParams<RaycastParams>(L, kRaycastMeta); }
+static int op_new(lua_State* L) { return newParams<OverlapParams>(L, kOverlapMeta); }
+
+static int rp_index(lua_State* L) {
+    const RaycastParams* p = checkRaycastParams(L, 1);
+    const char* k = luaL_checkstring(L, 2);
+    if (filterIndex(L, *p, k)) return 1;
+    if (!strcmp(k, "IgnoreWater")) { lua_pushboolean(L, p->ignoreWater); return 1; }
+    luaL_error(L, "%s is not a valid member of RaycastParams", k);
+    return 0;
+}
+
+static int rp_newindex(lua_State* L) {
+    RaycastParams* p = checkRaycastParams(L, 1);
+    const char* k = luaL_checkstring(L, 2);
+    if (filterNewIndex(L, *p, k)) return 0;
+    if (!strcmp(k, "IgnoreWater")) { p->ignoreWater = lua_toboolean(L, 3) != 0; return 0; }
+    luaL_error(L, "%s is not a valid member of RaycastParams", k);
+    return 0;
+}
+
+static int op_index(lua_State* L) {
+    const OverlapParams* p = checkOverlapParams(L, 1);
+    const char* k = luaL_checkstring(L, 2);
+    if (filterIndex(L, *p, k)) return 1;
+    if (!strcmp(k, "MaxParts")) { lua_pushinteger(L, p->maxParts); return 1; }
+    luaL_error(L, "%s is not a valid member of OverlapParams", k);
+    return 0;
+}
+
+static int op_newindex(lua_State* L) {
+    OverlapParams* p = checkOverlapParams(L, 1);
+    const char* k = luaL_checkstring(L, 2);
+    if (filterNewIndex(L, *p, k)) return 0;
+    if (!strcmp(k, "MaxParts")) {
+        const int n = luaL_checkinteger(L, 3);
+        if (n < 0) luaL_error(L, "MaxParts must be 0 (no limit) or positive");
+        p->maxParts = n;
+        return 0;
+    }
+    luaL_error(L, "%s is not a valid member of OverlapParams", k);
+    return 0;
+}
+
+static int rp_tostring(lua_State* L) {
+    lua_pushliteral(L, "RaycastParams");
+    return 1;
+}
+
+static int op_tostring(lua_State* L) {
+    lua_pushliteral(L, "OverlapParams");
+    return 1;
+}
+
+// -------- RaycastResult --------
+void Lua_PushRaycastResult(lua_State* L, const PhysicsWorld::RayHit& hit) {
+    void* mem = lua_newuserdatadtor(L, sizeof(RaycastResultData), [](void* p){ static_cast<RaycastResultData*>(p)->~RaycastResultData(); });
+    new (mem) RaycastResultData{ hit.part->shared_from_this(), Vector3Game::fromRay(hit.position),
+                                 Vector3Game::fromRay(hit.normal), hit.distance };
+    luaL_getmetatable(L, kResultMeta);
+    lua_setmetatable(L, -2);
+}
+
+static int rr_index(lua_State* L) {
+    const auto* r = static_cast<const RaycastResultData*>(luaL_checkudata(L, 1, kResultMeta));
+    const char* k = luaL_checkstring(L, 2);
+    if (!strcmp(k, "Instance")) { Lua_PushInstance(L, r->instance); return 1; }
+    if (!strcmp(k, "Position")) { lb::push(L, r->position); return 1; }
+    if (!strcmp(k, "Normal"))   { lb::push(L, r->normal); return 1; }
+    if (!strcmp(k, "Distance")) { lua_pushnumber(L, r->distance); return 1; }
+    luaL_error(L, "%s is not a valid member of RaycastResult", k);
+    return 0;
+}
+
+static int rr_tostring(lua_State* L) {
+    lua_pushliteral(L, "RaycastResult");
+    return 1;
+}
+
+void RegisterQueryTypes(lua_State* L) {
+    luaL_newmetatable(L, kRaycastMeta);
+    lua_pushcfunction(L, rp_index, "index");       lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, rp_newindex, "newindex"); lua_setfield(L, -2, "__newindex");
+    lua_pushcfunction(L, rp_tostring, "tostring"); lua_setfield(L, -2, "__tostring");
+    lua_pushstring(L, "RaycastParams");            lua_setfield(L, -2, "__type");
+    lua_pop(L, 1);
+
+    luaL_newmetatable(L, kOverlapMeta);
+    lua_pushcfunction(L, op_index, "index");       lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, op_newindex, "newindex"); lua_setfield(L, -2, "__newindex");
+    lua_pushcfunction(L, op_tostring, "tostring"); lua_setfield(L, -2, "__tostring");
+    lua_pushstring(L, "OverlapParams");            lua_setfield(L, -2, "__type");
+    lua_pop(L, 1);
+
+    luaL_newmetatable(L, kResultMeta);
+    lua_pushcfunction(L, rr_index, "index");       lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, rr_tostring, "tostring"); lua_setfield(L, -2, "__tostring");
+    lua_pushstring(L, "RaycastResult");            lua_setfield(L, -2, "__type");
+    lua_pop(L, 1);
+
+    lua_newtable(L);
+    lua_pushcfunction(L, rp_new, "new");
+    lua_setfield(L, -2, "new");
+    lua_setglobal(L, "RaycastParams");
+
+    lua_newtable(L);
+    lua_pushcfunction(L, op_new, "new");
+    lua_setfield(L, -2, "new");
+    lua_setglobal(L, "OverlapParams");
+}
+
+// -------- workspace methods --------
+static std::shared_ptr<Workspace> checkWorkspace(lua_State* L) {
+    auto ws = std::dynamic_pointer_cast<Workspace>(checkInstanceArg(L, 1));
+    if (!ws) luaL_error(L, "expected Workspace");
+    return ws;
+}
+
+int Lua_WorkspaceRaycast(lua_State* L) {
+    auto ws = checkWorkspace(L);
+    const Vector3Game* origin = lb::check<Vector3Game>(L, 2);
+    const Vector3Game* direction = lb::check<Vector3Game>(L, 3);
+    QueryFilter filter;
+    const RaycastParams* params = Lua_OptRaycastParams(L, 4);
+    if (params) params->ToFilter(filter);
+
+    PhysicsWorld::RayHit hit;
+    if (!PhysicsWorld::Get().Raycast(ws, origin->toRay(), direction->toRay(), params ? &filter : nullptr, hit)) {
+        lua_pushnil(L);
+        return 1;
+    }
+    Lua_PushRaycastResult(L, hit);
+    return 1;
+}
+
+int Lua_WorkspaceRaycastMany(lua_State* L) {
+    auto ws = checkWorkspace(L);
+    size_t originBytes = 0, directionBytes = 0;
+    const void* originData = luaL_checkbuffer(L, 2, &originBytes);
+    const void* directionData = luaL_checkbuffer(L, 3, &directionBytes);
+    if (originBytes != directionBytes || originBytes % kRayInStride != 0)
+        luaL_error(L, "RaycastMany expects two buffers of packed f32 x, y, z of equal length");
+    QueryFilter filter;
+    const RaycastParams* params = Lua_OptRaycastParams(L, 4);
+    if (params) params->ToFilter(filter);
+
+    const size_t count = originBytes / kRayInStride;
+    static std::vector<::Vector3> origins, directions;
+    static std::vector<PhysicsWorld::RayHit> hits;
+    origins.resize(count);
+    directions.resize(count);
+    hits.resize(count);
+    if (count) {
+        std::memcpy(origins.data(), originData, originBytes);
+        std::memcpy(directions.data(), directionData, directionBytes);
+    }
+    PhysicsWorld::Get().RaycastMany(ws, origins.data(), directions.data(), count, params ? &filter : nullptr, hits.data());
+
+    auto* out = static_cast<unsigned char*>(lua_newbuffer(L, count * kRayOutStride));
+    lua_newtable(L);
+    std::unordered_map<const BasePart*, uint32_t> index;
+    for (size_t i = 0; i < count; ++i) {
+        const PhysicsWorld::RayHit& h = hits[i];
+        float rec[7] = { -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        uint32_t part = 0;
+        if (h.part) {
+            rec[0] = h.distance;
+            rec[1] = h.position.x; rec[2] = h.position.y; rec[3] = h.position.z;
+            rec[4] = h.normal.x;   rec[5] = h.normal.y;   rec[6] = h.normal.z;
+            auto [it, added] = index.try_emplace(h.part, (uint32_t)index.size() + 1);
+            if (added) {
+                Lua_PushInstance(L, h.part->shared_from_this());
+                lua_rawseti(L, -2, (int)it->second);
+            }
+            part = it->second;
+        }
+        std::memcpy(out + i * kRayOutStride, rec, sizeof rec);
+        std::memcpy(out + i * kRayOutStride + sizeof rec, &part, sizeof part);
+    }
+    return 2;
+}
+
+// Parts found by the last overlap query; reused so a query allocates nothing
+// on the C++ side once it has grown to the largest result.
+static std::vector<BasePart*> s_overlap;
+
+static int pushOverlap(lua_State* L) {
+    lua_createtable(L, (int)s_overlap.size(), 0);
+    int n = 0;
+    for (BasePart* p : s_overlap) {
+        Lua_PushInstance(L, p->shared_from_this());
+        lua_rawseti(L, -2, ++n);
+    }
+    return 1;
+}
+
+// Filter from the OverlapParams at idx; false when there are none.
+static bool overlapFilter(lua_State* L, int idx, QueryFilter& filter, size_t& maxParts) {
+    maxParts = 0;
+    const OverlapParams* params = Lua_OptOverlapParams(L, idx);
+    if (!params) return false;
+    params->ToFilter(filter);
+    maxParts = (size_t)params->maxParts;
+    return true;
+}
+
+int Lua_WorkspaceGetPartBoundsInBox(lua_State* L) {
+    auto ws = checkWorkspace(L);
+    const CFrame* cframe = lb::check<CFrame>(L, 2);
+    const Vector3Game* size = lb::check<Vector3Game>(L, 3);
+    QueryFilter filter;
+    size_t maxParts;
+    const bool filtered = overlapFilter(L, 4, filter, maxParts);
+    PhysicsWorld::Get().GetPartsInBox(ws, *cframe, size->toRay(), filtered ? &filter : nullptr, maxParts, s_overlap);
+    return pushOverlap(L);
+}
+
+int Lua_WorkspaceGetPartBoundsInRadius(lua_State* L) {
+    auto ws = checkWorkspace(L);
+    const Vector3Game* center = lb::check<Vector3Game>(L, 2);
+    const float radius = (float)luaL_checknumber(L, 3);
+    QueryFilter filter;
+    size_t maxParts;
+    const bool filtered = overlapFilter(L, 4, filter, maxParts);
+    PhysicsWorld::Get().GetPartsInRadius(ws, center->toRay(), radius, filtered ? &filter : nullptr, maxParts, s_overlap);
+    return pushOverlap(L);
+}
+
+int Lua_WorkspaceGetPartsInPart(lua_State* L) {
+    auto ws = checkWorkspace(L);
+    auto part = std::dynamic_pointer_cast<BasePart>(checkInstanceArg(L, 2));
+    if (!part) luaL_error(L, "GetPartsInPart expects a BasePart");
+    QueryFilter filter;
+    size_t maxParts;
+    const bool filtered = overlapFilter(L, 3, filter, maxParts);
+    PhysicsWorld::Get().GetPartsInPart(ws, *part, filtered ? &filter : nullptr, maxParts, s_overlap);
+    return pushOverlap(L);
+}
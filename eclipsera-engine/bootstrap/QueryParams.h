@@ -0,0 +1,46 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "subsystems/physics/PhysicsWorld.h"
+
+struct lua_State;
+struct Instance;
+
+// Filter fields shared by RaycastParams and OverlapParams. Both live in Luau
+// userdata with a destructor, so the filter list is released with the object.
+struct FilterParams {
+    std::vector<std::weak_ptr<Instance>> filter;  // FilterDescendantsInstances
+    bool include{false};                          // FilterType == Include
+    bool respectCanCollide{false};
+
+    void ToFilter(QueryFilter& out) const;
+};
+
+// Which parts workspace:Raycast may hit.
+struct RaycastParams : FilterParams {
+    bool ignoreWater{false};  // accepted for compatibility; there is no terrain water
+};
+
+// Which parts the GetPartBoundsIn* / GetPartsInPart queries may return.
+struct OverlapParams : FilterParams {
+    int maxParts{0};  // 0: no limit
+};
+
+// RaycastParams / OverlapParams globals, their metatables and RaycastResult's.
+void RegisterQueryTypes(lua_State* L);
+
+// Params at idx, or nullptr for nil / none.
+RaycastParams* Lua_OptRaycastParams(lua_State* L, int idx);
+OverlapParams* Lua_OptOverlapParams(lua_State* L, int idx);
+void Lua_PushRaycastResult(lua_State* L, const PhysicsWorld::RayHit& hit);
+
+// workspace:Raycast(origin, direction, params?) -> RaycastResult?
+int Lua_WorkspaceRaycast(lua_State* L);
+// workspace:RaycastMany(origins, directions, params?) -> (buffer, {BasePart})
+int Lua_WorkspaceRaycastMany(lua_State* L);
+// workspace:GetPartBoundsInBox(cframe, size, params?) -> {BasePart}
+int Lua_WorkspaceGetPartBoundsInBox(lua_State* L);
+// workspace:GetPartBoundsInRadius(position, radius, params?) -> {BasePart}
+int Lua_WorkspaceGetPartBoundsInRadius(lua_State* L);
+// workspace:GetPartsInPart(part, params?) -> {BasePart}
+int Lua_WorkspaceGetPartsInPart(lua_State* L);
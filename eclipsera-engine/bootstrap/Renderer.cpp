@@ -1,13 +1,10 @@
 // Renderer.cpp
-#include "shaders/shaders.h"
-#include "shaders/sky.h"
-
-#include "Renderer.h"
 #include "Renderer.h"
 #include <raylib.h>
 #include <raymath.h>
 #include <rlgl.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <memory>
 #include <cfloat>
@@ -17,18 +14,27 @@
 #include "bootstrap/instances/InstanceTypes.h"
 #include "bootstrap/instances/BasePart.h"      // for CF
 #include "core/datatypes/CFrame.h"             // for CF
+#include "bootstrap/rendering/RenderScene.h"
+#include "bootstrap/rendering/Frustum.h"
+#include "bootstrap/rendering/DepthSort.h"
+#include "bootstrap/rendering/RenderCommands.h"
+#include "bootstrap/rendering/RlglBackend.h"
+#include "bootstrap/ChangeJournal.h"
+#include "bootstrap/services/Lighting.h"
+#include "core/logging/Logging.h"
+#include "core/runtime/TaskScheduler.h"
+#include "subsystems/physics/PhysicsWorld.h"
 
 extern std::shared_ptr<Game> g_game;
 
 // ---------------- Tunables ----------------
 static float kMaxDrawDistance = 10000.0f;
-static float kFovPaddingDeg   = 20.0f;
 
 // shadow parameter definitions
 static float kShadowMaxDistance = 200.0f;  // how far from the camera to cover with shadows
+static float kLightBackoff      = 200.0f;  // light camera distance from the cascade center, toward the sun
 static int   kShadowRes         = 1536;    // per-cascade resolution
 static float kPCFStep           = 1.0f;    // pcf step in texels
-static bool  kCullBackFace      = true;
 static bool  kStabilizeShadow   = true;    // snap to texel grid to prevent swimming
 
 // CSM controls
@@ -37,12 +43,127 @@ static float kCameraNear        = 0.4f;     // must match scene near
 
 // ---- controls (ambient zero, parity by default) ----
 static bool     kUseClockTime = true;               // keep original sun by default
-static float    kClockTime    = 12.0f;              // 0..24 hours when enabled
-static float    kBrightness   = 2.0f;               // original sunStrength default
+static float    kClockTime    = 12.0f;              // 0..24 hours when enabled; Lighting.ClockTime overrides
+static float    kBrightness   = 2.0f;               // original sunStrength default; Lighting.Brightness overrides
 static float    kExposure     = 0.85f;              // new exposure knob, <1 darker, >1 brighter
 static ::Color3 kAmbient      = {0.0f, 0.0f, 0.0f}; // Ambient = 0
 
+static RenderScene gScene;
+
+// What the backend's cached static shadow depth per cascade holds; valid while
+// the key below is unchanged. The light camera follows from the key, so a
+// matching cache also means a matching light VP.
+struct ShadowCache {
+    bool    valid{false};
+    bool    liveIsStatic{false}; // live map currently holds only the static depth
+    uint32_t staticCasters{0};    // instances in the cached depth
+    Vector3 sunDir{};
+    Vector3 target{};             // snapped cascade center
+    float   fovy{0.0f};           // ortho extent
+};
+static ShadowCache gShadowCache[3];
+
+// ---------------- Render list ----------------
+// Visibility and caster sets the prep stage derives before recording commands.
+// Opaque runs and transparents persist across frames while the view and scene
+// are unchanged; cascade lists are rebuilt only for cascades that redraw.
+struct DrawRun { uint32_t first, count; }; // members of the opaque batch
+struct CascadeList {
+    bool reuse{false};          // same view and no static change: keep last frame's maps
+    bool redrawStatic{false};   // re-render the cached static depth from staticCasters and staticChunks
+    std::vector<RenderInstance> staticCasters, dynamicCasters;
+    std::vector<uint32_t> staticChunks; // merged static meshes in the caster volume
+};
+struct RenderList {
+    std::vector<DrawRun> opaqueRuns;
+    std::vector<uint32_t> staticChunks; // visible merged static meshes
+    CascadeList cascades[3];
+};
+static RenderList gList;
+
+// Per-job scratch for the parallel prep; chunk k covers members [k*kPrepGrain, (k+1)*kPrepGrain)
+struct PrepChunk {
+    std::vector<uint32_t> members;
+    std::vector<RenderInstance> statics, dynamics;
+};
+static std::vector<PrepChunk> gPrepChunks;
+static constexpr size_t kPrepGrain = 8192; // multiple of PackedBounds::kCullLanes
+
+static std::vector<DepthItem> gTransparents;    // back to front; seeds the next frame's sort
+static std::vector<uint32_t>  gTransparentMark; // per proxy slot, stamped with gCullEpoch
+static uint32_t               gCullEpoch = 0;
+static uint32_t               gTransparentCount = 0; // gTransparents' instances in kBufTransparent
+static constexpr uint32_t kRunMergeGap = 32; // invisible members drawn to avoid splitting a run
+
+// Backend capacity of every buffer that is re-sent whole (kBufOpaque is
+// tracked by the scene's InstanceBuffer), and the window's backend
+static uint32_t          gStreamCapacity[kBufCount];
+static RlglBackend       gRlglBackend;
+
+struct ViewKey { Camera3D cam; float aspect; Vector3 sun; uint64_t version; };
+static ViewKey gLastView;
+static bool    gViewValid = false;
+static bool SameView(const ViewKey& a, const ViewKey& b) {
+    return a.version == b.version && a.aspect == b.aspect && a.cam.fovy == b.cam.fovy
+        && a.cam.projection == b.cam.projection
+        && Vector3Equals(a.cam.position, b.cam.position) && Vector3Equals(a.cam.target, b.cam.target)
+        && Vector3Equals(a.cam.up, b.cam.up) && Vector3Equals(a.sun, b.sun);
+}
+static RenderStats gStats;  // written by the frame being prepared
+static RenderStats gShown;  // last presented frame; main thread only
+const RenderStats& GetRenderStats() { return gShown; }
+
 static inline float LenSq(Vector3 v){ return v.x*v.x + v.y*v.y + v.z*v.z; }
+static inline double NowSeconds(){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Frustum-test a batch in kPrepGrain chunks on the TaskScheduler. Each job fills its
+// PrepChunk's member list, then calls emit(chunk) for any per-member work. Returns
+// the chunk count; chunks concatenated in order give ascending member indices.
+template <class F>
+static size_t CullBatchParallel(const Frustum& f, const RenderBatch& b, F&& emit) {
+    const size_t n = b.members.size();
+    const size_t chunks = (n + kPrepGrain - 1) / kPrepGrain;
+    if (gPrepChunks.size() < chunks) gPrepChunks.resize(chunks);
+    TaskScheduler::Get().ParallelFor(n, kPrepGrain, [&](size_t first, size_t last){
+        PrepChunk& c = gPrepChunks[first / kPrepGrain];
+        c.members.clear();
+        CullBounds(f, b.bounds, first, last, c.members);
+        emit(c);
+    });
+    return chunks;
+}
+
+// Rebuild gTransparents from this cull's visible transparent slots. Survivors keep
+// last frame's order and new arrivals go on the end, so under a moving camera the
+// list is nearly sorted already.
+static DepthSortKind SortTransparents(const std::vector<uint32_t>& visibleSlots,
+                                      const std::vector<RenderProxy>& proxies, Vector3 camPos) {
+    static std::vector<DepthItem> scratch;
+    gCullEpoch += 2;
+    if (gCullEpoch == 0) { std::fill(gTransparentMark.begin(), gTransparentMark.end(), 0u); gCullEpoch = 2; }
+    if (gTransparentMark.size() < proxies.size()) gTransparentMark.resize(proxies.size(), 0u);
+    const uint32_t seen = gCullEpoch, listed = gCullEpoch + 1;
+    for (uint32_t slot : visibleSlots) gTransparentMark[slot] = seen;
+
+    const float maxD2 = kMaxDrawDistance * kMaxDrawDistance;
+    auto keyOf = [&](uint32_t slot){ return QuantizeDepth(LenSq(Vector3Subtract(proxies[slot].center, camPos)), maxD2); };
+    size_t n = 0;
+    for (const DepthItem& it : gTransparents) {
+        // slots may have been reused since last frame; the stamp filters both stale and duplicate entries
+        if (it.slot >= proxies.size() || gTransparentMark[it.slot] != seen) continue;
+        gTransparentMark[it.slot] = listed;
+        gTransparents[n++] = { it.slot, keyOf(it.slot) };
+    }
+    gTransparents.resize(n);
+    for (uint32_t slot : visibleSlots) {
+        if (gTransparentMark[slot] != seen) continue;
+        gTransparentMark[slot] = listed;
+        gTransparents.push_back({ slot, keyOf(slot) });
+    }
+    return SortBackToFront(gTransparents, scratch);
+}
 struct SavedWin { int x,y,w,h; bool valid=false; } g_saved;
 
 inline ::Color ToRaylibColor(const ::Color3& c, float alpha = 1.0f) {
@@ -85,119 +206,6 @@ static Vector3 SunDirFromClock(float clockHours){
     return { ca*cphi, -sa, ca*sphi };                  // from sun to scene
 }
 
-// ---------------- Shader objects / models / shadow RT ----------------
-static Shader gLitShader   = {0};
-static Shader gLitShaderInst = {0};
-static Shader gSkyShader   = {0};
-static Model  gPartModel   = {0}; // cube model used for parts
-static Model  gSkyModel    = {0};
-static Material gPartMatInst = {0};
-static RenderTexture2D gShadowMapCSM[3] = { {0},{0},{0} };
-
-// Sky uniforms
-static int u_inner=-1, u_outer=-1, u_transition=-1;
-
-// Lit shader uniform locations
-static int u_sunDir=-1, u_sky=-1, u_ground=-1, u_hemi=-1, u_sun=-1;
-static int u_spec=-1, u_shiny=-1, u_fresnel=-1, u_viewPos=-1;
-static int u_aoStrength=-1, u_groundY=-1, u_ambient=-1;
-
-// CSM uniforms
-static int u_lightVP0=-1, u_lightVP1=-1, u_lightVP2=-1;
-static int u_shadowMap0=-1, u_shadowMap1=-1, u_shadowMap2=-1;
-static int u_shadowRes=-1, u_pcfStep=-1, u_biasMin=-1, u_biasMax=-1;
-static int u_splits=-1;
-static int u_exposure = -1;
-static int u_normalBias0=-1, u_normalBias1=-1, u_normalBias2=-1;
-
-// Instanced shader uniform locations (mirror)
-static int ui_sunDir=-1, ui_sky=-1, ui_ground=-1, ui_hemi=-1, ui_sun=-1;
-static int ui_spec=-1, ui_shiny=-1, ui_fresnel=-1, ui_viewPos=-1;
-static int ui_aoStrength=-1, ui_groundY=-1, ui_ambient=-1;
-static int ui_lightVP0=-1, ui_lightVP1=-1, ui_lightVP2=-1;
-static int ui_shadowMap0=-1, ui_shadowMap1=-1, ui_shadowMap2=-1;
-static int ui_shadowRes=-1, ui_pcfStep=-1, ui_biasMin=-1, ui_biasMax=-1;
-static int ui_splits=-1;
-static int ui_exposure=-1;
-static int ui_normalBias0=-1, ui_normalBias1=-1, ui_normalBias2=-1;
-static int ui_transition = -1;
-
-// ---------------- Shadowmap helpers ----------------
-static RenderTexture2D LoadShadowmapRenderTexture(int width, int height){
-    RenderTexture2D target = {0};
-    target.id = rlLoadFramebuffer(); // empty FBO
-    target.texture.width = width;
-    target.texture.height = height;
-
-    if (target.id > 0){
-        rlEnableFramebuffer(target.id);
-
-        // Depth texture only
-        target.depth.id = rlLoadTextureDepth(width, height, false);
-        target.depth.width = width;
-        target.depth.height = height;
-        target.depth.format = 19; // DEPTH24
-        target.depth.mipmaps = 1;
-
-        rlFramebufferAttach(target.id, target.depth.id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
-        rlFramebufferComplete(target.id);
-        rlDisableFramebuffer();
-    }
-    return target;
-}
-
-static void UnloadShadowmapRenderTexture(RenderTexture2D target){
-    if (target.id > 0) rlUnloadFramebuffer(target.id);
-}
-
-// --------- CFrame -> axis-angle (for DrawModelEx) ----------
-static inline float clampf(float x, float a, float b){ return x < a ? a : (x > b ? b : x); }
-
-static void CFrameToAxisAngle(const CFrame& cf, ::Vector3& axisOut, float& angleDegOut){
-    // Row-major 3x3
-    const float m00 = cf.R[0], m01 = cf.R[1], m02 = cf.R[2];
-    const float m10 = cf.R[3], m11 = cf.R[4], m12 = cf.R[5];
-    const float m20 = cf.R[6], m21 = cf.R[7], m22 = cf.R[8];
-
-    const float trace = m00 + m11 + m22;
-    float cosA = (trace - 1.0f)*0.5f;
-    cosA = clampf(cosA, -1.0f, 1.0f);
-    float angle = acosf(cosA);
-
-    if (angle < 1e-6f){
-        axisOut = {0.0f, 1.0f, 0.0f};
-        angleDegOut = 0.0f;
-        return;
-    }
-
-    if (fabsf(PI - angle) < 1e-4f){
-        // Near 180°, robust axis extraction
-        float xx = sqrtf(fmaxf(0.0f, (m00 + 1.0f)*0.5f));
-        float yy = sqrtf(fmaxf(0.0f, (m11 + 1.0f)*0.5f));
-        float zz = sqrtf(fmaxf(0.0f, (m22 + 1.0f)*0.5f));
-        // pick signs from off-diagonals
-        xx = copysignf(xx, m21 - m12);
-        yy = copysignf(yy, m02 - m20);
-        zz = copysignf(zz, m10 - m01);
-        float len = sqrtf(xx*xx + yy*yy + zz*zz);
-        if (len < 1e-6f) { axisOut = {0.0f,1.0f,0.0f}; angleDegOut = 180.0f; return; }
-        axisOut = { xx/len, yy/len, zz/len };
-        angleDegOut = 180.0f;
-        return;
-    }
-
-    float s = 2.0f*sinf(angle);
-    ::Vector3 axis = {
-        (m21 - m12) / s,
-        (m02 - m20) / s,
-        (m10 - m01) / s
-    };
-    float len = sqrtf(axis.x*axis.x + axis.y*axis.y + axis.z*axis.z);
-    if (len < 1e-6f) { axisOut = {0.0f,1.0f,0.0f}; angleDegOut = 0.0f; return; }
-    axisOut = { axis.x/len, axis.y/len, axis.z/len };
-    angleDegOut = angle * (180.0f/PI);
-}
-
 // ---------------- Dynamic shadow helpers ----------------
 
 // Return a safe 'up' vector for the given direction
@@ -208,9 +216,8 @@ static inline Vector3 SafeUpForDir(Vector3 d){
 }
 
 // Compute world-space frustum corners for camera slice [nearD, farD]
-static void GetFrustumCornersWS(const Camera3D& cam, float nearD, float farD, Vector3 outCorners[8]){
+static void GetFrustumCornersWS(const Camera3D& cam, float aspect, float nearD, float farD, Vector3 outCorners[8]){
     const float vFov = cam.fovy * (PI/180.0f);
-    const float aspect = (float)GetScreenWidth()/(float)GetScreenHeight();
 
     Vector3 F = Vector3Normalize(Vector3Subtract(cam.target, cam.position));
     Vector3 R = Vector3Normalize(Vector3CrossProduct(F, cam.up));
@@ -244,15 +251,15 @@ static inline Vector3 XformPoint(const Matrix& m, Vector3 p){
 
 // Build a directional light camera tightly fitting the camera frustum slice
 // NOTE: outTexelWS returns the world-space size of one shadow map texel for this cascade.
-static void BuildLightCameraForSlice(const Camera3D& cam, Vector3 sunDir,
+static void BuildLightCameraForSlice(const Camera3D& cam, float aspect, Vector3 sunDir,
                                      float sliceNear, float sliceFar,
                                      int shadowRes,
                                      int rtW, int rtH,
                                      Camera3D& outCam, Matrix& outLightVP,
-                                     float& outTexelWS)
+                                     float& outTexelWS, Frustum& outCasterVolume)
 {
     Vector3 cornersWS[8];
-    GetFrustumCornersWS(cam, sliceNear, sliceFar, cornersWS);
+    GetFrustumCornersWS(cam, aspect, sliceNear, sliceFar, cornersWS);
 
     // compute centroid
     Vector3 center = {0,0,0};
@@ -261,7 +268,7 @@ static void BuildLightCameraForSlice(const Camera3D& cam, Vector3 sunDir,
 
     Vector3 upL = SafeUpForDir(Vector3Scale(sunDir, -1.0f));
     // initial view from sun direction
-    Matrix lightView = MatrixLookAt(Vector3Add(center, Vector3Scale(Vector3Scale(sunDir, -1.0f), 200.0f)), center, upL);
+    Matrix lightView = MatrixLookAt(Vector3Add(center, Vector3Scale(Vector3Scale(sunDir, -1.0f), kLightBackoff)), center, upL);
 
     // compute bounds in light space
     Vector3 mn = { FLT_MAX, FLT_MAX, FLT_MAX };
@@ -297,13 +304,12 @@ static void BuildLightCameraForSlice(const Camera3D& cam, Vector3 sunDir,
     Vector3 snappedCenterWS = XformPoint(invView, centerLS);
 
     // final view
-    lightView = MatrixLookAt(Vector3Add(snappedCenterWS, Vector3Scale(Vector3Scale(sunDir, -1.0f), 200.0f)), snappedCenterWS, upL);
-
-    // depth range padded - tightened from 50 to 10
-    const float zNear = -mx.z - 10.0f;
-    const float zFar  = -mn.z + 10.0f;
+    lightView = MatrixLookAt(Vector3Add(snappedCenterWS, Vector3Scale(Vector3Scale(sunDir, -1.0f), kLightBackoff)), snappedCenterWS, upL);
 
-    Matrix lightProj = MatrixOrtho(-orthoHalfX, +orthoHalfX, -orthoHalfY, +orthoHalfY, zNear, zFar);
+    // the projection BeginMode3D builds for outCam below: fovy is the ortho height,
+    // the render target's aspect gives the width, depth spans rlgl's cull distances
+    Matrix lightProj = MatrixOrtho(-orthoHalfX, +orthoHalfX, -orthoHalfY, +orthoHalfY,
+                                   RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
 
     outLightVP = MatrixMultiply(lightView, lightProj);
 
@@ -312,155 +318,33 @@ static void BuildLightCameraForSlice(const Camera3D& cam, Vector3 sunDir,
     outCam.projection = CAMERA_ORTHOGRAPHIC;
     outCam.up = upL;
     outCam.target = snappedCenterWS;
-    outCam.position = Vector3Add(snappedCenterWS, Vector3Scale(Vector3Scale(sunDir, -1.0f), 200.0f));
+    outCam.position = Vector3Add(snappedCenterWS, Vector3Scale(Vector3Scale(sunDir, -1.0f), kLightBackoff));
     // raylib's ortho via fovy behaves differently: set fovy to full half-height to match our ortho extents
     outCam.fovy = orthoHalfY * 2.0f;
 
     outTexelWS = texelWS;
-}
-
-// ---------------- Init ----------------
-static void EnsureShaders() {
-    if (!gLitShader.id) {
-        gLitShader = LoadShaderFromMemory(LIT_VS, LIT_FS);
-
-        // lighting
-        u_viewPos   = GetShaderLocation(gLitShader, "viewPos");
-        u_sunDir    = GetShaderLocation(gLitShader, "sunDir");
-        u_sky       = GetShaderLocation(gLitShader, "skyColor");
-        u_ground    = GetShaderLocation(gLitShader, "groundColor");
-        u_hemi      = GetShaderLocation(gLitShader, "hemiStrength");
-        u_sun       = GetShaderLocation(gLitShader, "sunStrength");
-        u_ambient   = GetShaderLocation(gLitShader, "ambientColor");
-        u_spec      = GetShaderLocation(gLitShader, "specStrength");
-        u_shiny     = GetShaderLocation(gLitShader, "shininess");
-        u_fresnel   = GetShaderLocation(gLitShader, "fresnelStrength");
-        u_aoStrength= GetShaderLocation(gLitShader, "aoStrength");
-        u_groundY   = GetShaderLocation(gLitShader, "groundY");
-
-        // cascades
-        u_lightVP0  = GetShaderLocation(gLitShader, "lightVP0");
-        u_lightVP1  = GetShaderLocation(gLitShader, "lightVP1");
-        u_lightVP2  = GetShaderLocation(gLitShader, "lightVP2");
-        u_shadowMap0= GetShaderLocation(gLitShader, "shadowMap0");
-        u_shadowMap1= GetShaderLocation(gLitShader, "shadowMap1");
-        u_shadowMap2= GetShaderLocation(gLitShader, "shadowMap2");
-        u_shadowRes = GetShaderLocation(gLitShader, "shadowMapResolution");
-        u_pcfStep   = GetShaderLocation(gLitShader, "pcfStep");
-        u_biasMin   = GetShaderLocation(gLitShader, "biasMin");
-        u_biasMax   = GetShaderLocation(gLitShader, "biasMax");
-        u_splits    = GetShaderLocation(gLitShader, "cascadeSplits");
-        u_transition = GetShaderLocation(gLitShader, "transitionFrac");
-
-        // normal bias
-        u_normalBias0 = GetShaderLocation(gLitShader, "normalBiasWS0");
-        u_normalBias1 = GetShaderLocation(gLitShader, "normalBiasWS1");
-        u_normalBias2 = GetShaderLocation(gLitShader, "normalBiasWS2");
-
-        // exposure
-        u_exposure  = GetShaderLocation(gLitShader, "exposure");
-
-        // constants
-        SetShaderValue(gLitShader, u_shadowRes, &kShadowRes, SHADER_UNIFORM_INT);
-        float pcfStep = kPCFStep;
-        // reduced bias defaults
-        float biasMin = 6e-5f, biasMax = 8e-4f;
-        SetShaderValue(gLitShader, u_pcfStep, &pcfStep, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(gLitShader, u_biasMin, &biasMin, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(gLitShader, u_biasMax, &biasMax, SHADER_UNIFORM_FLOAT);
-
-        // set a default exposure in case it's not updated per-frame
-        SetShaderValue(gLitShader, u_exposure, &kExposure, SHADER_UNIFORM_FLOAT);
-
-        float defaultTransition = 0.15f; // 15% of split distance -> smooth blend
-        SetShaderValue(gLitShader, u_transition, &defaultTransition, SHADER_UNIFORM_FLOAT);
-    }
-
-    if (!gLitShaderInst.id) {
-        gLitShaderInst = LoadShaderFromMemory(LIT_VS_INST, LIT_FS);
-
-        // in order for DrawMeshInstanced to pick up instanceTransform as the model matrix attribute,
-        // assign its attribute location to SHADER_LOC_MATRIX_MODEL
-        gLitShaderInst.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(gLitShaderInst, "instanceTransform");
-
-        // lighting (instanced)
-        ui_viewPos   = GetShaderLocation(gLitShaderInst, "viewPos");
-        ui_sunDir    = GetShaderLocation(gLitShaderInst, "sunDir");
-        ui_sky       = GetShaderLocation(gLitShaderInst, "skyColor");
-        ui_ground    = GetShaderLocation(gLitShaderInst, "groundColor");
-        ui_hemi      = GetShaderLocation(gLitShaderInst, "hemiStrength");
-        ui_sun       = GetShaderLocation(gLitShaderInst, "sunStrength");
-        ui_ambient   = GetShaderLocation(gLitShaderInst, "ambientColor");
-        ui_spec      = GetShaderLocation(gLitShaderInst, "specStrength");
-        ui_shiny     = GetShaderLocation(gLitShaderInst, "shininess");
-        ui_fresnel   = GetShaderLocation(gLitShaderInst, "fresnelStrength");
-        ui_aoStrength= GetShaderLocation(gLitShaderInst, "aoStrength");
-        ui_groundY   = GetShaderLocation(gLitShaderInst, "groundY");
-
-        // cascades (instanced)
-        ui_lightVP0  = GetShaderLocation(gLitShaderInst, "lightVP0");
-        ui_lightVP1  = GetShaderLocation(gLitShaderInst, "lightVP1");
-        ui_lightVP2  = GetShaderLocation(gLitShaderInst, "lightVP2");
-        ui_shadowMap0= GetShaderLocation(gLitShaderInst, "shadowMap0");
-        ui_shadowMap1= GetShaderLocation(gLitShaderInst, "shadowMap1");
-        ui_shadowMap2= GetShaderLocation(gLitShaderInst, "shadowMap2");
-        ui_shadowRes = GetShaderLocation(gLitShaderInst, "shadowMapResolution");
-        ui_pcfStep   = GetShaderLocation(gLitShaderInst, "pcfStep");
-        ui_biasMin   = GetShaderLocation(gLitShaderInst, "biasMin");
-        ui_biasMax   = GetShaderLocation(gLitShaderInst, "biasMax");
-        ui_splits    = GetShaderLocation(gLitShaderInst, "cascadeSplits");
-        ui_transition= GetShaderLocation(gLitShaderInst, "transitionFrac");
-
-        // normal bias (instanced)
-        ui_normalBias0 = GetShaderLocation(gLitShaderInst, "normalBiasWS0");
-        ui_normalBias1 = GetShaderLocation(gLitShaderInst, "normalBiasWS1");
-        ui_normalBias2 = GetShaderLocation(gLitShaderInst, "normalBiasWS2");
-
-        // exposure
-        ui_exposure  = GetShaderLocation(gLitShaderInst, "exposure");
-
-        // constants
-        SetShaderValue(gLitShaderInst, ui_shadowRes, &kShadowRes, SHADER_UNIFORM_INT);
-        float pcfStep2 = kPCFStep, biasMin2 = 6e-5f, biasMax2 = 8e-4f;
-        SetShaderValue(gLitShaderInst, ui_pcfStep, &pcfStep2, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(gLitShaderInst, ui_biasMin, &biasMin2, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(gLitShaderInst, ui_biasMax, &biasMax2, SHADER_UNIFORM_FLOAT);
-        float defaultTransition2 = 0.15f;
-        SetShaderValue(gLitShaderInst, ui_transition, &defaultTransition2, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(gLitShaderInst, ui_exposure, &kExposure, SHADER_UNIFORM_FLOAT);
-    }
-
-    if (!gSkyShader.id) {
-        gSkyShader = LoadShaderFromMemory(SKY_VS, SKY_FS);
-        u_inner = GetShaderLocation(gSkyShader, "innerColor");
-        u_outer = GetShaderLocation(gSkyShader, "outerColor");
-    }
-
-    // Shared cube model for all parts
-    if (gPartModel.meshCount == 0) {
-        Mesh cubeMesh = GenMeshCube(1.0f, 1.0f, 1.0f);
-        gPartModel = LoadModelFromMesh(cubeMesh);
-        gPartModel.materials[0].shader = gLitShader; // bind lit+shadow shader for non-instanced path
-    }
 
-    // Sky cube
-    if (gSkyModel.meshCount == 0) {
-        Mesh cubeMesh = GenMeshCube(1.0f, 1.0f, 1.0f);
-        gSkyModel = LoadModelFromMesh(cubeMesh);
-        gSkyModel.materials[0].shader = gSkyShader;
-    }
-
-    // instanced material
-    if (!gPartMatInst.shader.id) {
-        gPartMatInst = LoadMaterialDefault();
-        gPartMatInst.shader = gLitShaderInst;
-    }
-
-    for (int i=0;i<3;i++){
-        if (!gShadowMapCSM[i].id) {
-            gShadowMapCSM[i] = LoadShadowmapRenderTexture(kShadowRes, kShadowRes);
-        }
-    }
+    // Caster volume: the ortho box, open toward the light up to the light camera
+    // (rasterization clips beyond that anyway) and closed just past the slice's
+    // farthest receiver, since nothing behind the receivers can shadow them.
+    const Vector3 f = Vector3Normalize(sunDir);
+    Vector3 vx = Vector3Normalize(Vector3CrossProduct(f, upL));
+    Vector3 vy = Vector3CrossProduct(vx, f);
+    float tMax = -FLT_MAX;
+    for (int i=0;i<8;i++) tMax = fmaxf(tMax, Vector3DotProduct(Vector3Subtract(cornersWS[i], snappedCenterWS), f));
+
+    auto plane = [&](int i, Vector3 n, float d){
+        outCasterVolume.nx[i] = n.x; outCasterVolume.ny[i] = n.y; outCasterVolume.nz[i] = n.z; outCasterVolume.d[i] = d;
+    };
+    const float cx = Vector3DotProduct(vx, snappedCenterWS);
+    const float cy = Vector3DotProduct(vy, snappedCenterWS);
+    const float cf = Vector3DotProduct(f, snappedCenterWS);
+    plane(0, vx,               orthoHalfX - cx);
+    plane(1, Vector3Negate(vx), orthoHalfX + cx);
+    plane(2, vy,               orthoHalfY - cy);
+    plane(3, Vector3Negate(vy), orthoHalfY + cy);
+    plane(4, f,                kLightBackoff - cf);
+    plane(5, Vector3Negate(f),  tMax + 10.0f + cf);
 }
 
 // ---------------- Utility: compute cascade splits ----------------
@@ -475,99 +359,167 @@ static inline void ComputeCascadeSplits(float n, float f, float lambda, float ou
     }
 }
 
-// ---------------- Helper: Build instance matrix ----------------
-static inline Matrix BuildInstanceMatrix(const CFrame& cf, ::Vector3 size){
-    // CFrame::R is row-major 3x3 as used above
-    const float m00 = cf.R[0], m01 = cf.R[1], m02 = cf.R[2];
-    const float m10 = cf.R[3], m11 = cf.R[4], m12 = cf.R[5];
-    const float m20 = cf.R[6], m21 = cf.R[7], m22 = cf.R[8];
-    ::Vector3 t = cf.p.toRay();
-
-    Matrix M = {0};
-    // column 0 = Sx * R[:,0]
-    M.m0 = m00*size.x; M.m1 = m10*size.x; M.m2 = m20*size.x; M.m3 = 0.0f;
-    // column 1 = Sy * R[:,1]
-    M.m4 = m01*size.y; M.m5 = m11*size.y; M.m6 = m21*size.y; M.m7 = 0.0f;
-    // column 2 = Sz * R[:,2]
-    M.m8 = m02*size.z; M.m9 = m12*size.z; M.m10= m22*size.z; M.m11= 0.0f;
-    // column 3 = translation
-    M.m12 = t.x; M.m13 = t.y; M.m14 = t.z; M.m15 = 1.0f;
-    return M;
-}
-
-// ---------------- Main render ----------------
-void RenderFrame(Camera3D& camera) {
-    if (IsKeyPressed(KEY_F11)) {
-        static bool borderless=false; borderless=!borderless;
-        if (borderless) EnterBorderlessFullscreen(); else ExitBorderlessFullscreen();
+// ---------------- Frame snapshot ----------------
+// What render prep reads from the simulation, captured on the main thread.
+// Part state is copied into the retained scene by its Sync; the rest is
+// copied here, so prep can run while scripts change the live values.
+struct FrameSnapshot {
+    Camera3D camera{};
+    float    aspect{1.0f};
+    float    clockTime{12.0f};
+    float    brightness{2.0f};
+    double   capturedAt{0.0};
+};
+
+static void CaptureFrame(const Camera3D& camera, float aspect, FrameSnapshot& snap) {
+    const double t0 = NowSeconds();
+    snap.camera     = camera;
+    snap.aspect     = aspect;
+    snap.clockTime  = kClockTime;
+    snap.brightness = kBrightness;
+    if (auto ls = std::dynamic_pointer_cast<Lighting>(Service::Get("Lighting"))) {
+        snap.clockTime  = (float)ls->ClockTime;
+        snap.brightness = (float)ls->Brightness;
     }
 
-    EnsureShaders();
+    // Gather parts into the retained scene (proxies are refreshed only for parts that changed)
+    auto ws = g_game ? g_game->workspace : nullptr;
+    gStats.journalRecords = (uint32_t)ChangeJournal::Get().PendingRecords();
+    gScene.Sync(ws);
+    gStats.parts        = (uint32_t)gScene.Proxies().size();
+    gStats.partsUpdated = gScene.UpdatedLastSync();
+
+    // physics steps at a fixed rate; moving bodies are drawn between its last two steps
+    static std::vector<InterpolatedPose> poses;
+    PhysicsWorld& physics = PhysicsWorld::Get();
+    physics.InterpolatedPoses(physics.Clock().Alpha(), poses);
+    gScene.OverrideTransforms(poses.data(), poses.size());
+    gStats.interpolated = (uint32_t)poses.size();
+
+    snap.capturedAt = NowSeconds();
+    gStats.syncMs = (float)((snap.capturedAt - t0) * 1000.0);
+}
+
+// ---------------- Render prep ----------------
+// CPU only and reads nothing but the snapshot and the retained scene: cull,
+// sort, gather casters, and record the frame into 'out' for a backend to replay.
+static void BuildFrame(const FrameSnapshot& snap, RenderCommandList& out) {
+    const Camera3D& camera = snap.camera;
+    const float aspect = snap.aspect;
+    out.Clear();
+    gStats.uploadBytes = 0;
+    gStats.drawCalls = 0;
+    ++gStats.frames;
 
     // Camera + culling
     const Vector3 camPos = camera.position;
-    Vector3 camDir = Vector3Normalize(Vector3Subtract(camera.target, camPos));
-    const float maxDistSq = kMaxDrawDistance * kMaxDrawDistance;
-    const float vFov = camera.fovy * (PI/180.0f);
-    const float aspect = (float)GetScreenWidth()/(float)GetScreenHeight();
-    const float hFov = 2.0f * atanf(tanf(vFov*0.5f)*aspect);
-    const float halfCone = 0.5f * ((hFov>vFov)?hFov:vFov) + kFovPaddingDeg*(PI/180.0f);
-    const float cosHalf2 = cosf(halfCone)*cosf(halfCone); // kept for reference
 
     // Lighting params
     Vector3 sunDirV = kUseClockTime
-        ? SunDirFromClock(kClockTime)
+        ? SunDirFromClock(snap.clockTime)
         : Vector3Normalize(Vector3{1.0f, -1.0f, 1.0f}); // original parity
-    float sunDir[3] = { sunDirV.x, sunDirV.y, sunDirV.z };
-    float sky[3]    = { 0.60f, 0.70f, 0.90f };
-    float ground[3] = { 0.18f, 0.16f, 0.14f };
-    float hemiStr   = 0.7f;
-    float sunStr    = (kBrightness / 2.0f) * 0.6f;            // default 0.6 identical to original
-    float ambient[3]= { kAmbient.r, kAmbient.g, kAmbient.b }; // zero => identical output
-    float specStr   = 1.30f;
-    float shininess = 128.0f;
-    float fresnel   = 0.1f;
-    float aoStr     = 0.6f;
-    float groundY   = 0.5f;
-
-    // Gather parts
-    auto ws = g_game ? g_game->workspace : nullptr;
-    struct TItem { std::shared_ptr<Part> p; float dist2; float alpha; };
-    std::vector<std::shared_ptr<Part>> opaques;
-    std::vector<TItem> transparents;
-
-    if (ws) {
-        for (const auto& p : ws->parts) {
-            if (!p || !p->Alive) continue;
-
-            // CF position
-            Vector3 pos = p->CF.p.toRay();
-            Vector3 delta = Vector3Subtract(pos, camPos);
-            float d2 = LenSq(delta);
-            if (d2 > maxDistSq) continue;
-
-            float dist = sqrtf(d2);
-            float cosTheta = Vector3DotProduct(camDir, delta) / (dist > 0 ? dist : 1.0f);
-
-            // size-based bounding sphere radius
-            float radius = 0.5f * Vector3Length(p->Size);
-
-            // allow hit if center is inside cone OR sphere overlaps cone boundary
-            float angleLimit = cosf(halfCone);
-            // if (cosTheta < angleLimit && dist * 0.5f > radius) continue;
-
-            float t = Clamp(p->Transparency, 0.0f, 1.0f);
-            float a = 1.0f - t;
-            if (a <= 0.0f) continue;
-            if (a >= 1.0f) opaques.push_back(p);
-            else transparents.push_back({p, d2, a});
+    FrameUniforms& u = out.uniforms;
+    u.viewPos         = camPos;
+    u.sunDir          = sunDirV;
+    u.skyColor        = { 0.60f, 0.70f, 0.90f };
+    u.groundColor     = { 0.18f, 0.16f, 0.14f };
+    u.hemiStrength    = 0.7f;
+    u.sunStrength     = (snap.brightness / 2.0f) * 0.6f;            // default 0.6 identical to original
+    u.ambientColor    = { kAmbient.r, kAmbient.g, kAmbient.b }; // zero => identical output
+    u.specStrength    = 1.30f;
+    u.shininess       = 128.0f;
+    u.fresnelStrength = 0.1f;
+    u.aoStrength      = 0.6f;
+    u.groundY         = 0.5f;
+    u.exposure        = kExposure;
+    u.transitionFrac  = 0.15f;                     // 0.05..0.25 typical; lower = tighter band
+    u.skyInner        = { 0.25f, 0.45f, 0.65f };  // soft horizon blue
+    u.skyOuter        = { 0.05f, 0.25f, 0.55f };  // deeper zenith blue
+    u.shadowRes       = kShadowRes;
+    u.pcfStep         = kPCFStep;
+    u.biasMin         = 6e-5f;                     // reduced bias defaults
+    u.biasMax         = 8e-4f;
+
+    const double prepT0 = NowSeconds();
+    gStats.uploadBytes += gScene.EmitUploads(out);
+
+    const auto& proxies = gScene.Proxies();
+    const auto& batches = gScene.Batches();
+    const StaticBatcher& statics = gScene.Statics();
+    const PackedBounds& chunkBounds = statics.ChunkBounds();
+
+    // Nothing visible can change unless the camera, the sun or the scene did
+    ViewKey view{ camera, aspect, sunDirV, gScene.Version() };
+    const bool viewSame = gViewValid && SameView(view, gLastView);
+    gLastView = view;
+    gViewValid = true;
+
+    // Frustum test per batch over the packed AABBs; the far plane is the draw distance
+    const double cullT0 = NowSeconds();
+    if (!viewSame) {
+        gList.opaqueRuns.clear();
+        gList.staticChunks.clear();
+        gStats.visible = gStats.culled = 0;
+
+        static std::vector<uint32_t> visible, visibleTransparent;
+        visibleTransparent.clear();
+        const Frustum frustum = Frustum::FromCamera(camera, aspect, kCameraNear, kMaxDrawDistance);
+        for (const RenderBatch& b : batches) {
+            if (b.members.empty()) continue;
+            visible.clear();
+            const size_t chunks = CullBatchParallel(frustum, b, [](PrepChunk&){});
+            for (size_t k = 0; k < chunks; ++k)
+                visible.insert(visible.end(), gPrepChunks[k].members.begin(), gPrepChunks[k].members.end());
+            gStats.visible += (uint32_t)visible.size();
+            gStats.culled  += (uint32_t)(b.members.size() - visible.size());
+
+            if (b.bucket == RenderBucket::Transparent) {
+                for (uint32_t m : visible) visibleTransparent.push_back(b.members[m]);
+                continue;
+            }
+            // contiguous runs of visible members; small gaps are drawn through and left to the clipper
+            for (size_t k = 0; k < visible.size();) {
+                uint32_t first = visible[k], last = first;
+                while (++k < visible.size() && visible[k] - last <= kRunMergeGap) last = visible[k];
+                gList.opaqueRuns.push_back({ first, last - first + 1 });
+            }
+        }
+        CullBounds(frustum, chunkBounds, 0, chunkBounds.Padded(), gList.staticChunks);
+
+        const double sortT0 = NowSeconds();
+        SortTransparents(visibleTransparent, proxies, camPos);
+        gStats.sortMs = (float)((NowSeconds() - sortT0) * 1000.0);
+
+        // back-to-front instances go straight into the upload payload
+        const uint32_t offset = (uint32_t)out.instances.size();
+        for (const DepthItem& it : gTransparents) {
+            const RenderProxy& rp = proxies[it.slot];
+            out.instances.push_back({ rp.xform, ColorFromKey(rp.colorKey, (unsigned char)std::lroundf(rp.alpha * 255.0f)) });
         }
+        gTransparentCount = (uint32_t)gTransparents.size();
+        out.Reserve(kBufTransparent, gTransparentCount, gStreamCapacity[kBufTransparent]);
+        gStats.uploadBytes += out.UploadStaged(kBufTransparent, 0, offset, gTransparentCount);
+    }
+    gStats.cullMs = (float)((NowSeconds() - cullT0) * 1000.0);
+    gStats.transparents = gTransparentCount;
+    {
+        const StaticBatcher::Stats& ss = statics.GetStats();
+        RenderStats::Statics& st = gStats.statics;
+        st.parts          = ss.parts;
+        st.chunks         = ss.chunks;
+        st.chunksDrawn    = (uint32_t)gList.staticChunks.size();
+        st.verticesBefore = ss.parts * 24;
+        st.verticesAfter  = ss.quads * 4;
+        st.hiddenFaces    = ss.hiddenQuads;
+        st.cellsRebuilt   = ss.cellsRebuilt;
+        st.rebuildMs      = ss.rebuildMs;
     }
 
-    // ---------------- Shadow pass (3 cascades) ----------------
+    // Cascade placement (3 cascades)
     Camera3D lightCam[3] = {{0},{0},{0}};
     Matrix lightVP[3] = { MatrixIdentity(), MatrixIdentity(), MatrixIdentity() };
     float cascadeTexelWS[3] = {0.0f, 0.0f, 0.0f};
+    Frustum casterVolume[3];
 
     // compute splits in view-space distance
     float splitRaw[2] = {0.0f, 0.0f};
@@ -580,223 +532,267 @@ void RenderFrame(Camera3D& camera) {
     for (int i=0;i<3;i++){
         float farD = splits[i];
         BuildLightCameraForSlice(
-            camera, sunDirV,
+            camera, aspect, sunDirV,
             nearD, farD,
             kShadowRes,
-            gShadowMapCSM[i].texture.width,
-            gShadowMapCSM[i].texture.height,
+            kShadowRes, kShadowRes,
             lightCam[i], lightVP[i],
-            cascadeTexelWS[i]
+            cascadeTexelWS[i], casterVolume[i]
         );
         nearD = farD;
     }
 
-    // Build instance transforms for shadow casters (include opaques and transparents)
-    std::vector<Matrix> shadowXforms;
-    shadowXforms.reserve(opaques.size() + transparents.size());
-    for (auto& p : opaques) shadowXforms.push_back(BuildInstanceMatrix(p->CF, p->Size));
-    for (auto& it : transparents) shadowXforms.push_back(BuildInstanceMatrix(it.p->CF, it.p->Size));
+    // does a static change since the last frame touch this cascade's caster volume?
+    auto StaticDirtyIn = [&](const Frustum& f){
+        if (gScene.AllStaticDirty()) return true;
+        for (const auto& r : gScene.StaticDirtyRegions()) {
+            bool in = true;
+            for (int p=0;p<6 && in;p++){
+                float dist = f.nx[p]*r.center.x + f.ny[p]*r.center.y + f.nz[p]*r.center.z + f.d[p];
+                float rad  = fabsf(f.nx[p])*r.extents.x + fabsf(f.ny[p])*r.extents.y + fabsf(f.nz[p])*r.extents.z;
+                in = dist + rad >= 0.0f;
+            }
+            if (in) return true;
+        }
+        return false;
+    };
 
+    // Shadow casters per cascade: parts inside that cascade's caster volume with
+    // CastShadow set (transparent parts cast as solid), split into static
+    // (anchored, settled) and dynamic sets. Static casters are only gathered
+    // when the cached static depth is redrawn.
     for (int i=0;i<3;i++){
-        BeginTextureMode(gShadowMapCSM[i]);
-            ClearBackground(WHITE); // depth cleared by BeginMode3D
-            BeginMode3D(lightCam[i]);
-
-                // note: rlGetMatrixModelview/projection gives the matrices raylib used; update our lightVP
-                Matrix lightView = rlGetMatrixModelview();
-                Matrix lightProj = rlGetMatrixProjection();
-                lightVP[i] = MatrixMultiply(lightView, lightProj);
-
-                // disable backface culling for shadow pass to reduce acne
-                rlDisableBackfaceCulling();
-
-                // Cast shadows from both opaque and transparent geometry (as solid)
-                if (!shadowXforms.empty()) {
-                    // color doesn't matter; depth-only framebuffer will use depth
-                    // ensure instanced material shader is active for drawing instanced meshes
-                    gPartMatInst.shader = gLitShaderInst;
-                    gPartMatInst.maps[MATERIAL_MAP_DIFFUSE].color = WHITE;
-                    DrawMeshInstanced(gPartModel.meshes[0], gPartMatInst, shadowXforms.data(), (int)shadowXforms.size());
+        const ShadowCache& c = gShadowCache[i];
+        CascadeList& cl = gList.cascades[i];
+        const bool keyMatch = c.valid
+            && Vector3Equals(c.sunDir, sunDirV) && Vector3Equals(c.target, lightCam[i].target)
+            && c.fovy == lightCam[i].fovy;
+        cl.redrawStatic = !keyMatch || StaticDirtyIn(casterVolume[i]);
+        cl.reuse = viewSame && !cl.redrawStatic;
+        cl.staticCasters.clear();
+        cl.dynamicCasters.clear();
+        cl.staticChunks.clear();
+        if (cl.reuse) continue;
+
+        const bool wantStatic = cl.redrawStatic;
+        if (wantStatic) CullBounds(casterVolume[i], chunkBounds, 0, chunkBounds.Padded(), cl.staticChunks);
+        for (const RenderBatch& b : batches) {
+            if (b.members.empty()) continue;
+            const size_t chunks = CullBatchParallel(casterVolume[i], b, [&](PrepChunk& pc){
+                pc.statics.clear();
+                pc.dynamics.clear();
+                for (uint32_t m : pc.members) {
+                    const RenderProxy& rp = proxies[b.members[m]];
+                    if (!rp.castShadow) continue;
+                    if (!rp.isStatic) pc.dynamics.push_back({ rp.xform, WHITE });
+                    else if (wantStatic) pc.statics.push_back({ rp.xform, WHITE });
                 }
-
-                // re-enable culling to previous state
-                if (kCullBackFace) rlEnableBackfaceCulling();
-
-            EndMode3D();
-        EndTextureMode();
+            });
+            for (size_t k = 0; k < chunks; ++k) {
+                const PrepChunk& pc = gPrepChunks[k];
+                cl.staticCasters.insert(cl.staticCasters.end(), pc.statics.begin(), pc.statics.end());
+                cl.dynamicCasters.insert(cl.dynamicCasters.end(), pc.dynamics.begin(), pc.dynamics.end());
+            }
+        }
     }
+    gScene.ClearStaticDirty();
 
-    // after building shadow maps, set per-cascade normal-bias based on texel size
-    // choose ~1.5 texels of world-space offset as default
-    float nb0 = 1.5f * cascadeTexelWS[0];
-    float nb1 = 1.5f * cascadeTexelWS[1];
-    float nb2 = 1.5f * cascadeTexelWS[2];
-
-    SetShaderValue(gLitShader, u_normalBias0, &nb0, SHADER_UNIFORM_FLOAT);
-    SetShaderValue(gLitShader, u_normalBias1, &nb1, SHADER_UNIFORM_FLOAT);
-    SetShaderValue(gLitShader, u_normalBias2, &nb2, SHADER_UNIFORM_FLOAT);
-
-    SetShaderValue(gLitShaderInst, ui_normalBias0, &nb0, SHADER_UNIFORM_FLOAT);
-    SetShaderValue(gLitShaderInst, ui_normalBias1, &nb1, SHADER_UNIFORM_FLOAT);
-    SetShaderValue(gLitShaderInst, ui_normalBias2, &nb2, SHADER_UNIFORM_FLOAT);
-
-    // ---------------- Main pass ----------------
-    BeginDrawing();
-    ClearBackground(RAYWHITE);
-    BeginMode3D(camera);
-
-    // Skybox
-    rlDisableDepthTest();
-    rlDisableDepthMask();
-    bool prevCull = kCullBackFace;
-    if (kCullBackFace) rlDisableBackfaceCulling();
-    BeginShaderMode(gSkyShader);
-        float inner[3] = {0.25f, 0.45f, 0.65f};  // soft horizon blue
-        float outer[3] = {0.05f, 0.25f, 0.55f};  // deeper zenith blue
-        SetShaderValue(gSkyShader, u_inner, inner, SHADER_UNIFORM_VEC3);
-        SetShaderValue(gSkyShader, u_outer, outer, SHADER_UNIFORM_VEC3);
-        DrawModel(gSkyModel, {0,0,0}, 100.0f, WHITE);
-    EndShaderMode();
-    if (kCullBackFace && prevCull) rlEnableBackfaceCulling();
-    rlEnableDepthMask();
-    rlEnableDepthTest();
-
-    if (kCullBackFace) rlEnableBackfaceCulling();
-
-    // bind three depth textures to slots 10..12
-    int slot0 = 10, slot1 = 11, slot2 = 12;
-    rlActiveTextureSlot(slot0); rlEnableTexture(gShadowMapCSM[0].depth.id);
-    rlActiveTextureSlot(slot1); rlEnableTexture(gShadowMapCSM[1].depth.id);
-    rlActiveTextureSlot(slot2); rlEnableTexture(gShadowMapCSM[2].depth.id);
-
-    // Prepare per-frame uniform values
-    float viewPosArr[3] = { camera.position.x, camera.position.y, camera.position.z };
-    float splitVec[3] = { splits[0], splits[1], splits[2] };
-    float transitionFrac = 0.15f; // 0.05..0.25 typical; lower = tighter band
-    float exposure = kExposure;
-
-    // Helper to set per-frame uniforms for a shader (handles instanced vs non-instanced)
-    auto SetPerFrame = [&](const Shader& sh, bool inst){
-        // choose location set
-        int loc_viewPos    = inst ? ui_viewPos    : u_viewPos;
-        int loc_sunDir     = inst ? ui_sunDir     : u_sunDir;
-        int loc_sky        = inst ? ui_sky        : u_sky;
-        int loc_ground     = inst ? ui_ground     : u_ground;
-        int loc_hemi       = inst ? ui_hemi       : u_hemi;
-        int loc_sun        = inst ? ui_sun        : u_sun;
-        int loc_ambient    = inst ? ui_ambient    : u_ambient;
-        int loc_spec       = inst ? ui_spec       : u_spec;
-        int loc_shiny      = inst ? ui_shiny      : u_shiny;
-        int loc_fresnel    = inst ? ui_fresnel    : u_fresnel;
-        int loc_ao         = inst ? ui_aoStrength : u_aoStrength;
-        int loc_groundY    = inst ? ui_groundY    : u_groundY;
-        int loc_light0     = inst ? ui_lightVP0   : u_lightVP0;
-        int loc_light1     = inst ? ui_lightVP1   : u_lightVP1;
-        int loc_light2     = inst ? ui_lightVP2   : u_lightVP2;
-        int loc_shadow0    = inst ? ui_shadowMap0 : u_shadowMap0;
-        int loc_shadow1    = inst ? ui_shadowMap1 : u_shadowMap1;
-        int loc_shadow2    = inst ? ui_shadowMap2 : u_shadowMap2;
-        int loc_sres       = inst ? ui_shadowRes  : u_shadowRes;
-        int loc_pcf        = inst ? ui_pcfStep    : u_pcfStep;
-        int loc_biasMin    = inst ? ui_biasMin    : u_biasMin;
-        int loc_biasMax    = inst ? ui_biasMax    : u_biasMax;
-        int loc_splitsLoc  = inst ? ui_splits     : u_splits;
-        int loc_transition = inst ? ui_transition : u_transition;
-        int loc_exposureL  = inst ? ui_exposure   : u_exposure;
-
-        SetShaderValue(sh, loc_viewPos, viewPosArr, SHADER_UNIFORM_VEC3);
-        SetShaderValue(sh, loc_sunDir, sunDir, SHADER_UNIFORM_VEC3);
-        SetShaderValue(sh, loc_sky, sky, SHADER_UNIFORM_VEC3);
-        SetShaderValue(sh, loc_ground, ground, SHADER_UNIFORM_VEC3);
-        SetShaderValue(sh, loc_hemi, &hemiStr, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(sh, loc_sun, &sunStr, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(sh, loc_ambient, ambient, SHADER_UNIFORM_VEC3);
-        SetShaderValue(sh, loc_spec, &specStr, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(sh, loc_shiny, &shininess, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(sh, loc_fresnel, &fresnel, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(sh, loc_ao, &aoStr, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(sh, loc_groundY, &groundY, SHADER_UNIFORM_FLOAT);
-
-        SetShaderValueMatrix(sh, loc_light0, lightVP[0]);
-        SetShaderValueMatrix(sh, loc_light1, lightVP[1]);
-        SetShaderValueMatrix(sh, loc_light2, lightVP[2]);
-
-        SetShaderValue(sh, loc_splitsLoc, splitVec, SHADER_UNIFORM_VEC3);
-        SetShaderValue(sh, loc_transition, &transitionFrac, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(sh, loc_exposureL, &exposure, SHADER_UNIFORM_FLOAT);
-
-        // bind sampler slots for this program
-        rlSetUniform(loc_shadow0, &slot0, SHADER_UNIFORM_INT, 1);
-        rlSetUniform(loc_shadow1, &slot1, SHADER_UNIFORM_INT, 1);
-        rlSetUniform(loc_shadow2, &slot2, SHADER_UNIFORM_INT, 1);
+    // ---------------- Commands ----------------
+    auto Draw = [&](uint8_t buffer, uint32_t first, uint32_t count, uint8_t flags){
+        out.Push(RenderOp::DrawInstances, buffer, first, count, 0, 0, flags);
+        ++gStats.drawCalls;
+    };
+    auto DrawChunk = [&](uint32_t id){
+        out.Push(RenderOp::DrawMesh, 0, 0, statics.ChunkIndexCount(id), id);
+        ++gStats.drawCalls;
+    };
+    // send a caster set whole and draw it, with any merged static meshes, into
+    // the cascade's static or live map
+    auto DrawCasters = [&](int i, uint8_t buffer, const std::vector<RenderInstance>& casters,
+                           const std::vector<uint32_t>& chunks, uint8_t flags){
+        out.Reserve(buffer, casters.size(), gStreamCapacity[buffer]);
+        gStats.uploadBytes += out.Upload(buffer, 0, casters.data(), casters.size());
+        out.Push(RenderOp::BeginShadow, 0, 0, 0, out.AddView(lightCam[i]), (uint8_t)i, flags);
+        if (!casters.empty()) Draw(buffer, 0, (uint32_t)casters.size(), 0);
+        for (uint32_t id : chunks) DrawChunk(id);
+        out.Push(RenderOp::EndShadow);
     };
+    static const std::vector<uint32_t> kNoChunks;
 
-    // Apply per-frame values to both non-instanced and instanced shaders
-    SetPerFrame(gLitShader, false);
-    SetPerFrame(gLitShaderInst, true);
+    for (int i=0;i<3;i++){
+        ShadowCache& c = gShadowCache[i];
+        const CascadeList& cl = gList.cascades[i];
+        u.lightVP[i]       = lightVP[i];
+        u.cascadeSplits[i] = splits[i];
+        // ~1.5 texels of world-space offset along the normal
+        u.normalBias[i]    = 1.5f * cascadeTexelWS[i];
+
+        // same view and scene as last frame: the live map is still correct
+        if (cl.reuse) continue;
+
+        if (cl.redrawStatic) c.staticCasters = (uint32_t)(cl.staticCasters.size() + cl.staticChunks.size());
+        gStats.shadowCasters[i] = c.staticCasters + (uint32_t)cl.dynamicCasters.size();
+
+        // static depth: only when the sun, the cascade's snapped placement or its static casters changed
+        if (cl.redrawStatic) {
+            DrawCasters(i, (uint8_t)(kBufShadowStatic + i), cl.staticCasters, cl.staticChunks,
+                        kShadowStaticMap | kShadowClear);
+            c.valid   = true;
+            c.sunDir  = sunDirV;
+            c.target  = lightCam[i].target;
+            c.fovy    = lightCam[i].fovy;
+            c.liveIsStatic = false;
+            ++gStats.shadowStaticRedraws[i];
+        }
 
-    // --- Opaques: batch by color -> instanced draws ---
-    std::unordered_map<uint32_t, std::vector<Matrix>> batches;
-    batches.reserve(64);
+        // live map = cached static depth + this frame's dynamic casters
+        if (cl.dynamicCasters.empty() && c.liveIsStatic) continue;
+        out.Push(RenderOp::CopyShadow, 0, 0, 0, 0, (uint8_t)i);
+        if (!cl.dynamicCasters.empty()) {
+            DrawCasters(i, (uint8_t)(kBufShadowDynamic + i), cl.dynamicCasters, kNoChunks, 0);
+            ++gStats.shadowDynamicRedraws[i];
+        }
+        c.liveIsStatic = cl.dynamicCasters.empty();
+    }
 
-    auto pack = [](unsigned r,unsigned g,unsigned b,unsigned a)->uint32_t{
-        return (r<<24) | (g<<16) | (b<<8) | a;
-    };
+    // Main pass: sky, then the visible merged static meshes and runs of the opaque
+    // batch (colour comes from the vertices / instance buffer), then transparents
+    // in one draw; their instances are stored back to front and GL blends them in
+    // instance order
+    out.Push(RenderOp::BeginMain, 0, 0, 0, out.AddView(camera));
+    out.Push(RenderOp::DrawSky);
+    out.Push(RenderOp::BeginLit);
+    for (uint32_t id : gList.staticChunks) DrawChunk(id);
+    for (const DrawRun& run : gList.opaqueRuns) Draw(kBufOpaque, run.first, run.count, 0);
+    if (gTransparentCount) Draw(kBufTransparent, 0, gTransparentCount, kDrawBlendAlpha);
+    out.Push(RenderOp::EndMain);
+
+    gStats.commands = (uint32_t)out.commands.size();
+    gStats.prepMs = (float)((NowSeconds() - prepT0) * 1000.0);
+}
 
-    for (auto& p : opaques) {
-        Color c = ToRaylibColor(p->Color, 1.0f);
-        uint32_t key = pack(c.r,c.g,c.b,c.a);
-        batches[key].push_back(BuildInstanceMatrix(p->CF, p->Size));
+// ---------------- Main render ----------------
+// Pipelined: frame N's prep runs on the TaskScheduler while the main thread
+// replays frame N-1 and runs frame N+1's scripts. Each slot keeps its list
+// until replayed, so prep and replay never share one.
+struct FrameSlot {
+    FrameSnapshot     snap;
+    RenderCommandList list;
+};
+static FrameSlot               gSlots[2];
+static uint32_t                gSlot = 0;          // slot the next capture fills
+static bool                    gInFlight = false;  // gSlots[gSlot ^ 1] is being prepared
+static RenderBackend*          gInFlightBackend = nullptr;
+static uint32_t                gPresentedSlot = 0;
+static TaskScheduler::Counter  gPrepJob;
+static RenderPipelineMode      gPipelineMode = RenderPipelineMode::Sequential;
+static double                  gRateT0 = 0.0;
+static uint32_t                gRateFrames = 0;
+
+// Make a finished frame's stats the shown ones and replay it; pacing stays with the main thread.
+static void Present(RenderBackend& backend, const FrameSlot& slot, const RenderStats& stats) {
+    const RenderStats::Pacing pacing = gShown.pacing;
+    gShown = stats;
+    gShown.pacing = pacing;
+
+    backend.Execute(slot.list);
+    gPresentedSlot = (uint32_t)(&slot - gSlots);
+
+    const double now = NowSeconds();
+    RenderStats::Pacing& p = gShown.pacing;
+    p.pipelined = gPipelineMode == RenderPipelineMode::Pipelined;
+    p.latencyMs = (float)((now - slot.snap.capturedAt) * 1000.0);
+    ++gRateFrames;
+    if (gRateT0 == 0.0) gRateT0 = now;
+    if (now - gRateT0 >= 1.0) {
+        p.framesPerSecond = (float)(gRateFrames / (now - gRateT0));
+        gRateFrames = 0;
+        gRateT0 = now;
     }
+}
 
-    // Use instanced material/shader for opaque batches
-    if (!batches.empty()) {
-        // Ensure instanced material uses our instanced shader
-        gPartMatInst.shader = gLitShaderInst;
-
-        for (auto& kv : batches) {
-            auto &xforms = kv.second;
-            if (xforms.empty()) continue;
-            uint32_t key = kv.first;
-            Color c = { (unsigned char)(key>>24), (unsigned char)(key>>16), (unsigned char)(key>>8), (unsigned char)(key&0xFF) };
-            gPartMatInst.maps[MATERIAL_MAP_DIFFUSE].color = c;
-            DrawMeshInstanced(gPartModel.meshes[0], gPartMatInst, xforms.data(), (int)xforms.size());
-        }
-    }
+// Join the frame being prepared, if any; returns the milliseconds spent waiting.
+static float JoinPrep() {
+    if (!gInFlight) return 0.0f;
+    const double t0 = NowSeconds();
+    TaskScheduler::Get().Wait(gPrepJob);
+    gInFlight = false;
+    return (float)((NowSeconds() - t0) * 1000.0);
+}
+
+static void RenderSequential(RenderBackend& backend, const Camera3D& camera, float aspect) {
+    FrameSlot& slot = gSlots[gSlot];
+    CaptureFrame(camera, aspect, slot.snap);
+    BuildFrame(slot.snap, slot.list);
+    gShown.pacing.waitMs = 0.0f;
+    Present(backend, slot, gStats);
+}
 
-    // Transparencies (sorted back-to-front)
-    std::sort(transparents.begin(), transparents.end(),
-              [](const TItem& A, const TItem& B){ return A.dist2 > B.dist2; });
-    BeginBlendMode(BLEND_ALPHA);
-    rlDisableDepthMask();
-    for (auto& it : transparents) {
-        Color c = ToRaylibColor(it.p->Color, it.alpha);
-        Vector3 pos = it.p->CF.p.toRay();
-        Vector3 axis; float angleDeg;
-        CFrameToAxisAngle(it.p->CF, axis, angleDeg);
-        DrawModelEx(gPartModel, pos, axis, angleDeg, it.p->Size, c);
+static void RenderPipelined(RenderBackend& backend, const Camera3D& camera, float aspect) {
+    const bool havePrevious = gInFlight;
+    const float waitMs = JoinPrep();
+    const RenderStats finished = gStats; // the worker owns gStats again once the next prep is submitted
+
+    // snapshot this frame and hand it to a worker before replaying the previous one
+    FrameSlot& next = gSlots[gSlot];
+    CaptureFrame(camera, aspect, next.snap);
+    gInFlight = true;
+    gInFlightBackend = &backend;
+    TaskScheduler::Get().Submit(gPrepJob, [&next]{ BuildFrame(next.snap, next.list); });
+    gSlot ^= 1;
+
+    if (havePrevious) {
+        gShown.pacing.waitMs = waitMs;
+        Present(backend, gSlots[gSlot], finished);
     }
-    rlEnableDepthMask();
-    EndBlendMode();
+}
+
+void SetRenderPipelineMode(RenderPipelineMode mode) {
+    if (mode == gPipelineMode) return;
+    if (mode == RenderPipelineMode::Pipelined && TaskScheduler::Get().WorkerCount() == 0)
+        LOGW("Pipelined rendering without worker threads: prep runs when the next frame joins it");
+    FlushRenderPipeline();
+    gPipelineMode = mode;
+    LOGI("Render pipeline: %s", mode == RenderPipelineMode::Pipelined ? "pipelined" : "sequential");
+}
 
-    EndShaderMode();
+RenderPipelineMode GetRenderPipelineMode() { return gPipelineMode; }
 
-    if (kCullBackFace) rlDisableBackfaceCulling();
+void FlushRenderPipeline() {
+    if (!gInFlight) return;
+    const float waitMs = JoinPrep();
+    gShown.pacing.waitMs = waitMs;
+    Present(*gInFlightBackend, gSlots[gSlot ^ 1], gStats);
+}
 
-    EndMode3D();
-    DrawFPS(10,10);
-    EndDrawing();
+void RenderFrame(RenderBackend& backend, const Camera3D& camera, float aspect) {
+    if (gPipelineMode == RenderPipelineMode::Pipelined) RenderPipelined(backend, camera, aspect);
+    else RenderSequential(backend, camera, aspect);
 }
 
+void RenderFrame(Camera3D& camera) {
+    if (IsKeyPressed(KEY_F11)) {
+        static bool borderless=false; borderless=!borderless;
+        if (borderless) EnterBorderlessFullscreen(); else ExitBorderlessFullscreen();
+    }
+    if (IsKeyPressed(KEY_F10)) {
+        SetRenderPipelineMode(gPipelineMode == RenderPipelineMode::Pipelined
+            ? RenderPipelineMode::Sequential : RenderPipelineMode::Pipelined);
+    }
+    RenderFrame(gRlglBackend, camera, (float)GetScreenWidth()/(float)GetScreenHeight());
+}
+
+const RenderCommandList& GetRenderCommands() { return gSlots[gPresentedSlot].list; }
+
 // ---------------- Optional cleanup ----------------
 void ShutdownRendererShadowResources(){
-    for (int i=0;i<3;i++){
-        if (gShadowMapCSM[i].id) { UnloadShadowmapRenderTexture(gShadowMapCSM[i]); gShadowMapCSM[i] = {0}; }
-    }
-    if (gSkyModel.meshCount) { UnloadModel(gSkyModel); gSkyModel = {0}; }
-    if (gPartModel.meshCount){ UnloadModel(gPartModel); gPartModel = {0}; }
-    if (gPartMatInst.shader.id){ UnloadMaterial(gPartMatInst); gPartMatInst = {0}; }
-    if (gSkyShader.id) { UnloadShader(gSkyShader); gSkyShader = {0}; }
-    if (gLitShaderInst.id){ UnloadShader(gLitShaderInst); gLitShaderInst = {0}; }
-    if (gLitShader.id) { UnloadShader(gLitShader); gLitShader = {0}; }
-}
\ No newline at end of file
+    FlushRenderPipeline();
+    gScene.Reset();
+    gViewValid = false;
+    gTransparents.clear();
+    gTransparentCount = 0;
+    for (FrameSlot& slot : gSlots) slot.list.Clear();
+    for (uint32_t& cap : gStreamCapacity) cap = 0;
+    for (int i=0;i<3;i++) gShadowCache[i] = ShadowCache{};
+    gRlglBackend.Release();
+}
@@ -1,6 +1,73 @@
 #pragma once
 #include <raylib.h>
+#include <cstddef>
+#include <cstdint>
+
+// Per-frame counters, shown in the overlay.
+struct RenderStats {
+    uint32_t parts{0};           // proxies in the retained scene
+    uint32_t partsUpdated{0};    // proxies rebuilt from journal records this frame
+    uint32_t interpolated{0};    // physics bodies drawn between their last two steps
+    uint32_t journalRecords{0};  // change records pending at the start of the frame
+    uint32_t visible{0};         // parts that passed the frustum test (hidden parts excluded)
+    uint32_t culled{0};          // parts rejected by the frustum test
+    float    cullMs{0.0f};       // CPU time of the frustum test and list build
+    uint32_t transparents{0};    // visible transparent parts, drawn in one instanced call
+    float    sortMs{0.0f};       // CPU time of the transparent depth sort (part of cullMs)
+    float    syncMs{0.0f};       // main-thread snapshot: scene sync from the journal, camera and lighting
+    float    prepMs{0.0f};       // CPU time of render prep: culling, caster gathering, command recording
+    uint32_t shadowCasters[3]{}; // instances and merged static meshes drawn into each shadow cascade
+    uint32_t drawCalls{0};       // instanced and single draws issued for parts
+    size_t   uploadBytes{0};     // instance data sent to the GPU this frame
+    uint32_t commands{0};        // render commands recorded for the frame
+
+    // static opaque casters merged into per-cell meshes (see StaticBatcher)
+    struct Statics {
+        uint32_t parts{0};           // parts drawn from merged meshes instead of instances
+        uint32_t chunks{0};          // meshes they are merged into
+        uint32_t chunksDrawn{0};     // meshes that passed the frustum test
+        uint32_t verticesBefore{0};  // 24 per merged part, as instanced cubes
+        uint32_t verticesAfter{0};   // 4 per face kept
+        uint32_t hiddenFaces{0};     // faces dropped as covered by a neighbour
+        uint32_t cellsRebuilt{0};    // by the last rebuild
+        float    rebuildMs{0.0f};
+    } statics;
+
+    // main thread, measured when the frame is replayed
+    struct Pacing {
+        bool  pipelined{false};
+        float latencyMs{0.0f};       // snapshot taken -> frame replayed
+        float framesPerSecond{0.0f}; // frames replayed, averaged over about a second
+        float waitMs{0.0f};          // main thread blocked on the frame's prep
+    } pacing;
+
+    // cumulative since startup
+    uint64_t frames{0};
+    uint64_t shadowStaticRedraws[3]{};  // cached static depth re-rendered
+    uint64_t shadowDynamicRedraws[3]{}; // dynamic casters composited over the cache
+};
+
+struct RenderCommandList;
+class RenderBackend;
+
+// Sequential: snapshot, prep and replay each frame in RenderFrame.
+// Pipelined: RenderFrame snapshots frame N and starts its prep on the
+// TaskScheduler, then replays frame N-1; prep overlaps the replay and the
+// scripts of the next frame, at the cost of one frame of latency.
+enum class RenderPipelineMode : uint8_t { Sequential, Pipelined };
+void SetRenderPipelineMode(RenderPipelineMode mode);
+RenderPipelineMode GetRenderPipelineMode();
+// Finish and replay the frame still being prepared, if any.
+void FlushRenderPipeline();
 
 void InitRenderer();
 void ShutdownRenderer();
-void RenderFrame(Camera3D& camera);
\ No newline at end of file
+// Window entry point: handles F11 and replays on the rlgl backend.
+void RenderFrame(Camera3D& camera);
+// Build the frame's command list (no GL calls) and replay it on 'backend'.
+// 'aspect' is the main view's width / height. Prep keeps track of what the
+// backend holds between frames, so use one backend for the life of the scene.
+void RenderFrame(RenderBackend& backend, const Camera3D& camera, float aspect);
+// The list last replayed.
+const RenderCommandList& GetRenderCommands();
+const RenderStats& GetRenderStats();
@@ -24,12 +24,15 @@
 #include "core/datatypes/Random.h"
 #include "core/datatypes/Enum.h"
 #include "core/logging/Logging.h"
+#include "core/runtime/Time.h"
 
 // Standard library
 #include <cstring>
 #include <optional>
 #include "bootstrap/instances/InstanceTypes.h"
 #include "bootstrap/instances/BaseScript.h"
+#include "bootstrap/QueryParams.h"
+#include "bootstrap/services/CollectionService.h"
 
 // Forward declarations
 struct Script;
@@ -278,6 +281,7 @@ static int m_SetAttribute(lua_State* L) {
     if (!inst_ptr || !*inst_ptr || !(*inst_ptr)->Alive) return 0;
     auto inst = *inst_ptr;
     const char* name = luaL_checkstring(L, 2);
+    if (lua_isnoneornil(L, 3)) { inst->RemoveAttribute(name); return 0; }
     Attribute v{};
     if (!read_attribute(L, 3, v)) {
         luaL_error(L, "SetAttribute: unsupported value type for '%s'", name);
@@ -303,13 +307,69 @@ static int m_GetAttributes(lua_State* L) {
     if (!inst_ptr || !*inst_ptr || !(*inst_ptr)->Alive) { lua_newtable(L); return 1; }
     auto inst = *inst_ptr;
     lua_newtable(L);
-    for (const auto& [k, v] : inst->GetAttributes()) {
-        push_attribute(L, v);
-        lua_setfield(L, -2, k.c_str());
+    for (const auto& e : inst->GetAttributes()) {
+        push_attribute(L, e.Get());
+        lua_setfield(L, -2, AttributeName(e.Id()).c_str());
     }
     return 1;
 }
 
+static int m_GetAttributeChangedSignal(lua_State* L) {
+    auto* inst_ptr = l_check_instance(L, 1);
+    if (!inst_ptr || !*inst_ptr) { lua_pushnil(L); return 1; }
+    const char* name = luaL_checkstring(L, 2);
+    const AttrId id = InternAttribute(name);
+    if (id == kInvalidAttr) { luaL_error(L, "GetAttributeChangedSignal: too many attribute names"); return 0; }
+    Lua_PushSignal(L, (*inst_ptr)->GetAttributeChangedSignal(id));
+    return 1;
+}
+
+// ================== Tags ==================
+
+static int m_AddTag(lua_State* L) {
+    auto* inst_ptr = l_check_instance(L, 1);
+    if (!inst_ptr || !*inst_ptr || !(*inst_ptr)->Alive) return 0;
+    CollectionService::AddTag(inst_ptr->get(), luaL_checkstring(L, 2));
+    return 0;
+}
+
+static int m_RemoveTag(lua_State* L) {
+    auto* inst_ptr = l_check_instance(L, 1);
+    if (!inst_ptr || !*inst_ptr) return 0;
+    CollectionService::RemoveTag(inst_ptr->get(), luaL_checkstring(L, 2));
+    return 0;
+}
+
+static int m_HasTag(lua_State* L) {
+    auto* inst_ptr = l_check_instance(L, 1);
+    if (!inst_ptr || !*inst_ptr) { lua_pushboolean(L, 0); return 1; }
+    lua_pushboolean(L, CollectionService::HasTag(inst_ptr->get(), luaL_checkstring(L, 2)));
+    return 1;
+}
+
+static int m_GetTags(lua_State* L) {
+    auto* inst_ptr = l_check_instance(L, 1);
+    if (!inst_ptr || !*inst_ptr) { lua_newtable(L); return 1; }
+    auto tags = CollectionService::GetTags(inst_ptr->get());
+    lua_createtable(L, (int)tags.size(), 0);
+    int i = 1;
+    for (auto& t : tags) { lua_pushlstring(L, t.data(), t.size()); lua_rawseti(L, -2, i++); }
+    return 1;
+}
+
+static int m_GetPropertyChangedSignal(lua_State* L) {
+    auto* inst_ptr = l_check_instance(L, 1);
+    if (!inst_ptr || !*inst_ptr) { lua_pushnil(L); return 1; }
+    const char* name = luaL_checkstring(L, 2);
+    const Prop p = PropFromName(name);
+    if (p == Prop::Count) {
+        luaL_error(L, "%s is not a valid property name.", name);
+        return 0;
+    }
+    Lua_PushSignal(L, (*inst_ptr)->GetPropertyChangedSignal(p));
+    return 1;
+}
+
 static int m_GetFullName(lua_State* L) {
     auto* inst_ptr = l_check_instance(L, 1);
     if (!inst_ptr || !*inst_ptr) { lua_pushnil(L); return 1; }
@@ -483,6 +543,15 @@ static int l_instance_index(lua_State* L) {
     // Delegate object-specific reads to the instance
     if (inst->LuaGet(L, key)) return 1;
 
+    if (key[0] == 'C' && std::strcmp(key, "Changed") == 0) {
+        Lua_PushSignal(L, inst->GetChangedSignal());
+        return 1;
+    }
+    if (key[0] == 'A' && std::strcmp(key, "AttributeChanged") == 0) {
+        Lua_PushSignal(L, inst->GetAttributeChangedAnySignal());
+        return 1;
+    }
+
     // Child by name
     if (auto child = inst->FindFirstChild(key)) {
         Lua_PushInstance(L, child);
@@ -514,17 +583,7 @@ static int l_instance_newindex(lua_State* L) {
 
     // Name
     if (key[0] == 'N' && std::strcmp(key, "Name") == 0) {
-        const char* newName = luaL_checkstring(L, 3);
-        if (inst->Name != newName) {
-            if (auto p = inst->Parent.lock()) {
-                auto it = p->ChildrenByName.find(inst->Name);
-                if (it != p->ChildrenByName.end() && it->second.get() == inst.get()) {
-                    p->ChildrenByName.erase(it);
-                }
-                p->ChildrenByName[newName] = inst;
-            }
-            inst->Name = newName;
-        }
+        inst->SetName(luaL_checkstring(L, 3));
         return 0;
     }
 
@@ -570,11 +629,11 @@ static int l_wait(lua_State* L) {
     Script* self = (Script*)lua_getthreaddata(L);
     if (g_game && g_game->luaScheduler) {
         if (self) {
-            if (seconds > 0.0) g_game->luaScheduler->SetWaitAbs(self, GetTime() + seconds);
+            if (seconds > 0.0) g_game->luaScheduler->SetWaitAbs(self, timing::Now() + seconds);
             else               g_game->luaScheduler->SetWaitNextFrame(self);
         } else {
             // inside a task thread
-            if (seconds > 0.0) g_game->luaScheduler->SetTaskWaitAbs(L, GetTime() + seconds);
+            if (seconds > 0.0) g_game->luaScheduler->SetTaskWaitAbs(L, timing::Now() + seconds);
             else               g_game->luaScheduler->SetTaskWaitNextFrame(L);
         }
     }
@@ -640,7 +699,7 @@ static int l_task_delay(lua_State* L) {
     lua_xmove(L, co, nstack);
 
     // Schedule for the future
-    g_game->luaScheduler->ScheduleTaskAt(co, ref, GetTime() + std::max(0.0, seconds), argc);
+    g_game->luaScheduler->ScheduleTaskAt(co, ref, timing::Now() + std::max(0.0, seconds), argc);
 
     // Return the thread
     lua_getref(LM, ref);
@@ -660,7 +719,13 @@ void RegisterSharedLibreboxAPI(lua_State* L) {
     lua_pushcfunction(L, m_SetAttribute, "SetAttribute"); lua_setfield(L, -2, "SetAttribute");
     lua_pushcfunction(L, m_GetAttribute, "GetAttribute"); lua_setfield(L, -2, "GetAttribute");
     lua_pushcfunction(L, m_GetAttributes,"GetAttributes");lua_setfield(L, -2, "GetAttributes");
+    lua_pushcfunction(L, m_GetAttributeChangedSignal, "GetAttributeChangedSignal"); lua_setfield(L, -2, "GetAttributeChangedSignal");
     lua_pushcfunction(L, m_GetFullName,  "GetFullName");  lua_setfield(L, -2, "GetFullName");
+    lua_pushcfunction(L, m_AddTag,    "AddTag");    lua_setfield(L, -2, "AddTag");
+    lua_pushcfunction(L, m_RemoveTag, "RemoveTag"); lua_setfield(L, -2, "RemoveTag");
+    lua_pushcfunction(L, m_HasTag,    "HasTag");    lua_setfield(L, -2, "HasTag");
+    lua_pushcfunction(L, m_GetTags,   "GetTags");   lua_setfield(L, -2, "GetTags");
+    lua_pushcfunction(L, m_GetPropertyChangedSignal, "GetPropertyChangedSignal"); lua_setfield(L, -2, "GetPropertyChangedSignal");
     lua_pushcfunction(L, m_Destroy, "Destroy");           lua_setfield(L, -2, "Destroy");
     lua_pushcfunction(L, m_GetChildren,   "GetChildren");   lua_setfield(L, -2, "GetChildren");
     lua_pushcfunction(L, m_GetDescendants,"GetDescendants");lua_setfield(L, -2, "GetDescendants");
@@ -705,6 +770,7 @@ void RegisterSharedLibreboxAPI(lua_State* L) {
     lb::register_type<CFrame>(L);
     lb::register_type<Color3>(L);
     lb::register_type<Random>(L);
+    RegisterQueryTypes(L);
 
     // Globals
     lua_pushcfunction(L, l_wait, "wait");
@@ -817,5 +883,13 @@ static void RegisterEnumGlobal(lua_State* L) {
         lua_setfield(L, -2, "KeyCode");
     }
     
+    // RaycastFilterType enum
+    if (Enum* raycastFilterType = registry.GetEnum("RaycastFilterType")) {
+        lua_newtable(L);
+        lua_pushstring(L, "Exclude"); Lua_PushEnumItem(L, raycastFilterType->GetItem("Exclude")); lua_settable(L, -3);
+        lua_pushstring(L, "Include"); Lua_PushEnumItem(L, raycastFilterType->GetItem("Include")); lua_settable(L, -3);
+        lua_setfield(L, -2, "RaycastFilterType");
+    }
+    
     lua_setglobal(L, "Enum");
 }
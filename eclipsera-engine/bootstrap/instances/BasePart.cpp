@@ -1,5 +1,11 @@
 #include "bootstrap/instances/BasePart.h"
+#include "bootstrap/Assemblies.h"
+#include "bootstrap/Game.h"
+#include "bootstrap/ScriptingAPI.h"
+#include "bootstrap/services/PhysicsService.h"
+#include "bootstrap/signals/Signal.h"
 #include "core/logging/Logging.h"
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 
@@ -7,12 +13,30 @@ static inline float rad2deg(float r){ return r * 57.29577951308232f; }
 static inline float deg2rad(float d){ return d * 0.017453292519943295f; }
 
 BasePart::BasePart(std::string name, InstanceClass cls)
-    : Instance(std::move(name), cls), CF{} {
+    : PVInstance(std::move(name), cls), CF{} {
     LOGI("BasePart created '%s' (Transparency=%.2f, Color=%.2f,%.2f,%.2f)", 
          Name.c_str(), Transparency, Color.r, Color.g, Color.b);
 }
 
-BasePart::~BasePart() = default;
+// Assemblies keeps raw pointers to welded parts until its next rebuild
+BasePart::~BasePart() {
+    if (AssemblySlot != Assemblies::kNone) Assemblies::Get().MarkDirty();
+}
+
+void BasePart::Destroy() {
+    Instance::Destroy();
+    if (AssemblySlot != Assemblies::kNone) Assemblies::Get().MarkDirty();
+}
+
+void BasePart::PivotTo(const CFrame& target) {
+    Assemblies::Get().SetPartCFrame(this, target);
+}
+
+// Position and Orientation move the part alone; a welded part keeps the new offset.
+static void Reweld(const BasePart* p) {
+    if (p->AssemblySlot != Assemblies::kNone && Assemblies::Get().AssemblyOf(p) != Assemblies::kNone)
+        Assemblies::Get().MarkDirty();
+}
 
 bool BasePart::LuaGet(lua_State* L, const char* key) const {
     if (std::strcmp(key, "CFrame") == 0) {
@@ -41,40 +65,147 @@ bool BasePart::LuaGet(lua_State* L, const char* key) const {
         lb::push(L, Color3{ Color.r, Color.g, Color.b });
         return true;
     }
-    return false;
+    if (std::strcmp(key, "Reflectance") == 0) { lua_pushnumber(L, Reflectance); return true; }
+    if (std::strcmp(key, "Anchored") == 0)    { lua_pushboolean(L, Anchored);   return true; }
+    if (std::strcmp(key, "CanCollide") == 0)  { lua_pushboolean(L, CanCollide); return true; }
+    if (std::strcmp(key, "CanTouch") == 0)    { lua_pushboolean(L, CanTouch);   return true; }
+    if (std::strcmp(key, "CastShadow") == 0)  { lua_pushboolean(L, CastShadow); return true; }
+    if (std::strcmp(key, "Density") == 0)     { lua_pushnumber(L, Density);     return true; }
+    if (std::strcmp(key, "Friction") == 0)    { lua_pushnumber(L, Friction);    return true; }
+    if (std::strcmp(key, "Elasticity") == 0)  { lua_pushnumber(L, Elasticity);  return true; }
+    if (std::strcmp(key, "CollisionGroup") == 0) {
+        const std::string& name = PhysicsService::GroupName(CollisionGroupId);
+        lua_pushlstring(L, name.data(), name.size());
+        return true;
+    }
+    if (std::strcmp(key, "CollisionGroupId") == 0) { lua_pushinteger(L, CollisionGroupId); return true; }
+    if (std::strcmp(key, "AssemblyRootPart") == 0) {
+        auto& assemblies = Assemblies::Get();
+        const uint32_t a = assemblies.AssemblyOf(this);
+        const BasePart* root = a == Assemblies::kNone ? this : assemblies.Parts()[assemblies.Begin(a)];
+        Lua_PushInstance(L, const_cast<BasePart*>(root)->shared_from_this());
+        return true;
+    }
+    const bool touched = std::strcmp(key, "Touched") == 0;
+    if (touched || std::strcmp(key, "TouchEnded") == 0) {
+        auto& sig = touched ? Touch.touched : Touch.ended;
+        if (!sig) sig = std::make_shared<RTScriptSignal>(g_game ? g_game->luaScheduler.get() : nullptr, 4);
+        Lua_PushSignal(L, sig);
+        return true;
+    }
+    return PVInstance::LuaGet(L, key);
 }
 
 bool BasePart::LuaSet(lua_State* L, const char* key, int valueIndex) {
     if (std::strcmp(key, "CFrame") == 0) {
         const auto* cf = lb::check<CFrame>(L, valueIndex);
-        CF = *cf;
+        Assemblies::Get().SetPartCFrame(this, *cf);
         return true;
     }
     if (std::strcmp(key, "Position") == 0) {
         const auto* v = lb::check<Vector3Game>(L, valueIndex);
+        if (CF.p.x == v->x && CF.p.y == v->y && CF.p.z == v->z) return true;
         CF.p = *v;
+        PropertyChanged(kTransformProps);
+        Reweld(this);
         return true;
     }
     if (std::strcmp(key, "Orientation") == 0) {
         const auto* vdeg = lb::check<Vector3Game>(L, valueIndex);
         CFrame rot = CFrame::fromEulerAnglesXYZ(
             deg2rad(vdeg->x), deg2rad(vdeg->y), deg2rad(vdeg->z));
+        if (std::equal(rot.R, rot.R + 9, CF.R)) return true;
         // replace rotation, keep translation
         for(int i=0;i<9;i++) CF.R[i] = rot.R[i];
+        PropertyChanged(kTransformProps);
+        Reweld(this);
         return true;
     }
     if (std::strcmp(key, "Size") == 0) {
         const auto* v = lb::check<Vector3Game>(L, valueIndex);
+        if (Size.x == v->x && Size.y == v->y && Size.z == v->z) return true;
         Size = v->toRay();
+        PropertyChanged(PropBit(Prop::Size));
         return true;
     }
     if (std::strcmp(key, "Transparency") == 0) {
-        Transparency = (float)luaL_checknumber(L, valueIndex);
+        const float v = (float)luaL_checknumber(L, valueIndex);
+        if (v == Transparency) return true;
+        Transparency = v;
+        PropertyChanged(PropBit(Prop::Transparency));
         return true;
     }
     if (std::strcmp(key, "Color") == 0) {
         const auto* c = lb::check<Color3>(L, valueIndex);
+        if (*c == Color) return true;
         Color = { c->r, c->g, c->b };
+        PropertyChanged(PropBit(Prop::Color));
+        return true;
+    }
+    if (std::strcmp(key, "Reflectance") == 0) {
+        const float v = (float)luaL_checknumber(L, valueIndex);
+        if (v == Reflectance) return true;
+        Reflectance = v;
+        PropertyChanged(PropBit(Prop::Reflectance));
+        return true;
+    }
+    if (std::strcmp(key, "Anchored") == 0) {
+        const bool v = lua_toboolean(L, valueIndex);
+        if (v == Anchored) return true;
+        Anchored = v;
+        PropertyChanged(PropBit(Prop::Anchored));
+        return true;
+    }
+    if (std::strcmp(key, "CanCollide") == 0) {
+        const bool v = lua_toboolean(L, valueIndex);
+        if (v == CanCollide) return true;
+        CanCollide = v;
+        PropertyChanged(PropBit(Prop::CanCollide));
+        return true;
+    }
+    if (std::strcmp(key, "CanTouch") == 0) {
+        const bool v = lua_toboolean(L, valueIndex);
+        if (v == CanTouch) return true;
+        CanTouch = v;
+        PropertyChanged(PropBit(Prop::CanTouch));
+        return true;
+    }
+    if (std::strcmp(key, "CastShadow") == 0) {
+        const bool v = lua_toboolean(L, valueIndex);
+        if (v == CastShadow) return true;
+        CastShadow = v;
+        PropertyChanged(PropBit(Prop::CastShadow));
+        return true;
+    }
+    if (std::strcmp(key, "Density") == 0) {
+        const float v = std::clamp((float)luaL_checknumber(L, valueIndex), 0.01f, 100.0f);
+        if (v == Density) return true;  // a no-op write must not wake the body
+        Density = v;
+        PropertyChanged(PropBit(Prop::Density));
+        return true;
+    }
+    if (std::strcmp(key, "Friction") == 0) {
+        const float v = std::clamp((float)luaL_checknumber(L, valueIndex), 0.0f, 2.0f);
+        if (v == Friction) return true;
+        Friction = v;
+        PropertyChanged(PropBit(Prop::Friction));
+        return true;
+    }
+    if (std::strcmp(key, "Elasticity") == 0) {
+        const float v = std::clamp((float)luaL_checknumber(L, valueIndex), 0.0f, 1.0f);
+        if (v == Elasticity) return true;
+        Elasticity = v;
+        PropertyChanged(PropBit(Prop::Elasticity));
+        return true;
+    }
+    if (std::strcmp(key, "CollisionGroup") == 0) {
+        const char* name = luaL_checkstring(L, valueIndex);
+        const uint8_t id = PhysicsService::FindGroup(name);
+        if (id == PhysicsService::kInvalidGroup) luaL_error(L, "collision group '%s' is not registered", name);
+        if (id != CollisionGroupId) {
+            CollisionGroupId = id;
+            PropertyChanged(PropBit(Prop::CollisionGroup));
+        }
         return true;
     }
     return false;
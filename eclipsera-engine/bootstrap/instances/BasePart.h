@@ -1,13 +1,14 @@
 #pragma once
-#include "bootstrap/Instance.h"
+#include "bootstrap/instances/PVInstance.h"
 #include "core/datatypes/Vector3Game.h"
 #include "core/datatypes/CFrame.h"
 #include "core/datatypes/Color3.h"
 
 // Forward declare Lua
 struct lua_State;
+struct RTScriptSignal;
 
-struct BasePart : Instance {
+struct BasePart : PVInstance {
     ::Vector3 Size{1.0f,1.0f,1.0f};
 
     // Store transform internally as a CFrame (position + rotation)
@@ -25,11 +26,37 @@ struct BasePart : Instance {
     float Friction{0.3f};
     float Elasticity{0.5f};
 
+    // PhysicsService collision group; 0 is Default
+    uint8_t CollisionGroupId{0};
+
     Color3 Color{0.63f, 0.63f, 0.63f}; // default white
 
+    // Slot in the renderer's RenderScene; only trusted if the proxy there points back at us
+    uint32_t RenderSlot{0xFFFFFFFFu};
+    // Slot in the PhysicsWorld; same rule
+    uint32_t PhysicsSlot{0xFFFFFFFFu};
+    // Member slot in Assemblies while welded, same rule; kNone until a weld names the part
+    uint32_t AssemblySlot{0xFFFFFFFFu};
+
+    // Touched(otherPart) / TouchEnded(otherPart), created on first access and
+    // fired by PhysicsSync after each physics step. Clone does not copy them.
+    struct TouchSignals {
+        std::shared_ptr<RTScriptSignal> touched, ended;
+        TouchSignals() = default;
+        TouchSignals(const TouchSignals&) {}
+        TouchSignals& operator=(const TouchSignals&) { return *this; }
+    };
+    mutable TouchSignals Touch;
+
     BasePart(std::string name, InstanceClass cls);
     ~BasePart() override;
 
+    void Destroy() override;
+
+    // The pivot is the CFrame; PivotTo moves the part's whole assembly.
+    CFrame GetPivot() const override { return CF; }
+    void   PivotTo(const CFrame& target) override;
+
     bool LuaGet(lua_State* L, const char* key) const override;
     bool LuaSet(lua_State* L, const char* key, int valueIndex) override;
 };
@@ -1,5 +1,12 @@
 #include "bootstrap/instances/CameraGame.h"
+#include "core/datatypes/LuaDatatypes.h"
+#include "core/datatypes/Vector3Game.h"
 #include "core/logging/Logging.h"
+#include "subsystems/input/CursorRaycaster.h"
+#include "lua.h"
+#include "lualib.h"
+#include "raymath.h"
+#include <cstring>
 #include <memory>
 
 CameraGame::CameraGame(std::string name) : Instance(std::move(name), InstanceClass::Camera) {
@@ -7,4 +14,27 @@ CameraGame::CameraGame(std::string name) : Instance(std::move(name), InstanceCla
 }
 CameraGame::~CameraGame() = default;
 
+// camera:ScreenPointToRay(x, y, depth?) -> { Origin, Direction }
+// The origin is on the near plane, moved 'depth' studs along the unit
+// direction. There is no GUI inset, so both methods take the same pixels.
+static int l_camera_pointToRay(lua_State* L) {
+    luaL_checkudata(L, 1, "Librebox.Instance");
+    const Vector2 point{ (float)luaL_checknumber(L, 2), (float)luaL_checknumber(L, 3) };
+    const float depth = (float)luaL_optnumber(L, 4, 0.0);
+
+    const Ray r = CursorRaycaster::Get().ScreenPointToRay(point);
+    lua_createtable(L, 0, 2);
+    lb::push(L, Vector3Game::fromRay(Vector3Add(r.position, Vector3Scale(r.direction, depth))));
+    lua_setfield(L, -2, "Origin");
+    lb::push(L, Vector3Game::fromRay(r.direction));
+    lua_setfield(L, -2, "Direction");
+    return 1;
+}
+
+bool CameraGame::LuaGet(lua_State* L, const char* key) const {
+    if (std::strcmp(key, "ScreenPointToRay") == 0)   { lua_pushcfunction(L, l_camera_pointToRay, "ScreenPointToRay"); return true; }
+    if (std::strcmp(key, "ViewportPointToRay") == 0) { lua_pushcfunction(L, l_camera_pointToRay, "ViewportPointToRay"); return true; }
+    return false;
+}
+
 static Instance::Registrar _reg_cam("Camera", []{ return std::make_shared<CameraGame>("Camera"); });
@@ -6,4 +6,7 @@ struct CameraGame : Instance {
     ::Vector3 Target{0.0f,0.0f,0.0f};
     CameraGame(std::string name = "Camera");
     ~CameraGame() override;
+
+    // ScreenPointToRay, ViewportPointToRay (see CursorRaycaster)
+    bool LuaGet(lua_State* L, const char* key) const override;
 };
\ No newline at end of file
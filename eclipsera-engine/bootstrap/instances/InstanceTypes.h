@@ -4,4 +4,6 @@
 #include "bootstrap/instances/Workspace.h"
 #include "bootstrap/instances/Script.h"
 #include "bootstrap/instances/LocalScript.h"
+#include "bootstrap/instances/ModelGame.h"
+#include "bootstrap/instances/WeldConstraint.h"
 // #include "bootstrap/instances/ModuleScript.h"
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "bootstrap/instances/ModelGame.h"
+#include "bootstrap/Assemblies.h"
+#include "bootstrap/ScriptingAPI.h"
+#include "bootstrap/instances/BasePart.h"
+#include "core/datatypes/LuaDatatypes.h"
+#include "lua.h"
+#include "lualib.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+ModelGame::ModelGame(std::string name) : PVInstance(std::move(name), InstanceClass::Model) {}
+ModelGame::~ModelGame() = default;
+
+void ModelGame::GetParts(std::vector<BasePart*>& out) const {
+    out.clear();
+    std::vector<const Instance*> stack{ this };
+    while (!stack.empty()) {
+        const Instance* n = stack.back(); stack.pop_back();
+        for (auto it = n->Children.rbegin(); it != n->Children.rend(); ++it) {
+            Instance* c = it->get();
+            if (!c || !c->Alive) continue;
+            if (c->Class == InstanceClass::Part) out.push_back(static_cast<BasePart*>(c));
+            if (!c->Children.empty()) stack.push_back(c);
+        }
+    }
+}
+
+// centre of the world AABB of the parts' oriented boxes, unrotated
+static CFrame BoundsCenter(const std::vector<BasePart*>& parts) {
+    if (parts.empty()) return CFrame();
+    float lo[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, hi[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (const BasePart* p : parts) {
+        const float* R = p->CF.R;
+        const float h[3] = { 0.5f * p->Size.x, 0.5f * p->Size.y, 0.5f * p->Size.z };
+        const float c[3] = { p->CF.p.x, p->CF.p.y, p->CF.p.z };
+        for (int a = 0; a < 3; ++a) {
+            const float e = std::fabs(R[a*3])*h[0] + std::fabs(R[a*3 + 1])*h[1] + std::fabs(R[a*3 + 2])*h[2];
+            lo[a] = std::min(lo[a], c[a] - e);
+            hi[a] = std::max(hi[a], c[a] + e);
+        }
+    }
+    return CFrame(Vector3Game{ 0.5f * (lo[0] + hi[0]), 0.5f * (lo[1] + hi[1]), 0.5f * (lo[2] + hi[2]) });
+}
+
+CFrame ModelGame::GetPivot() const {
+    if (auto pp = PrimaryPart.lock(); pp && pp->Alive) return pp->CF;
+    if (HasWorldPivot) return WorldPivot;
+    std::vector<BasePart*> parts;
+    GetParts(parts);
+    return BoundsCenter(parts);
+}
+
+void ModelGame::PivotTo(const CFrame& target) {
+    std::vector<BasePart*> parts;
+    GetParts(parts);
+    const auto pp = PrimaryPart.lock();
+    const bool primary = pp && pp->Alive;
+    const CFrame pivot = primary ? pp->CF : HasWorldPivot ? WorldPivot : BoundsCenter(parts);
+    Assemblies::Get().Transform(parts.data(), parts.size(), target * pivot.inverse());
+    if (!primary) { WorldPivot = target; HasWorldPivot = true; }
+}
+
+void ModelGame::RemapReferences(const CloneMap& m) {
+    PrimaryPart = RemapWeak(m, PrimaryPart);
+}
+
+bool ModelGame::LuaGet(lua_State* L, const char* key) const {
+    if (std::strcmp(key, "PrimaryPart") == 0) { Lua_PushInstance(L, PrimaryPart.lock()); return true; }
+    if (std::strcmp(key, "WorldPivot") == 0)  { lb::push(L, GetPivot()); return true; }
+    return PVInstance::LuaGet(L, key);
+}
+
+bool ModelGame::LuaSet(lua_State* L, const char* key, int valueIndex) {
+    if (std::strcmp(key, "PrimaryPart") == 0) {
+        if (lua_isnil(L, valueIndex)) { PrimaryPart.reset(); return true; }
+        auto* p = static_cast<std::shared_ptr<Instance>*>(lb::luaL_testudata(L, valueIndex, "Librebox.Instance"));
+        auto part = p ? std::dynamic_pointer_cast<BasePart>(*p) : nullptr;
+        if (!part) luaL_error(L, "PrimaryPart must be a BasePart or nil");
+        if (!part->IsDescendantOf(shared_from_this())) luaL_error(L, "PrimaryPart must be a descendant of the Model");
+        PrimaryPart = part;
+        return true;
+    }
+    if (std::strcmp(key, "WorldPivot") == 0) {
+        const CFrame cf = *lb::check<CFrame>(L, valueIndex);
+        // with a PrimaryPart the pivot follows it; moving the pivot moves nothing either way
+        WorldPivot = cf;
+        HasWorldPivot = true;
+        return true;
+    }
+    return false;
+}
+
+static Instance::Registrar _reg_model("Model", [] {
+    return std::make_shared<ModelGame>("Model");
+});
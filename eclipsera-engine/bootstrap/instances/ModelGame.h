@@ -0,0 +1,27 @@
+#pragma once
+#include "bootstrap/instances/PVInstance.h"
+
+struct BasePart;
+
+// Groups parts under one pivot. The pivot is PrimaryPart's CFrame when it is
+// set, else WorldPivot, which starts at the centre of the parts' bounding box
+// the first time it is needed. PivotTo applies one rigid transform to every
+// descendant part, moving each welded assembly among them once and whole.
+struct ModelGame : PVInstance {
+    std::weak_ptr<BasePart> PrimaryPart;
+    CFrame WorldPivot;
+    bool   HasWorldPivot{false};
+
+    explicit ModelGame(std::string name = "Model");
+    ~ModelGame() override;
+
+    CFrame GetPivot() const override;
+    void   PivotTo(const CFrame& target) override;
+
+    // descendant parts in tree order
+    void GetParts(std::vector<BasePart*>& out) const;
+
+    void RemapReferences(const CloneMap& m) override;
+    bool LuaGet(lua_State* L, const char* key) const override;
+    bool LuaSet(lua_State* L, const char* key, int valueIndex) override;
+};
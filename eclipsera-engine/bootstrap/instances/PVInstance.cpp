@@ -0,0 +1,29 @@
+#include "bootstrap/instances/PVInstance.h"
+#include "core/datatypes/LuaDatatypes.h"
+#include "lua.h"
+#include "lualib.h"
+#include <cstring>
+
+static PVInstance* checkSelf(lua_State* L) {
+    auto* p = static_cast<std::shared_ptr<Instance>*>(luaL_checkudata(L, 1, "Librebox.Instance"));
+    auto* pv = (p && *p) ? dynamic_cast<PVInstance*>(p->get()) : nullptr;
+    if (!pv) luaL_error(L, "expected a Model or BasePart");
+    return pv;
+}
+
+static int l_pv_getpivot(lua_State* L) {
+    lb::push(L, checkSelf(L)->GetPivot());
+    return 1;
+}
+
+static int l_pv_pivotto(lua_State* L) {
+    PVInstance* self = checkSelf(L);
+    self->PivotTo(*lb::check<CFrame>(L, 2));
+    return 0;
+}
+
+bool PVInstance::LuaGet(lua_State* L, const char* key) const {
+    if (std::strcmp(key, "GetPivot") == 0) { lua_pushcfunction(L, l_pv_getpivot, "GetPivot"); return true; }
+    if (std::strcmp(key, "PivotTo") == 0)  { lua_pushcfunction(L, l_pv_pivotto,  "PivotTo");  return true; }
+    return false;
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include "bootstrap/Instance.h"
+#include "core/datatypes/CFrame.h"
+
+// Anything with a pivot: parts and models. GetPivot / PivotTo are exposed to
+// Lua here; PivotTo moves the instance so its pivot lands on the target.
+struct PVInstance : Instance {
+    PVInstance(std::string name, InstanceClass cls) : Instance(std::move(name), cls) {}
+
+    virtual CFrame GetPivot() const = 0;
+    virtual void   PivotTo(const CFrame& target) = 0;
+
+    bool LuaGet(lua_State* L, const char* key) const override;
+};
@@ -0,0 +1,74 @@
+#include "bootstrap/instances/WeldConstraint.h"
+#include "bootstrap/Assemblies.h"
+#include "bootstrap/ScriptingAPI.h"
+#include "bootstrap/instances/BasePart.h"
+#include "core/datatypes/LuaDatatypes.h"
+#include "lua.h"
+#include "lualib.h"
+#include <cstring>
+
+WeldConstraint::WeldConstraint(std::string name)
+    : Instance(std::move(name), InstanceClass::WeldConstraint) {
+    Assemblies::Get().AddWeld(this);
+}
+
+WeldConstraint::~WeldConstraint() {
+    Assemblies::Get().RemoveWeld(this);
+}
+
+bool WeldConstraint::Active() const {
+    if (!Enabled || !Alive) return false;
+    const auto a = Part0.lock(), b = Part1.lock();
+    return a && b && a != b && a->Alive && b->Alive;
+}
+
+void WeldConstraint::Destroy() {
+    Instance::Destroy();
+    Assemblies::Get().MarkDirty();
+}
+
+void WeldConstraint::RemapReferences(const CloneMap& m) {
+    Part0 = RemapWeak(m, Part0);
+    Part1 = RemapWeak(m, Part1);
+    Assemblies::NoteWelded(Part0.lock().get());
+    Assemblies::NoteWelded(Part1.lock().get());
+    Assemblies::Get().MarkDirty();
+}
+
+bool WeldConstraint::LuaGet(lua_State* L, const char* key) const {
+    if (std::strcmp(key, "Part0") == 0)   { Lua_PushInstance(L, Part0.lock()); return true; }
+    if (std::strcmp(key, "Part1") == 0)   { Lua_PushInstance(L, Part1.lock()); return true; }
+    if (std::strcmp(key, "Enabled") == 0) { lua_pushboolean(L, Enabled);      return true; }
+    if (std::strcmp(key, "Active") == 0)  { lua_pushboolean(L, Active());     return true; }
+    return false;
+}
+
+// nil, or a part
+static std::shared_ptr<BasePart> checkPartOrNil(lua_State* L, int idx, const char* key) {
+    if (lua_isnil(L, idx)) return nullptr;
+    auto* p = static_cast<std::shared_ptr<Instance>*>(lb::luaL_testudata(L, idx, "Librebox.Instance"));
+    auto part = p ? std::dynamic_pointer_cast<BasePart>(*p) : nullptr;
+    if (!part) luaL_error(L, "%s must be a BasePart or nil", key);
+    return part;
+}
+
+bool WeldConstraint::LuaSet(lua_State* L, const char* key, int valueIndex) {
+    const bool part0 = std::strcmp(key, "Part0") == 0;
+    if (part0 || std::strcmp(key, "Part1") == 0) {
+        auto part = checkPartOrNil(L, valueIndex, key);
+        Assemblies::NoteWelded(part.get());
+        (part0 ? Part0 : Part1) = part;
+        Assemblies::Get().MarkDirty();
+        return true;
+    }
+    if (std::strcmp(key, "Enabled") == 0) {
+        const bool enabled = lua_toboolean(L, valueIndex);
+        if (enabled != Enabled) { Enabled = enabled; Assemblies::Get().MarkDirty(); }
+        return true;
+    }
+    return false;
+}
+
+static Instance::Registrar _reg_weld("WeldConstraint", [] {
+    return std::make_shared<WeldConstraint>("WeldConstraint");
+});
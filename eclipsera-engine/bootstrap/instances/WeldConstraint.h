@@ -0,0 +1,34 @@
+#pragma once
+#include "bootstrap/Instance.h"
+
+struct BasePart;
+
+// Holds Part0 and Part1 rigidly together while Enabled. Welded parts form
+// assemblies (see Assemblies.h) that move as one, both when a script sets a
+// member's CFrame and in the physics simulation. The offset between the parts
+// is taken when the weld becomes active; setting a member's Position or
+// Orientation moves that part alone and takes a new offset.
+struct WeldConstraint : Instance {
+    std::weak_ptr<BasePart> Part0, Part1;
+    bool Enabled{true};
+
+    // Our index in the Assemblies weld list; Clone does not copy it.
+    struct Registration {
+        uint32_t index{0xFFFFFFFFu};
+        Registration() = default;
+        Registration(const Registration&) {}
+        Registration& operator=(const Registration&) { return *this; }
+    };
+    Registration Reg;
+
+    explicit WeldConstraint(std::string name = "WeldConstraint");
+    ~WeldConstraint() override;
+
+    // Enabled, with two different live parts.
+    bool Active() const;
+
+    void Destroy() override;
+    void RemapReferences(const CloneMap& m) override;
+    bool LuaGet(lua_State* L, const char* key) const override;
+    bool LuaSet(lua_State* L, const char* key, int valueIndex) override;
+};
@@ -1,7 +1,10 @@
 #include "bootstrap/instances/Workspace.h"
 #include "bootstrap/instances/Part.h"
 #include "bootstrap/instances/CameraGame.h"
+#include "bootstrap/QueryParams.h"
+#include "lua.h"
 #include <algorithm>
+#include <cstring>
 
 Workspace::Workspace(std::string name)
     : Service(std::move(name), InstanceClass::Workspace) {
@@ -23,6 +26,15 @@ Workspace::Workspace(std::string name)
 }
 Workspace::~Workspace() = default;
 
+bool Workspace::LuaGet(lua_State* L, const char* key) const {
+    if (std::strcmp(key, "Raycast") == 0)     { lua_pushcfunction(L, Lua_WorkspaceRaycast, "Raycast"); return true; }
+    if (std::strcmp(key, "RaycastMany") == 0) { lua_pushcfunction(L, Lua_WorkspaceRaycastMany, "RaycastMany"); return true; }
+    if (std::strcmp(key, "GetPartBoundsInBox") == 0)    { lua_pushcfunction(L, Lua_WorkspaceGetPartBoundsInBox, "GetPartBoundsInBox"); return true; }
+    if (std::strcmp(key, "GetPartBoundsInRadius") == 0) { lua_pushcfunction(L, Lua_WorkspaceGetPartBoundsInRadius, "GetPartBoundsInRadius"); return true; }
+    if (std::strcmp(key, "GetPartsInPart") == 0)        { lua_pushcfunction(L, Lua_WorkspaceGetPartsInPart, "GetPartsInPart"); return true; }
+    return false;
+}
+
 static Instance::Registrar _reg_ws("Workspace", []{
     return std::make_shared<Workspace>("Workspace");
 });
\ No newline at end of file
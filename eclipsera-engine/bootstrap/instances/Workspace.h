@@ -12,4 +12,7 @@ struct Workspace : Service {
 
     explicit Workspace(std::string name = "Workspace");
     ~Workspace() override;
+
+    // Raycast and the overlap queries (see QueryParams.h)
+    bool LuaGet(lua_State* L, const char* key) const override;
 };
\ No newline at end of file
@@ -1,14 +1,20 @@
 #include <raylib.h>
 #include "Renderer.h"
+#include "bootstrap/ChangeJournal.h"
 #include "raymath.h"
 #include "Game.h"
 #include "bootstrap/instances/Script.h"
 #include "core/logging/Logging.h"
+#include "core/runtime/Time.h"
 #include "subsystems/filesystem/FileSystem.h"
+#include "subsystems/input/CursorRaycaster.h"
+#include "subsystems/physics/PhysicsSync.h"
+#include "subsystems/physics/PhysicsWorld.h"
 #include "instances/InstanceTypes.h"
 #include "services/RunService.h"
 #include "services/Lighting.h"
 #include "bootstrap/services/UserInputService.h"
+#include <csignal>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
@@ -19,6 +25,7 @@
 #include "place_file.h"
 #include "preloaded_scripts.h"
 
+#ifdef _WIN32
 // avoid Win32 name collisions
 #define WIN32_LEAN_AND_MEAN
 #define CloseWindow Win32CloseWindow
@@ -27,6 +34,7 @@
 #undef DrawText
 #undef CloseWindow
 #undef ShowCursor
+#endif
 
 static Camera3D g_camera{};
 
@@ -37,10 +45,83 @@ static bool gAnglesInit = false;
 static int gTargetFPS = 0;
 static std::vector<std::string> gPaths;
 static bool gNoPlace = false;
+static bool gPipelinedRender = false;
 static bool args = false;
+static double gPhysicsRate = SimulationClock::kDefaultRate;
+static double gFastSimSeconds = 0.0;  // > 0: simulate this long without rendering, then exit
+static bool gHeadless = false;        // no window, GPU or input; ticks at gTickRate
+static double gTickRate = 60.0;       // headless ticks per second; 0 runs them back to back
+static volatile std::sig_atomic_t gStopRequested = 0;
+static double gTouchDispatchMs = 0.0; // Touched / TouchEnded delivery, summed over the steps
+static uint64_t gTouchSignals = 0;
 
-static void PhysicsSimulation() {
-    // stub
+// --headless and --fast-sim open no window and read no input.
+static bool Headless() { return gHeadless || gFastSimSeconds > 0.0; }
+
+static void RequestStop(int) { gStopRequested = 1; }
+
+static void PhysicsSimulation(double dt) {
+    PhysicsWorld::Get().Step(g_game ? g_game->workspace : nullptr, dt);
+}
+
+// One fixed physics step between RunService.PreSimulation and PostSimulation;
+// the step's touch events are delivered right after it.
+static void SimulationStep(RunService* rs, lua_State* L, double time, double dt) {
+    if (rs && L && rs->PreSimulation && !rs->PreSimulation->IsClosed()) {
+        lua_pushnumber(L, time);
+        lua_pushnumber(L, dt);
+        rs->PreSimulation->Fire(L, lua_gettop(L)-1, 2);
+        lua_pop(L, 2);
+    }
+
+    PhysicsSimulation(dt);
+
+    const double t0 = timing::Now();
+    gTouchSignals += DispatchTouchEvents(L);
+    gTouchDispatchMs += (timing::Now() - t0) * 1000.0;
+
+    if (rs && L && rs->PostSimulation && !rs->PostSimulation->IsClosed()) {
+        lua_pushnumber(L, dt);
+        rs->PostSimulation->Fire(L, lua_gettop(L), 1);
+        lua_pop(L, 1);
+    }
+}
+
+// Everything in a frame but input and drawing: PreRender (when drawing),
+// PreAnimation, the physics steps the frame's time covers, Heartbeat and the
+// scripts. Shared by the windowed and headless loops.
+static void SimulationFrame(RunService* rs, double dt, bool rendering) {
+    SimulationClock& clock = PhysicsWorld::Get().Clock();
+
+    lua_State* Lm = (g_game && g_game->luaScheduler) ? g_game->luaScheduler->GetMainState() : nullptr;
+    if (rs && Lm) {
+        rs->EnsureSignals();
+        if (rendering && rs->PreRender && !rs->PreRender->IsClosed()) {
+            lua_pushnumber(Lm, dt);
+            rs->PreRender->Fire(Lm, lua_gettop(Lm), 1);
+            lua_pop(Lm, 1);
+        }
+        if (rs->PreAnimation && !rs->PreAnimation->IsClosed()) {
+            lua_pushnumber(Lm, dt);
+            rs->PreAnimation->Fire(Lm, lua_gettop(Lm), 1);
+            lua_pop(Lm, 1);
+        }
+    }
+
+    // physics runs at the clock's fixed rate, however long the frame was
+    const int steps = clock.Advance(dt);
+    for (int i = 0; i < steps; ++i)
+        SimulationStep(rs, Lm, clock.Time() - (steps - 1 - i) * clock.StepSize(), clock.StepSize());
+
+    if (rs && Lm) {
+        if (rs->Heartbeat && !rs->Heartbeat->IsClosed()) {
+            lua_pushnumber(Lm, dt);
+            rs->Heartbeat->Fire(Lm, lua_gettop(Lm), 1);
+            lua_pop(Lm, 1);
+        }
+    }
+    if (g_game && g_game->luaScheduler)
+        g_game->luaScheduler->Step(timing::Now(), dt);
 }
 
 static void Cleanup();
@@ -104,7 +185,7 @@ static int LoaderMenu(int padding = 38, int gap = 10,
 }
 
 static void Stage_ConfigInitialization() {
-    SetConfigFlags(FLAG_MSAA_4X_HINT | FLAG_WINDOW_RESIZABLE | FLAG_VSYNC_HINT);
+    if (!Headless()) SetConfigFlags(FLAG_MSAA_4X_HINT | FLAG_WINDOW_RESIZABLE | FLAG_VSYNC_HINT);
     std::atexit(&Cleanup);
     LOGI("Loaded configuration");
 }
@@ -138,40 +219,43 @@ static bool Preflight_ValidatePaths() {
 static void Stage_Initialization() {
     LOGI("Stage: Initialization begin");
 
-    InitWindow(1280, 720, "ECLIPSERA ENGINE (LunarEngine 1.0.0 modified)");
+    int selected = 0;
 
-    // setup icons
-    Image icon = {
-        .data = icon_data,
-        .width = icon_data_width,
-        .height = icon_data_height,
-        .mipmaps = 1,
-        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
-    };
+    if (!Headless()) {
+        InitWindow(1280, 720, "ECLIPSERA ENGINE (LunarEngine 1.0.0 modified)");
 
-    SetWindowIcon(icon);
-    HICON hIcon = CreateIconFromResourceEx(
-        (PBYTE)icon_ico,
-        (DWORD)icon_ico_len,
-        TRUE,
-        0x00030000,
-        0, 0,
-        LR_DEFAULTCOLOR
-    );
-
-    if (hIcon) {
-        HWND hwnd = GetActiveWindow();
-        SendMessage(hwnd, WM_SETICON, ICON_BIG, (LPARAM)hIcon);
-        SendMessage(hwnd, WM_SETICON, ICON_SMALL, (LPARAM)hIcon);
-    }
+        // setup icons
+        Image icon = {
+            .data = icon_data,
+            .width = icon_data_width,
+            .height = icon_data_height,
+            .mipmaps = 1,
+            .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+        };
 
+        SetWindowIcon(icon);
+#ifdef _WIN32
+        HICON hIcon = CreateIconFromResourceEx(
+            (PBYTE)icon_ico,
+            (DWORD)icon_ico_len,
+            TRUE,
+            0x00030000,
+            0, 0,
+            LR_DEFAULTCOLOR
+        );
+
+        if (hIcon) {
+            HWND hwnd = GetActiveWindow();
+            SendMessage(hwnd, WM_SETICON, ICON_BIG, (LPARAM)hIcon);
+            SendMessage(hwnd, WM_SETICON, ICON_SMALL, (LPARAM)hIcon);
+        }
+#endif
 
-    LOGI("Raylib window initialized");
+        LOGI("Raylib window initialized");
 
-    int selected = 0;
-    
-    if (!args) {
-        selected = LoaderMenu();
+        if (!args) {
+            selected = LoaderMenu();
+        }
     }
 
     g_game = std::make_shared<Game>();
@@ -259,45 +343,13 @@ static void Stage_Run() {
     auto rs = std::dynamic_pointer_cast<RunService>(Service::Get("RunService"));
     auto ls = std::dynamic_pointer_cast<Lighting>(Service::Get("Lighting"));
 
+    double last = timing::Now();
     while (!WindowShouldClose()) {
-        const double now = GetTime();
-        const double dt  = GetFrameTime();
+        const double now = timing::Now();
+        const double dt  = now - last;
+        last = now;
 
-        lua_State* Lm = (g_game && g_game->luaScheduler) ? g_game->luaScheduler->GetMainState() : nullptr;
-        if (rs && Lm) {
-            rs->EnsureSignals();
-            if (rs->PreRender && !rs->PreRender->IsClosed()) {
-                lua_pushnumber(Lm, dt);
-                rs->PreRender->Fire(Lm, lua_gettop(Lm), 1);
-                lua_pop(Lm, 1);
-            }
-            if (rs->PreAnimation && !rs->PreAnimation->IsClosed()) {
-                lua_pushnumber(Lm, dt);
-                rs->PreAnimation->Fire(Lm, lua_gettop(Lm), 1);
-                lua_pop(Lm, 1);
-            }
-            if (rs->PreSimulation && !rs->PreSimulation->IsClosed()) {
-                lua_pushnumber(Lm, now);
-                lua_pushnumber(Lm, dt);
-                rs->PreSimulation->Fire(Lm, lua_gettop(Lm)-1, 2);
-                lua_pop(Lm, 2);
-            }
-
-            PhysicsSimulation();
-
-            if (rs->PostSimulation && !rs->PostSimulation->IsClosed()) {
-                lua_pushnumber(Lm, dt);
-                rs->PostSimulation->Fire(Lm, lua_gettop(Lm), 1);
-                lua_pop(Lm, 1);
-            }
-            if (rs->Heartbeat && !rs->Heartbeat->IsClosed()) {
-                lua_pushnumber(Lm, dt);
-                rs->Heartbeat->Fire(Lm, lua_gettop(Lm), 1);
-                lua_pop(Lm, 1);
-            }
-        }
-        if (g_game && g_game->luaScheduler)
-            g_game->luaScheduler->Step(GetTime(), dt);
+        SimulationFrame(rs.get(), dt, true);
 
         // Update UserInputService
         // IM ABOUT TO ROTTING AITHGSFODJgmarzsfoidlkzgj;,rsdfplgl;jars.kzf/dkgpksdzl LET ME fUCKING SLEEEP ALREADY
@@ -341,20 +393,113 @@ static void Stage_Run() {
         g_camera.position = Vector3Add(g_camera.position, delta);
         g_camera.target   = Vector3Add(g_camera.position, forward);
         g_camera.up       = up;
+        CursorRaycaster::Get().SetView(g_camera, GetScreenWidth(), GetScreenHeight());
 
         RenderFrame(g_camera);
+
+        // every consumer has read this frame's changes
+        ChangeJournal::Get().EndFrame();
     }
+    FlushRenderPipeline();
 
     LOGI("Stage: Run loop end");
 }
 
+// Server loop: scripts, signals and physics at gTickRate on the monotonic
+// clock, with no window, GPU or input, until SIGINT or SIGTERM. A tick that
+// overruns its period starts the next one at once instead of queueing more;
+// physics still covers the lost time on its own fixed-step clock.
+static void Stage_Headless() {
+    if (gTickRate > 0.0) LOGI("Stage: Headless run at %.0f ticks/s begin", gTickRate);
+    else                 LOGI("Stage: Headless run, unpaced, begin");
+    auto rs = std::dynamic_pointer_cast<RunService>(Service::Get("RunService"));
+    const double period = gTickRate > 0.0 ? 1.0 / gTickRate : 0.0;
+
+    const double t0 = timing::Now();
+    double last = t0, next = t0, busy = 0.0;
+    uint64_t ticks = 0, overruns = 0;
+    while (!gStopRequested) {
+        timing::SleepUntil(next);
+        const double now = timing::Now();
+        SimulationFrame(rs.get(), now - last, false);
+        ChangeJournal::Get().EndFrame();
+        last = now;
+        ++ticks;
+
+        const double done = timing::Now();
+        busy += done - now;
+        next += period;
+        if (period > 0.0 && done > next) { ++overruns; next = done; }
+    }
+
+    const double wall = timing::Now() - t0;
+    LOGI("Ran %llu ticks in %.2f s (%.1f per second), %.3f ms per tick, %llu overran",
+         (unsigned long long)ticks, wall, wall > 0.0 ? ticks / wall : 0.0,
+         ticks ? busy * 1000.0 / (double)ticks : 0.0, (unsigned long long)overruns);
+    LOGI("Stage: Headless run end");
+}
+
+// Headless benchmark: step the simulation back to back for gFastSimSeconds of
+// simulated time, with Heartbeat and scripts once per step and no rendering.
+static void Stage_FastSimulation() {
+    LOGI("Stage: Fast simulation of %.1f s at %.0f Hz begin", gFastSimSeconds, gPhysicsRate);
+    auto rs = std::dynamic_pointer_cast<RunService>(Service::Get("RunService"));
+    PhysicsWorld& physics = PhysicsWorld::Get();
+    SimulationClock& clock = physics.Clock();
+    const double step = clock.StepSize();
+
+    const double t0 = timing::Now();
+    double physicsMs = 0.0, collisionMs = 0.0;
+    uint64_t pairsFound = 0, pairsFiltered = 0;
+    while (clock.Time() < gFastSimSeconds && !gStopRequested) {
+        clock.Advance(step);
+        lua_State* Lm = (g_game && g_game->luaScheduler) ? g_game->luaScheduler->GetMainState() : nullptr;
+        if (rs && Lm) rs->EnsureSignals();
+
+        const double s0 = timing::Now();
+        SimulationStep(rs.get(), Lm, clock.Time(), step);
+        physicsMs += (timing::Now() - s0) * 1000.0;
+        const PhysicsWorld::Stats& ps = physics.GetStats();
+        collisionMs += ps.broadphaseMs + ps.narrowphaseMs;
+        pairsFound += ps.pairsFound;
+        pairsFiltered += ps.pairsFiltered;
+
+        if (rs && Lm && rs->Heartbeat && !rs->Heartbeat->IsClosed()) {
+            lua_pushnumber(Lm, step);
+            rs->Heartbeat->Fire(Lm, lua_gettop(Lm), 1);
+            lua_pop(Lm, 1);
+        }
+        if (g_game && g_game->luaScheduler)
+            g_game->luaScheduler->Step(timing::Now(), step);
+        ChangeJournal::Get().EndFrame();
+    }
+
+    const double wall = timing::Now() - t0;
+    const PhysicsWorld::Stats& st = physics.GetStats();
+    LOGI("Simulated %.2f s in %.2f s (%.1fx real time): %llu steps, %.3f ms per step with signals",
+         clock.Time(), wall, wall > 0.0 ? clock.Time() / wall : 0.0,
+         (unsigned long long)clock.Steps(), clock.Steps() ? physicsMs / (double)clock.Steps() : 0.0);
+    LOGI("Last step: %u bodies, %u awake, %u islands, %u contacts",
+         st.bodies, st.awakeBodies, st.islands, st.contacts);
+    LOGI("Collision: %llu candidate pairs found, %llu dropped by collision group; %.3f ms per step in broadphase and narrowphase",
+         (unsigned long long)pairsFound, (unsigned long long)pairsFiltered,
+         clock.Steps() ? collisionMs / (double)clock.Steps() : 0.0);
+    LOGI("Touches: %u touching pairs, %u events, %.3f ms to diff in the last step; %llu signals fired, %.3f ms per step to deliver",
+         st.touchingPairs, st.touchEvents, st.touchMs, (unsigned long long)gTouchSignals,
+         clock.Steps() ? gTouchDispatchMs / (double)clock.Steps() : 0.0);
+    // equal hashes across runs of the same scene mean the runs were identical
+    LOGI("State hash: %016llx", (unsigned long long)physics.StateHash());
+    LOGI("Stage: Fast simulation end");
+}
+
 static void Cleanup() {
     LOGI("Cleanup begin");
+    PhysicsWorld::Get().Reset();
     if (g_game) {
         g_game->Shutdown();
         g_game.reset();
     }
-    CloseWindow();
+    if (!Headless()) CloseWindow();
     LOGI("Cleanup end");
 }
 
@@ -367,6 +512,18 @@ int main(int argc, char** argv) {
             args = true;
         } else if (std::strcmp(argv[i], "--no-place") == 0) {
             gNoPlace = true;
+        } else if (std::strcmp(argv[i], "--pipelined-render") == 0) {
+            gPipelinedRender = true;
+        } else if (std::strcmp(argv[i], "--physics-rate") == 0 && i + 1 < argc) {
+            gPhysicsRate = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--fast-sim") == 0 && i + 1 < argc) {
+            gFastSimSeconds = std::atof(argv[++i]);
+            args = true; // no loader menu
+        } else if (std::strcmp(argv[i], "--headless") == 0) {
+            gHeadless = true;
+            args = true;
+        } else if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            gTickRate = std::atof(argv[++i]);
         } else if (i == 1) {
             // first non-flag argument
             std::string arg = argv[i];
@@ -379,6 +536,12 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (gPhysicsRate > 0.0) PhysicsWorld::Get().Clock().SetRate(gPhysicsRate);
+    if (Headless()) {
+        UserInputService::SetNullInput(true);
+        std::signal(SIGINT, RequestStop);
+        std::signal(SIGTERM, RequestStop);
+    }
     Stage_ConfigInitialization();
 
     if (!Preflight_ValidatePaths()) {
@@ -386,18 +549,29 @@ int main(int argc, char** argv) {
     }
 
     LOGI("-----------------------------");
-    LOGI("ECLIPSERA ENGINE (Client)");
+    LOGI("ECLIPSERA ENGINE (%s)", Headless() ? "Headless" : "Client");
     LOGI("License: MIT license");
     LOGI("Author: LunarEngine Developers, NickiBreeki (modification)");
     LOGI("-----------------------------");
 
     Stage_Initialization();
 
-    if (gTargetFPS > 0) {
+    if (gTargetFPS > 0 && !Headless()) {
         SetTargetFPS(gTargetFPS);
         LOGI("Target FPS set to %d", gTargetFPS);
     }
 
+    if (gFastSimSeconds > 0.0) {
+        Stage_FastSimulation();
+        return 0;
+    }
+    if (gHeadless) {
+        Stage_Headless();
+        return 0;
+    }
+
+    if (gPipelinedRender) SetRenderPipelineMode(RenderPipelineMode::Pipelined);
+
     Stage_Run();
     return 0;
 }
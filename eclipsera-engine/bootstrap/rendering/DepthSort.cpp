@@ -0,0 +1,50 @@
+#include "bootstrap/rendering/DepthSort.h"
+#include <algorithm>
+#include <cmath>
+
+// element moves per item the insertion pass may spend before switching to radix
+static constexpr size_t kInsertionMovesPerItem = 2;
+
+uint16_t QuantizeDepth(float dist2, float maxDist2) {
+    if (!(dist2 > 0.0f)) return 0;
+    const float t = std::sqrt(std::sqrt(std::min(dist2 / maxDist2, 1.0f)));
+    return (uint16_t)(t * 65535.0f + 0.5f);
+}
+
+// stable LSD radix on the inverted key, two 8-bit digits
+static void radixSort(std::vector<DepthItem>& items, std::vector<DepthItem>& scratch) {
+    const size_t n = items.size();
+    uint32_t lo[257] = {0}, hi[257] = {0};
+    for (const DepthItem& it : items) {
+        const uint16_t k = (uint16_t)~it.key;
+        ++lo[(k & 0xFF) + 1];
+        ++hi[(k >> 8) + 1];
+    }
+    for (int i = 0; i < 256; ++i) { lo[i + 1] += lo[i]; hi[i + 1] += hi[i]; }
+
+    scratch.resize(n);
+    for (const DepthItem& it : items) scratch[lo[(uint16_t)~it.key & 0xFF]++] = it;
+    for (const DepthItem& it : scratch) items[hi[(uint16_t)~it.key >> 8]++] = it;
+}
+
+DepthSortKind SortBackToFront(std::vector<DepthItem>& items, std::vector<DepthItem>& scratch) {
+    const size_t n = items.size();
+    if (n < 2) return DepthSortKind::None;
+
+    size_t i = 1;
+    while (i < n && items[i - 1].key >= items[i].key) ++i;
+    if (i == n) return DepthSortKind::None;
+
+    size_t budget = n * kInsertionMovesPerItem;
+    for (; i < n; ++i) {
+        const DepthItem x = items[i];
+        size_t j = i;
+        while (j > 0 && items[j - 1].key < x.key) {
+            items[j] = items[j - 1];
+            --j;
+            if (--budget == 0) { items[j] = x; radixSort(items, scratch); return DepthSortKind::Radix; }
+        }
+        items[j] = x;
+    }
+    return DepthSortKind::Insertion;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Back-to-front ordering for transparent draws on a 16-bit depth key.
+struct DepthItem {
+    uint32_t slot;   // proxy slot
+    uint16_t key;    // QuantizeDepth(); larger is farther
+};
+
+enum class DepthSortKind : uint8_t { None, Insertion, Radix };
+
+// Map squared camera distance to a key with finer steps near the camera
+// (fourth root of dist2 / maxDist2); distances past maxDist2 clamp.
+uint16_t QuantizeDepth(float dist2, float maxDist2);
+
+// Sort far to near. Equal keys keep their input order. Fed last frame's
+// order, a nearly sorted list finishes with a bounded insertion sort; once
+// that runs over budget, two 8-bit radix passes finish the job.
+// 'scratch' is reused between calls. Returns the path taken.
+DepthSortKind SortBackToFront(std::vector<DepthItem>& items, std::vector<DepthItem>& scratch);
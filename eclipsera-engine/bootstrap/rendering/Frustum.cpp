@@ -0,0 +1,114 @@
+#include "bootstrap/rendering/Frustum.h"
+#include <raymath.h>
+#include <cmath>
+
+#ifdef ECLIPSERA_SSE2
+#include <emmintrin.h>
+#endif
+
+static constexpr float kNeverVisible = -1e30f;
+
+// -------- Frustum --------
+Frustum Frustum::FromCamera(const Camera3D& cam, float aspect, float nearD, float farD) {
+    const Vector3 c = cam.position;
+    const Vector3 f = Vector3Normalize(Vector3Subtract(cam.target, c));
+    Vector3 r = Vector3CrossProduct(f, cam.up);
+    if (Vector3LengthSqr(r) < 1e-12f) r = Vector3{1.0f, 0.0f, 0.0f};
+    r = Vector3Normalize(r);
+    const Vector3 u = Vector3CrossProduct(r, f);
+
+    const float tanV = tanf(cam.fovy * DEG2RAD * 0.5f);
+    const float tanH = tanV * aspect;
+
+    Frustum out{};
+    auto set = [&](int i, Vector3 n, float d) {
+        const float len = Vector3Length(n);
+        out.nx[i] = n.x / len; out.ny[i] = n.y / len; out.nz[i] = n.z / len; out.d[i] = d / len;
+    };
+    // side planes pass through the eye: d = -n.c
+    auto side = [&](int i, Vector3 n) { set(i, n, -Vector3DotProduct(n, c)); };
+    side(0, Vector3Add(Vector3Scale(f, tanH), r));        // left
+    side(1, Vector3Subtract(Vector3Scale(f, tanH), r));   // right
+    side(2, Vector3Add(Vector3Scale(f, tanV), u));        // bottom
+    side(3, Vector3Subtract(Vector3Scale(f, tanV), u));   // top
+    set(4, f, -Vector3DotProduct(f, c) - nearD);          // near
+    set(5, Vector3Negate(f), Vector3DotProduct(f, c) + farD); // far
+    return out;
+}
+
+// -------- PackedBounds --------
+void PackedBounds::Set(size_t i, Vector3 c, Vector3 e) {
+    cx[i] = c.x; cy[i] = c.y; cz[i] = c.z;
+    ex[i] = e.x; ey[i] = e.y; ez[i] = e.z;
+}
+
+void PackedBounds::Clear(size_t i) {
+    cx[i] = cy[i] = cz[i] = 0.0f;
+    ex[i] = ey[i] = ez[i] = kNeverVisible;
+}
+
+void PackedBounds::Move(size_t dst, size_t src) {
+    cx[dst] = cx[src]; cy[dst] = cy[src]; cz[dst] = cz[src];
+    ex[dst] = ex[src]; ey[dst] = ey[src]; ez[dst] = ez[src];
+}
+
+void PackedBounds::Reserve(size_t count) {
+    const size_t want = (count + kCullLanes - 1) / kCullLanes * kCullLanes;
+    size_t n = cx.size();
+    if (want <= n) return;
+    cx.resize(want); cy.resize(want); cz.resize(want);
+    ex.resize(want); ey.resize(want); ez.resize(want);
+    for (; n < want; ++n) Clear(n);
+}
+
+// -------- culling --------
+void CullBounds(const Frustum& f, const PackedBounds& b, size_t first, size_t last, std::vector<uint32_t>& visible) {
+    const size_t blocks = (last + PackedBounds::kCullLanes - 1) / PackedBounds::kCullLanes;
+#ifdef ECLIPSERA_SSE2
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 pnx[6], pny[6], pnz[6], pax[6], pay[6], paz[6], pd[6];
+    for (int p = 0; p < 6; ++p) {
+        pnx[p] = _mm_set1_ps(f.nx[p]); pny[p] = _mm_set1_ps(f.ny[p]); pnz[p] = _mm_set1_ps(f.nz[p]);
+        pax[p] = _mm_andnot_ps(signMask, pnx[p]);
+        pay[p] = _mm_andnot_ps(signMask, pny[p]);
+        paz[p] = _mm_andnot_ps(signMask, pnz[p]);
+        pd[p]  = _mm_set1_ps(f.d[p]);
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    for (size_t blk = first / PackedBounds::kCullLanes; blk < blocks; ++blk) {
+        const size_t i = blk * PackedBounds::kCullLanes;
+        const __m128 cx = _mm_loadu_ps(&b.cx[i]), cy = _mm_loadu_ps(&b.cy[i]), cz = _mm_loadu_ps(&b.cz[i]);
+        const __m128 ex = _mm_loadu_ps(&b.ex[i]), ey = _mm_loadu_ps(&b.ey[i]), ez = _mm_loadu_ps(&b.ez[i]);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p) {
+            // signed distance of the center plus the box's projected radius onto n
+            __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pnx[p], cx), _mm_mul_ps(pny[p], cy)),
+                                     _mm_add_ps(_mm_mul_ps(pnz[p], cz), pd[p]));
+            __m128 rad  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pax[p], ex), _mm_mul_ps(pay[p], ey)),
+                                     _mm_mul_ps(paz[p], ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, rad), zero));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        while (mask) {
+            const int lane = mask & -mask;
+            const size_t idx = i + (size_t)(lane == 1 ? 0 : lane == 2 ? 1 : lane == 4 ? 2 : 3);
+            if (idx < last) visible.push_back((uint32_t)idx);
+            mask &= mask - 1;
+        }
+    }
+#else
+    const size_t n = blocks * PackedBounds::kCullLanes;
+    for (size_t i = first; i < n && i < last; ++i) {
+        bool in = true;
+        for (int p = 0; p < 6 && in; ++p) {
+            const float dist = f.nx[p]*b.cx[i] + f.ny[p]*b.cy[i] + f.nz[p]*b.cz[i] + f.d[p];
+            const float rad  = fabsf(f.nx[p])*b.ex[i] + fabsf(f.ny[p])*b.ey[i] + fabsf(f.nz[p])*b.ez[i];
+            in = dist + rad >= 0.0f;
+        }
+        if (in) visible.push_back((uint32_t)i);
+    }
+#endif
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <raylib.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// SSE2 is baseline on x64; other targets take the scalar path.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ECLIPSERA_SSE2 1
+#endif
+
+// Six inward-facing planes (n.p + d >= 0 inside), stored SoA for the batch test.
+struct Frustum {
+    float nx[6], ny[6], nz[6], d[6];
+
+    static Frustum FromCamera(const Camera3D& cam, float aspect, float nearD, float farD);
+};
+
+// World-space AABBs (center + half extents), SoA and padded to a multiple of
+// kCullLanes with entries that never pass the test.
+struct PackedBounds {
+    static constexpr size_t kCullLanes = 4;
+
+    std::vector<float> cx, cy, cz, ex, ey, ez;
+
+    size_t Padded() const { return cx.size(); }
+    void Set(size_t i, Vector3 c, Vector3 e);
+    void Clear(size_t i);          // make slot i fail every test
+    void Move(size_t dst, size_t src);
+    void Reserve(size_t count);    // grow to hold 'count' entries, padding with cleared slots
+    void Reset() { cx.clear(); cy.clear(); cz.clear(); ex.clear(); ey.clear(); ez.clear(); }
+};
+
+// Appends the indices in [first, last) of every box intersecting the frustum to
+// 'visible', ascending. 'first' must be a multiple of kCullLanes so ranges can be
+// culled on separate threads.
+void CullBounds(const Frustum& f, const PackedBounds& b, size_t first, size_t last, std::vector<uint32_t>& visible);
@@ -0,0 +1,39 @@
+#include "bootstrap/rendering/InstanceBuffer.h"
+#include <algorithm>
+
+// ranges closer than this are uploaded as one
+static constexpr uint32_t kCoalesceGap = 8;
+
+size_t InstanceBuffer::EmitUploads(RenderCommandList& list, uint8_t buffer) {
+    const size_t n = cpu.size();
+    if (n == 0) { dirty.clear(); return 0; }
+
+    if (list.Reserve(buffer, n, capacity)) allDirty = true;
+
+    // past a quarter of the array one upload beats many small ones
+    if (!allDirty && dirty.size() * 4 > n) allDirty = true;
+
+    size_t bytes = 0;
+    if (allDirty) {
+        bytes = list.Upload(buffer, 0, cpu.data(), n);
+    } else if (!dirty.empty()) {
+        std::sort(dirty.begin(), dirty.end());
+        size_t i = 0;
+        while (i < dirty.size()) {
+            uint32_t first = dirty[i], last = first;
+            while (++i < dirty.size() && dirty[i] <= last + kCoalesceGap) last = std::max(last, dirty[i]);
+            if (first >= n) break;
+            last = std::min<uint32_t>(last, (uint32_t)n - 1);
+            bytes += list.Upload(buffer, first, &cpu[first], last - first + 1);
+        }
+    }
+    dirty.clear();
+    allDirty = false;
+    return bytes;
+}
+
+void InstanceBuffer::Invalidate() {
+    capacity = 0;
+    dirty.clear();
+    allDirty = true;
+}
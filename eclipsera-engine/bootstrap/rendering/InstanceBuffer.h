@@ -0,0 +1,34 @@
+#pragma once
+#include <raylib.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bootstrap/rendering/RenderCommands.h"
+
+// CPU copy of an instance buffer the backend keeps resident. Edited in place;
+// EmitUploads() records only the ranges touched since the last call, and a
+// reallocation (doubling) when the array outgrows the backend's copy.
+class InstanceBuffer {
+public:
+    size_t Size() const { return cpu.size(); }
+    const RenderInstance& Get(size_t i) const { return cpu[i]; }
+    const RenderInstance* Data() const { return cpu.data(); }
+
+    void Push(const RenderInstance& r) { cpu.push_back(r); markDirty(cpu.size() - 1); }
+    void Set(size_t i, const RenderInstance& r) { cpu[i] = r; markDirty(i); }
+    void PopBack() { cpu.pop_back(); }
+
+    // Record reserve/upload commands for the dirty ranges into 'list' under
+    // 'buffer'; returns the bytes the backend will send.
+    size_t EmitUploads(RenderCommandList& list, uint8_t buffer);
+    // The backend lost its copy: the next EmitUploads reallocates and sends everything.
+    void Invalidate();
+
+private:
+    void markDirty(size_t i) { if (!allDirty) dirty.push_back((uint32_t)i); }
+
+    std::vector<RenderInstance> cpu;
+    std::vector<uint32_t> dirty;
+    uint32_t capacity{0};  // instances the backend buffer holds
+    bool allDirty{true};
+};
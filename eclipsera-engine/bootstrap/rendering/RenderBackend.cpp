@@ -0,0 +1,17 @@
+#include "bootstrap/rendering/RenderBackend.h"
+
+void NullRenderBackend::Execute(const RenderCommandList& list) {
+    last = Counters{};
+    last.frames = 1;
+    for (const RenderCommand& c : list.commands) {
+        ++last.ops[(size_t)c.op];
+        if (c.op == RenderOp::DrawInstances)   last.instancesDrawn += c.count;
+        if (c.op == RenderOp::UploadInstances) last.uploadBytes += (uint64_t)c.count * sizeof(RenderInstance);
+        if (c.op == RenderOp::UploadMesh)      last.uploadBytes += (uint64_t)c.count * sizeof(StaticVertex);
+    }
+
+    totals.frames += last.frames;
+    for (size_t i = 0; i < (size_t)RenderOp::Count; ++i) totals.ops[i] += last.ops[i];
+    totals.instancesDrawn += last.instancesDrawn;
+    totals.uploadBytes    += last.uploadBytes;
+}
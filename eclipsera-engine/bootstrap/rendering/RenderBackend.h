@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "bootstrap/rendering/RenderCommands.h"
+
+// Replays a RenderCommandList. Buffers named by RenderBufferId persist across
+// Execute calls; Release() drops them, after which the producer must re-send
+// everything (see InstanceBuffer::Invalidate).
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+    virtual void Execute(const RenderCommandList& list) = 0;
+    virtual void Release() {}
+};
+
+// Counts what it is given and draws nothing. Lets render prep run and be
+// measured without a window or GL context.
+class NullRenderBackend : public RenderBackend {
+public:
+    struct Counters {
+        uint64_t frames{0};
+        uint64_t ops[(size_t)RenderOp::Count]{};
+        uint64_t instancesDrawn{0};
+        uint64_t uploadBytes{0};
+    };
+
+    void Execute(const RenderCommandList& list) override;
+    const Counters& Totals() const { return totals; }
+    const Counters& LastFrame() const { return last; }
+    void ResetCounters() { totals = Counters{}; last = Counters{}; }
+
+private:
+    Counters totals, last;
+};
@@ -0,0 +1,25 @@
+#include "bootstrap/rendering/RenderCommands.h"
+
+static_assert(sizeof(RenderInstance) == sizeof(Matrix) + 4, "instance layout is read by the vertex shader");
+
+bool RenderCommandList::Reserve(uint8_t buffer, size_t count, uint32_t& capacity) {
+    if (count <= capacity) return false;
+    size_t cap = capacity ? capacity : 64;
+    while (cap < count) cap *= 2;
+    capacity = (uint32_t)cap;
+    Push(RenderOp::ReserveInstances, buffer, 0, capacity);
+    return true;
+}
+
+size_t RenderCommandList::Upload(uint8_t buffer, uint32_t first, const RenderInstance* data, size_t count) {
+    if (count == 0) return 0;
+    const uint32_t offset = (uint32_t)instances.size();
+    instances.insert(instances.end(), data, data + count);
+    return UploadStaged(buffer, first, offset, count);
+}
+
+size_t RenderCommandList::UploadStaged(uint8_t buffer, uint32_t first, uint32_t offset, size_t count) {
+    if (count == 0) return 0;
+    Push(RenderOp::UploadInstances, buffer, first, (uint32_t)count, offset);
+    return count * sizeof(RenderInstance);
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <raylib.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Per-instance vertex data: model matrix followed by an RGBA8 colour.
+struct RenderInstance {
+    Matrix xform;
+    Color  color;
+};
+
+// Vertex of merged static geometry, in world space. Meshes are quad lists:
+// every four vertices form one face, indexed 0-1-2 0-2-3.
+struct StaticVertex {
+    Vector3 position;
+    Vector3 normal;
+    Color   color;
+};
+
+// Instance buffers the backend keeps between frames, addressed by id.
+enum RenderBufferId : uint8_t {
+    kBufOpaque = 0,                        // the scene's opaque batch, patched by dirty range
+    kBufTransparent,                       // visible transparents, back to front
+    kBufShadowStatic,                      // + cascade: casters of the cached static depth
+    kBufShadowDynamic = kBufShadowStatic + 3, // + cascade: this frame's dynamic casters
+    kBufCount = kBufShadowDynamic + 3
+};
+
+enum class RenderOp : uint8_t {
+    ReserveInstances, // buffer, count: (re)allocate for 'count' instances; contents are lost
+    UploadInstances,  // buffer, first, count; arg: offset of the payload in RenderCommandList::instances
+    BeginShadow,      // cascade, arg: view; flags kShadowStaticMap, kShadowClear
+    CopyShadow,       // cascade: cached static depth -> live map
+    EndShadow,
+    BeginMain,        // arg: view
+    DrawSky,
+    BeginLit,         // bind shadow maps and FrameUniforms for the part draws that follow
+    DrawInstances,    // buffer, first, count; flags kDrawBlendAlpha
+    UploadMesh,       // arg: mesh id; first: offset in RenderCommandList::vertices, count: vertices
+    FreeMesh,         // arg: mesh id
+    DrawMesh,         // arg: mesh id, count: indices
+    EndMain,
+    Count
+};
+
+enum : uint8_t {
+    kShadowStaticMap = 1 << 0, // target the cascade's cached static depth instead of the live map
+    kShadowClear     = 1 << 1,
+    kDrawBlendAlpha  = 1 << 0, // alpha blend, no depth writes
+};
+
+struct RenderCommand {
+    RenderOp op;
+    uint8_t  buffer;
+    uint8_t  cascade;
+    uint8_t  flags;
+    uint32_t first;
+    uint32_t count;
+    uint32_t arg;
+};
+static_assert(sizeof(RenderCommand) == 16, "commands are meant to stay small");
+
+// Everything the lit shader reads per frame.
+struct FrameUniforms {
+    Vector3 viewPos;
+    Vector3 sunDir;            // from the sun toward the scene
+    Vector3 skyColor, groundColor, ambientColor;
+    float   hemiStrength, sunStrength, specStrength, shininess, fresnelStrength;
+    float   aoStrength, groundY, exposure, transitionFrac;
+    Vector3 skyInner, skyOuter; // sky gradient, horizon and zenith
+    Matrix  lightVP[3];
+    float   cascadeSplits[3];
+    float   normalBias[3];     // world-space offset along the normal, per cascade
+    int     shadowRes;
+    float   pcfStep, biasMin, biasMax;
+};
+
+// One frame as plain data: produced by the render prep without touching GL,
+// replayed in order by a RenderBackend. Instance and vertex payloads live in
+// 'instances' and 'vertices' and are referenced by offset, so the list can be
+// kept or handed to another thread as a whole.
+struct RenderCommandList {
+    FrameUniforms uniforms{};
+    std::vector<Camera3D>       views;
+    std::vector<RenderCommand>  commands;
+    std::vector<RenderInstance> instances;
+    std::vector<StaticVertex>   vertices;
+
+    void Clear() { views.clear(); commands.clear(); instances.clear(); vertices.clear(); }
+
+    uint32_t AddView(const Camera3D& cam) { views.push_back(cam); return (uint32_t)views.size() - 1; }
+    void Push(RenderOp op, uint8_t buffer = 0, uint32_t first = 0, uint32_t count = 0,
+              uint32_t arg = 0, uint8_t cascade = 0, uint8_t flags = 0) {
+        commands.push_back({ op, buffer, cascade, flags, first, count, arg });
+    }
+
+    // Record a ReserveInstances when 'count' does not fit 'capacity' (the caller's
+    // record of the backend allocation, doubled from 64). Returns true when the
+    // buffer was reallocated and has to be sent whole.
+    bool Reserve(uint8_t buffer, size_t count, uint32_t& capacity);
+    // Copy 'count' instances into the payload and record the upload to buffer[first..];
+    // returns the bytes the backend will send.
+    size_t Upload(uint8_t buffer, uint32_t first, const RenderInstance* data, size_t count);
+    // Same, for a payload the caller already appended at 'offset'.
+    size_t UploadStaged(uint8_t buffer, uint32_t first, uint32_t offset, size_t count);
+};
@@ -0,0 +1,366 @@
+#include "bootstrap/rendering/RenderScene.h"
+#include "bootstrap/instances/BasePart.h"
+#include "bootstrap/instances/Part.h"
+#include "bootstrap/instances/Workspace.h"
+#include "core/runtime/TaskScheduler.h"
+#include "subsystems/physics/PhysicsWorld.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#ifdef ECLIPSERA_SSE2
+#include <emmintrin.h>
+#endif
+
+// proxies per transform job
+static constexpr size_t kTransformGrain = 2048;
+
+static inline uint32_t PackColorKey(const Color3& c) {
+    auto u8 = [](float v){ return (uint32_t)std::lroundf(std::clamp(v, 0.0f, 1.0f) * 255.0f); };
+    return (u8(c.r) << 24) | (u8(c.g) << 16) | (u8(c.b) << 8) | 0xFFu;
+}
+
+// Instance matrix (CFrame rotation with columns scaled by Size, then translation),
+// plus the world AABB and bounding sphere of the box.
+static void BuildPartTransform(const CFrame& cf, const ::Vector3& s, RenderProxy& rp) {
+    const float* R = cf.R;
+    rp.center = { cf.p.x, cf.p.y, cf.p.z };
+    rp.radius = 0.5f * std::sqrt(s.x*s.x + s.y*s.y + s.z*s.z);
+#ifdef ECLIPSERA_SSE2
+    // raylib's Matrix is stored row by row (m0 m4 m8 m12, ...); row r is CFrame row r * Size
+    // plus p[r], so each row is one load and one multiply. Row 2's load runs into CF.p.x,
+    // which the mask drops.
+    static_assert(offsetof(CFrame, p) == 9 * sizeof(float), "rows are loaded four floats at a time");
+    const __m128 xyz  = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 sv   = _mm_setr_ps(s.x, s.y, s.z, 0.0f);
+    __m128 r0 = _mm_and_ps(_mm_mul_ps(_mm_loadu_ps(R + 0), sv), xyz);
+    __m128 r1 = _mm_and_ps(_mm_mul_ps(_mm_loadu_ps(R + 3), sv), xyz);
+    __m128 r2 = _mm_and_ps(_mm_mul_ps(_mm_loadu_ps(R + 6), sv), xyz);
+
+    // half extents: row sums of |M| over the 3x3 part
+    __m128 a0 = _mm_andnot_ps(sign, r0), a1 = _mm_andnot_ps(sign, r1), a2 = _mm_andnot_ps(sign, r2);
+    __m128 a3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+    alignas(16) float e[4];
+    _mm_store_ps(e, _mm_mul_ps(_mm_add_ps(_mm_add_ps(a0, a1), a2), _mm_set1_ps(0.5f)));
+    rp.extents = { e[0], e[1], e[2] };
+
+    float* M = &rp.xform.m0;
+    _mm_storeu_ps(M + 0,  _mm_or_ps(r0, _mm_setr_ps(0.0f, 0.0f, 0.0f, cf.p.x)));
+    _mm_storeu_ps(M + 4,  _mm_or_ps(r1, _mm_setr_ps(0.0f, 0.0f, 0.0f, cf.p.y)));
+    _mm_storeu_ps(M + 8,  _mm_or_ps(r2, _mm_setr_ps(0.0f, 0.0f, 0.0f, cf.p.z)));
+    _mm_storeu_ps(M + 12, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+#else
+    // CFrame::R is row-major; columns are scaled by Size
+    Matrix M = {0};
+    M.m0 = R[0]*s.x; M.m1 = R[3]*s.x; M.m2  = R[6]*s.x;
+    M.m4 = R[1]*s.y; M.m5 = R[4]*s.y; M.m6  = R[7]*s.y;
+    M.m8 = R[2]*s.z; M.m9 = R[5]*s.z; M.m10 = R[8]*s.z;
+    M.m12 = cf.p.x; M.m13 = cf.p.y; M.m14 = cf.p.z; M.m15 = 1.0f;
+    rp.xform = M;
+
+    // world AABB half extents of the oriented box: |R| * size/2
+    rp.extents = {
+        0.5f * (std::fabs(M.m0) + std::fabs(M.m4) + std::fabs(M.m8)),
+        0.5f * (std::fabs(M.m1) + std::fabs(M.m5) + std::fabs(M.m9)),
+        0.5f * (std::fabs(M.m2) + std::fabs(M.m6) + std::fabs(M.m10)) };
+#endif
+}
+
+// static opaque casters are drawn from merged meshes rather than the opaque batch
+static inline bool Mergeable(const RenderProxy& rp) {
+    return rp.isStatic && rp.castShadow && rp.bucket == RenderBucket::Opaque;
+}
+
+static bool IsUnder(const Instance* inst, const Workspace* ws) {
+    for (auto p = inst->Parent.lock(); p; p = p->Parent.lock())
+        if (p.get() == ws) return true;
+    return false;
+}
+
+RenderScene::RenderScene() { initBatches(); }
+
+RenderScene::~RenderScene() {
+    if (cursor != ChangeJournal::kNoCursor) ChangeJournal::Get().Unsubscribe(cursor);
+}
+
+int32_t RenderScene::find(const BasePart* p) const {
+    const uint32_t s = p->RenderSlot;
+    return (s < proxies.size() && proxies[s].part == p) ? (int32_t)s : -1;
+}
+
+// -------- batches --------
+void RenderScene::initBatches() {
+    batches.resize(2);
+    batches[kTransparentBatch].bucket = RenderBucket::Transparent;
+    batches[kOpaqueBatch].bucket      = RenderBucket::Opaque;
+}
+
+void RenderScene::attach(uint32_t slot) {
+    RenderProxy& rp = proxies[slot];
+    if (rp.bucket == RenderBucket::Hidden) { rp.batch = RenderProxy::kNoBatch; return; }
+
+    rp.batch = rp.bucket == RenderBucket::Transparent ? kTransparentBatch : kOpaqueBatch;
+    RenderBatch& b = batches[rp.batch];
+    rp.member = (uint32_t)b.members.size();
+    b.members.push_back(slot);
+    b.bounds.Reserve(b.members.size());
+    b.bounds.Set(rp.member, rp.center, rp.extents);
+    if (b.bucket == RenderBucket::Opaque) b.instances.Push({ rp.xform, ColorFromKey(rp.colorKey) });
+}
+
+void RenderScene::detach(uint32_t slot) {
+    RenderProxy& rp = proxies[slot];
+    if (rp.batch == RenderProxy::kNoBatch) return;
+
+    RenderBatch& b = batches[rp.batch];
+    const uint32_t m = rp.member, last = (uint32_t)b.members.size() - 1;
+    if (m != last) {
+        const uint32_t moved = b.members[last];
+        b.members[m] = moved;
+        proxies[moved].member = m;
+        b.bounds.Move(m, last);
+        if (b.bucket == RenderBucket::Opaque) b.instances.Set(m, b.instances.Get(last));
+    }
+    b.members.pop_back();
+    b.bounds.Clear(last);
+    if (b.bucket == RenderBucket::Opaque) b.instances.PopBack();
+    rp.batch = RenderProxy::kNoBatch;
+}
+
+size_t RenderScene::EmitUploads(RenderCommandList& list) {
+    return batches[kOpaqueBatch].instances.EmitUploads(list, kBufOpaque)
+         + statics.EmitUploads(proxies, list);
+}
+
+void RenderScene::merge(uint32_t slot) {
+    detach(slot);
+    statics.Add(proxies, slot);
+}
+
+void RenderScene::unmerge(uint32_t slot) {
+    statics.Remove(proxies, slot);
+    attach(slot);
+}
+
+// -------- static caster tracking --------
+void RenderScene::markStaticDirty(const RenderProxy& rp) {
+    if (staticDirtyAll) return;
+    if (staticDirty.size() >= kMaxDirtyRegions) { staticDirty.clear(); staticDirtyAll = true; return; }
+    staticDirty.push_back({ rp.center, rp.extents });
+}
+
+// leave the static set (dirtying its old footprint) and start settling again if still anchored
+void RenderScene::makeDynamic(RenderProxy& rp) {
+    if (rp.cell != StaticBatcher::kNoCell) unmerge(rp.part->RenderSlot);
+    if (rp.isStatic) { markStaticDirty(rp); rp.isStatic = false; }
+    if (rp.anchored && !rp.settling) { rp.settling = true; settling.push_back(rp.part); }
+}
+
+void RenderScene::promoteSettled() {
+    for (size_t i = 0; i < settling.size();) {
+        const int32_t slot = find(settling[i]);
+        RenderProxy* rp = slot >= 0 ? &proxies[slot] : nullptr;
+        if (rp && rp->anchored && frame - rp->lastMoveFrame < kStaticSettleFrames) { ++i; continue; }
+        if (rp) {
+            rp->settling = false;
+            if (rp->anchored) {
+                rp->isStatic = true;
+                markStaticDirty(*rp);
+                if (Mergeable(*rp)) merge((uint32_t)slot);
+                ++updated;
+            }
+        }
+        settling[i] = settling.back();
+        settling.pop_back();
+    }
+}
+
+// -------- proxies --------
+void RenderScene::add(BasePart* p) {
+    const uint32_t slot = (uint32_t)proxies.size();
+    p->RenderSlot = slot;
+    RenderProxy rp{};
+    rp.part  = p;
+    rp.batch = RenderProxy::kNoBatch;
+    rp.cell  = StaticBatcher::kNoCell;
+    proxies.push_back(rp);
+    refresh(slot, Change_Transform | Change_Shape | Change_Appearance | Change_Physics);
+}
+
+void RenderScene::remove(int32_t slot) {
+    RenderProxy& rp = proxies[slot];
+    if (rp.isStatic) markStaticDirty(rp);
+    if (rp.settling) settling.erase(std::find(settling.begin(), settling.end(), rp.part));
+    if (rp.cell != StaticBatcher::kNoCell) statics.Remove(proxies, (uint32_t)slot);
+    detach((uint32_t)slot);
+    rp.part->RenderSlot = 0xFFFFFFFFu;
+
+    const uint32_t last = (uint32_t)proxies.size() - 1;
+    if ((uint32_t)slot != last) {
+        proxies[slot] = proxies[last];
+        RenderProxy& moved = proxies[slot];
+        moved.part->RenderSlot = (uint32_t)slot;
+        if (moved.xformPending) pendingXform.push_back((uint32_t)slot);
+        if (moved.batch != RenderProxy::kNoBatch) batches[moved.batch].members[moved.member] = (uint32_t)slot;
+        if (moved.cell != StaticBatcher::kNoCell) statics.Renumber(moved, (uint32_t)slot);
+    }
+    proxies.pop_back();
+    ++updated;
+}
+
+void RenderScene::refresh(uint32_t slot, uint32_t groups) {
+    RenderProxy& rp = proxies[slot];
+    const BasePart* p = rp.part;
+    if (groups & Change_Physics) {
+        rp.anchored = p->Anchored;
+        if (!rp.anchored && rp.cell != StaticBatcher::kNoCell) unmerge(slot);
+        if (!rp.anchored && rp.isStatic) { markStaticDirty(rp); rp.isStatic = false; }
+        if (rp.anchored && !rp.isStatic) makeDynamic(rp);
+    }
+    if (groups & (Change_Transform | Change_Shape)) {
+        if (rp.isStatic) makeDynamic(rp);
+        rp.lastMoveFrame = frame;
+        // until applyTransforms() the old footprint stays, so static dirtying above sees it
+        if (!rp.xformPending) { rp.xformPending = true; pendingXform.push_back(slot); }
+    }
+    if (groups & Change_Appearance) {
+        const bool castedBefore = rp.castShadow && rp.bucket != RenderBucket::Hidden;
+        const RenderBucket oldBucket = rp.bucket;
+        const uint32_t oldKey = rp.colorKey;
+        const bool wasMerged = rp.cell != StaticBatcher::kNoCell;
+
+        rp.colorKey   = PackColorKey(p->Color);
+        rp.alpha      = 1.0f - std::clamp(p->Transparency, 0.0f, 1.0f);
+        rp.bucket     = rp.alpha <= 0.0f ? RenderBucket::Hidden
+                      : rp.alpha >= 1.0f ? RenderBucket::Opaque : RenderBucket::Transparent;
+        rp.castShadow = p->CastShadow;
+        if (rp.isStatic && castedBefore != (rp.castShadow && rp.bucket != RenderBucket::Hidden)) markStaticDirty(rp);
+
+        if (wasMerged) {
+            if (!Mergeable(rp)) unmerge(slot);  // attaches to the new bucket
+            else if (rp.colorKey != oldKey) statics.Touch(rp);
+        }
+        else if (rp.batch == RenderProxy::kNoBatch || rp.bucket != oldBucket) { detach(slot); attach(slot); }
+        else if (rp.bucket == RenderBucket::Opaque && rp.colorKey != oldKey)
+            batches[rp.batch].instances.Set(rp.member, { rp.xform, ColorFromKey(rp.colorKey) });
+        if (!wasMerged && Mergeable(rp)) merge(slot);
+    }
+    ++updated;
+}
+
+// Rebuild the transforms queued by refresh(): the math runs in parallel chunks
+// (each job only writes its own proxies), then bounds and instances are written back.
+void RenderScene::applyTransforms() {
+    if (pendingXform.empty()) return;
+    static std::vector<uint32_t> slots;
+    slots.clear();
+    for (uint32_t s : pendingXform) {
+        if (s >= proxies.size() || !proxies[s].xformPending) continue;
+        proxies[s].xformPending = false;
+        slots.push_back(s);
+    }
+    pendingXform.clear();
+
+    TaskScheduler::Get().ParallelFor(slots.size(), kTransformGrain, [&](size_t b, size_t e){
+        for (size_t i = b; i < e; ++i) {
+            RenderProxy& rp = proxies[slots[i]];
+            BuildPartTransform(rp.part->CF, rp.part->Size, rp);
+        }
+    });
+
+    for (uint32_t s : slots) {
+        const RenderProxy& rp = proxies[s];
+        if (rp.batch == RenderProxy::kNoBatch) continue;
+        RenderBatch& b = batches[rp.batch];
+        b.bounds.Set(rp.member, rp.center, rp.extents);
+        if (b.bucket == RenderBucket::Opaque) b.instances.Set(rp.member, { rp.xform, ColorFromKey(rp.colorKey) });
+    }
+}
+
+void RenderScene::OverrideTransforms(const InterpolatedPose* poses, size_t count) {
+    static std::vector<uint32_t> slots;
+    slots.resize(count);
+    for (size_t i = 0; i < count; ++i) slots[i] = (uint32_t)find(poses[i].part);
+
+    TaskScheduler::Get().ParallelFor(count, kTransformGrain, [&](size_t b, size_t e){
+        for (size_t i = b; i < e; ++i) {
+            if ((int32_t)slots[i] < 0) continue;
+            RenderProxy& rp = proxies[slots[i]];
+            BuildPartTransform(poses[i].cframe, rp.part->Size, rp);
+        }
+    });
+
+    for (uint32_t s : slots) {
+        if ((int32_t)s < 0) continue;
+        const RenderProxy& rp = proxies[s];
+        if (rp.batch == RenderProxy::kNoBatch) continue;
+        RenderBatch& b = batches[rp.batch];
+        b.bounds.Set(rp.member, rp.center, rp.extents);
+        if (b.bucket == RenderBucket::Opaque) b.instances.Set(rp.member, { rp.xform, ColorFromKey(rp.colorKey) });
+    }
+    if (count) ++version;
+}
+
+void RenderScene::Reset() {
+    proxies.clear();
+    pendingXform.clear();
+    batches.clear();
+    initBatches();
+    statics.Clear();
+
+    settling.clear();
+    staticDirty.clear();
+    staticDirtyAll = true;
+    workspace.reset();
+    ++version;
+    if (cursor != ChangeJournal::kNoCursor) {
+        ChangeJournal::Get().Unsubscribe(cursor);
+        cursor = ChangeJournal::kNoCursor;
+    }
+}
+
+void RenderScene::Sync(const std::shared_ptr<Workspace>& ws) {
+    updated = 0;
+    ++frame;
+    if (!ws) { if (workspace.lock() || !proxies.empty()) Reset(); return; }
+
+    auto& journal = ChangeJournal::Get();
+    if (cursor == ChangeJournal::kNoCursor || workspace.lock() != ws) {
+        Reset();
+        cursor = journal.Subscribe();
+        workspace = ws;
+        proxies.reserve(ws->parts.size());
+        for (auto& p : ws->parts) if (p && p->Alive) add(p.get());
+        applyTransforms();
+        // whatever is anchored now starts out static
+        for (uint32_t s = 0; s < proxies.size(); ++s) {
+            RenderProxy& rp = proxies[s];
+            if (!rp.settling) continue;
+            rp.settling = false;
+            rp.isStatic = true;
+            if (Mergeable(rp)) merge(s);
+        }
+        settling.clear();
+        staticDirtyAll = true;
+        ++version;
+        return;
+    }
+
+    journal.Read(cursor, [&](const ChangeJournal::Record& r){
+        if (r.inst->Class != InstanceClass::Part) return;
+        auto* p = static_cast<BasePart*>(r.inst.get());
+        int32_t slot = find(p);
+
+        if (r.groups & (Change_Hierarchy | Change_Removed)) {
+            const bool inWorld = p->Alive && IsUnder(p, ws.get());
+            if (!inWorld) { if (slot >= 0) remove(slot); return; }
+            if (slot < 0) { add(p); return; }
+        }
+        if (slot >= 0) refresh((uint32_t)slot, r.groups);
+    });
+    applyTransforms();
+    promoteSettled();
+    if (updated) ++version;
+}
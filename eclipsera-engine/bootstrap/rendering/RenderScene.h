@@ -0,0 +1,125 @@
+#pragma once
+#include <raylib.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "bootstrap/ChangeJournal.h"
+#include "bootstrap/rendering/Frustum.h"
+#include "bootstrap/rendering/InstanceBuffer.h"
+#include "bootstrap/rendering/StaticBatcher.h"
+
+struct BasePart;
+struct Workspace;
+struct InterpolatedPose;
+
+enum class RenderBucket : uint8_t { Hidden, Opaque, Transparent };
+
+inline Color ColorFromKey(uint32_t key, unsigned char alpha = 255) {
+    return { (unsigned char)(key >> 24), (unsigned char)(key >> 16), (unsigned char)(key >> 8), alpha };
+}
+
+// Per-part data the renderer derives from BasePart properties.
+struct RenderProxy {
+    static constexpr uint32_t kNoBatch = 0xFFFFFFFFu;
+
+    BasePart* part;      // owner; removed before the part can leave the workspace
+    Matrix    xform;     // instance matrix (rotation * size, translation)
+    Vector3   center;
+    Vector3   extents;   // world AABB half extents
+    float     radius;    // bounding sphere
+    uint32_t  colorKey;  // RGBA8, alpha always 255
+    float     alpha;
+    RenderBucket bucket;
+    bool      castShadow;
+    bool      anchored;
+    bool      isStatic;      // anchored and unmoved for kStaticSettleFrames; drawn into cached shadow depth
+    bool      settling;      // anchored, waiting to become static
+    bool      xformPending;  // xform/center/extents/radius are rebuilt at the end of Sync
+    uint32_t  lastMoveFrame;
+    uint32_t  batch;         // kNoBatch while hidden or merged
+    uint32_t  cell;          // StaticBatcher cell while merged, else StaticBatcher::kNoCell
+    uint32_t  member;        // index inside the batch, or inside the cell while merged
+};
+
+// Visible parts sharing draw state. members, bounds and instances are parallel
+// arrays indexed by member; removal swaps the last member in. Colour is per
+// instance, so every opaque part shares one batch.
+struct RenderBatch {
+    RenderBucket bucket{RenderBucket::Opaque};
+    std::vector<uint32_t> members;  // proxy slots
+    PackedBounds bounds;
+    InstanceBuffer instances;       // opaque batches only
+};
+
+// Retained copy of the workspace's parts for the renderer. Subscribes to the
+// ChangeJournal and only rebuilds the proxies of parts that changed, so an
+// idle world costs nothing beyond culling the batches. Static opaque shadow
+// casters leave the opaque batch and are merged by the StaticBatcher.
+class RenderScene {
+public:
+    static constexpr uint32_t kStaticSettleFrames = 30;
+    static constexpr size_t   kMaxDirtyRegions    = 256;
+    static constexpr uint32_t kTransparentBatch   = 0;
+    static constexpr uint32_t kOpaqueBatch        = 1;
+
+    struct DirtyRegion { Vector3 center, extents; };
+
+    RenderScene();
+    ~RenderScene();
+
+    // Apply pending journal records; full rebuild on first use or when the workspace changes.
+    // Transforms of the changed parts are rebuilt in parallel on the TaskScheduler.
+    void Sync(const std::shared_ptr<Workspace>& ws);
+    // Record uploads of the opaque batch's changed instance ranges (backend buffer
+    // kBufOpaque) and of rebuilt static meshes into 'list'; returns the bytes they send.
+    size_t EmitUploads(RenderCommandList& list);
+    // Draw the listed parts at the given CFrames instead of their own, until a
+    // journal record or the next override rebuilds them; used for physics
+    // bodies interpolated between steps. Call after Sync.
+    void OverrideTransforms(const InterpolatedPose* poses, size_t count);
+    // Drop everything; the next EmitUploads re-sends the whole batch.
+    void Reset();
+
+    const std::vector<RenderProxy>& Proxies() const { return proxies; }
+    const std::vector<RenderBatch>& Batches() const { return batches; }
+    const StaticBatcher& Statics() const { return statics; }
+    uint32_t UpdatedLastSync() const { return updated; }
+    // bumped whenever a Sync changed anything
+    uint64_t Version() const { return version; }
+
+    // Where the static caster set changed since ClearStaticDirty(); AllStaticDirty()
+    // means "anywhere" (initial build, or too many regions to track).
+    const std::vector<DirtyRegion>& StaticDirtyRegions() const { return staticDirty; }
+    bool AllStaticDirty() const { return staticDirtyAll; }
+    void ClearStaticDirty() { staticDirty.clear(); staticDirtyAll = false; }
+
+private:
+    int32_t find(const BasePart* p) const;
+    void add(BasePart* p);
+    void remove(int32_t slot);
+    void refresh(uint32_t slot, uint32_t groups);
+    void attach(uint32_t slot);
+    void detach(uint32_t slot);
+    void initBatches();
+    void markStaticDirty(const RenderProxy& rp);
+    void makeDynamic(RenderProxy& rp);
+    void promoteSettled();
+    void applyTransforms();
+    void merge(uint32_t slot);
+    void unmerge(uint32_t slot);
+
+    std::vector<RenderProxy> proxies;
+    std::vector<RenderBatch> batches;   // indexed by kTransparentBatch / kOpaqueBatch
+    StaticBatcher            statics;
+
+    ChangeJournal::Cursor cursor{ ChangeJournal::kNoCursor };
+    std::weak_ptr<Workspace> workspace;
+    uint32_t updated{0};
+    uint32_t frame{0};
+    uint64_t version{0};
+
+    std::vector<uint32_t>    pendingXform;  // slots; may hold stale or repeated entries, xformPending decides
+    std::vector<BasePart*>   settling;
+    std::vector<DirtyRegion> staticDirty;
+    bool staticDirtyAll{true};
+};
@@ -0,0 +1,408 @@
+#include "bootstrap/rendering/RlglBackend.h"
+#include <raymath.h>
+#include <rlgl.h>
+#include <cstddef>
+#include <vector>
+#include "bootstrap/shaders/shaders.h"
+#include "bootstrap/shaders/sky.h"
+#include "bootstrap/Renderer.h"
+#include "bootstrap/rendering/StaticBatcher.h"
+#include "core/runtime/TaskScheduler.h"
+
+static constexpr bool kCullBackFace = true;
+static constexpr int  kShadowSlot0  = 10; // shadow maps bind to texture slots 10..12
+
+// ---------------- Helpers ----------------
+static RenderTexture2D LoadShadowmapRenderTexture(int width, int height){
+    RenderTexture2D target = {0};
+    target.id = rlLoadFramebuffer(); // empty FBO
+    target.texture.width = width;
+    target.texture.height = height;
+
+    if (target.id > 0){
+        rlEnableFramebuffer(target.id);
+
+        // Depth texture only
+        target.depth.id = rlLoadTextureDepth(width, height, false);
+        target.depth.width = width;
+        target.depth.height = height;
+        target.depth.format = 19; // DEPTH24
+        target.depth.mipmaps = 1;
+
+        rlFramebufferAttach(target.id, target.depth.id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+        rlFramebufferComplete(target.id);
+        rlDisableFramebuffer();
+    }
+    return target;
+}
+
+static void UnloadShadowmapRenderTexture(RenderTexture2D target){
+    if (target.id > 0) rlUnloadFramebuffer(target.id);
+}
+
+// Instanced draw of 'count' instances starting at 'first' from an instance VBO.
+// The matrix feeds the shader's SHADER_LOC_MATRIX_MODEL attribute and the colour
+// its SHADER_LOC_VERTEX_COLOR attribute (both divisor 1); the colour is
+// multiplied with 'diffuse' by the lit shader. Unlike DrawMeshInstanced this
+// never creates or uploads a buffer.
+static void DrawMeshInstances(const Mesh& mesh, const Shader& shader, Color diffuse,
+                              unsigned int instanceVbo, int first, int count) {
+    const int loc = shader.locs[SHADER_LOC_MATRIX_MODEL];
+    const int colorLoc = shader.locs[SHADER_LOC_VERTEX_COLOR];
+    const int stride = (int)sizeof(RenderInstance);
+    if (count <= 0 || !instanceVbo || loc < 0) return;
+
+    rlEnableShader(shader.id);
+
+    if (shader.locs[SHADER_LOC_COLOR_DIFFUSE] != -1) {
+        const float c[4] = { diffuse.r/255.0f, diffuse.g/255.0f, diffuse.b/255.0f, diffuse.a/255.0f };
+        rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], c, SHADER_UNIFORM_VEC4, 1);
+    }
+
+    // same matrix set DrawMeshInstanced provides: model is per instance
+    const Matrix view = rlGetMatrixModelview();
+    const Matrix proj = rlGetMatrixProjection();
+    if (shader.locs[SHADER_LOC_MATRIX_VIEW] != -1)       rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_VIEW], view);
+    if (shader.locs[SHADER_LOC_MATRIX_PROJECTION] != -1) rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_PROJECTION], proj);
+    const Matrix mv = MatrixMultiply(rlGetMatrixTransform(), view);
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(mv, proj));
+
+    rlEnableVertexArray(mesh.vaoId);
+    rlEnableVertexBuffer(instanceVbo);
+    for (int i = 0; i < 4; ++i) {
+        rlEnableVertexAttribute(loc + i);
+        rlSetVertexAttribute(loc + i, 4, RL_FLOAT, false, stride,
+                             (int)(first * stride + i * sizeof(Vector4)));
+        rlSetVertexAttributeDivisor(loc + i, 1);
+    }
+    if (colorLoc >= 0) {
+        rlEnableVertexAttribute(colorLoc);
+        rlSetVertexAttribute(colorLoc, 4, RL_UNSIGNED_BYTE, true, stride,
+                             (int)(first * stride + offsetof(RenderInstance, color)));
+        rlSetVertexAttributeDivisor(colorLoc, 1);
+    }
+
+    if (mesh.indices) rlDrawVertexArrayElementsInstanced(0, mesh.triangleCount * 3, 0, count);
+    else              rlDrawVertexArrayInstanced(0, mesh.vertexCount, count);
+
+    // leave the mesh VAO usable by non-instanced draws
+    for (int i = 0; i < 4; ++i) rlDisableVertexAttribute(loc + i);
+    if (colorLoc >= 0) rlDisableVertexAttribute(colorLoc);
+    rlDisableVertexBuffer();
+    rlDisableVertexArray();
+    rlDisableShader();
+}
+
+// Draw 'indexCount' indices of a merged static mesh (world-space vertices, model = identity).
+static void DrawStaticMesh(const Shader& shader, unsigned int vao, int indexCount) {
+    if (!vao || indexCount <= 0) return;
+    rlEnableShader(shader.id);
+    if (shader.locs[SHADER_LOC_COLOR_DIFFUSE] != -1) {
+        const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], white, SHADER_UNIFORM_VEC4, 1);
+    }
+    const Matrix mv = MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview());
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(mv, rlGetMatrixProjection()));
+
+    rlEnableVertexArray(vao);
+    rlDrawVertexArrayElements(0, indexCount, 0);
+    rlDisableVertexArray();
+    rlDisableShader();
+}
+
+// ---------------- Resources ----------------
+RlglBackend::LitLocations RlglBackend::findLitLocations(const Shader& s) {
+    LitLocations l{};
+    // lighting
+    l.viewPos    = GetShaderLocation(s, "viewPos");
+    l.sunDir     = GetShaderLocation(s, "sunDir");
+    l.sky        = GetShaderLocation(s, "skyColor");
+    l.ground     = GetShaderLocation(s, "groundColor");
+    l.hemi       = GetShaderLocation(s, "hemiStrength");
+    l.sun        = GetShaderLocation(s, "sunStrength");
+    l.ambient    = GetShaderLocation(s, "ambientColor");
+    l.spec       = GetShaderLocation(s, "specStrength");
+    l.shiny      = GetShaderLocation(s, "shininess");
+    l.fresnel    = GetShaderLocation(s, "fresnelStrength");
+    l.ao         = GetShaderLocation(s, "aoStrength");
+    l.groundY    = GetShaderLocation(s, "groundY");
+    l.exposure   = GetShaderLocation(s, "exposure");
+
+    // cascades
+    l.lightVP[0]    = GetShaderLocation(s, "lightVP0");
+    l.lightVP[1]    = GetShaderLocation(s, "lightVP1");
+    l.lightVP[2]    = GetShaderLocation(s, "lightVP2");
+    l.shadowMap[0]  = GetShaderLocation(s, "shadowMap0");
+    l.shadowMap[1]  = GetShaderLocation(s, "shadowMap1");
+    l.shadowMap[2]  = GetShaderLocation(s, "shadowMap2");
+    l.normalBias[0] = GetShaderLocation(s, "normalBiasWS0");
+    l.normalBias[1] = GetShaderLocation(s, "normalBiasWS1");
+    l.normalBias[2] = GetShaderLocation(s, "normalBiasWS2");
+    l.shadowRes  = GetShaderLocation(s, "shadowMapResolution");
+    l.pcfStep    = GetShaderLocation(s, "pcfStep");
+    l.biasMin    = GetShaderLocation(s, "biasMin");
+    l.biasMax    = GetShaderLocation(s, "biasMax");
+    l.splits     = GetShaderLocation(s, "cascadeSplits");
+    l.transition = GetShaderLocation(s, "transitionFrac");
+    return l;
+}
+
+void RlglBackend::ensureResources(int res) {
+    if (!lit.id) {
+        lit = LoadShaderFromMemory(LIT_VS_INST, LIT_FS);
+
+        // in order for DrawMeshInstanced to pick up instanceTransform as the model matrix attribute,
+        // assign its attribute location to SHADER_LOC_MATRIX_MODEL
+        lit.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(lit, "instanceTransform");
+        // per-instance colour rides in the same buffer; DrawMeshInstances binds it through this slot
+        lit.locs[SHADER_LOC_VERTEX_COLOR] = GetShaderLocationAttrib(lit, "instanceColor");
+
+        litLoc = findLitLocations(lit);
+    }
+
+    if (!litStatic.id) {
+        // world-space vertices with per-vertex colour; attributes use raylib's default names
+        litStatic = LoadShaderFromMemory(LIT_VS_STATIC, LIT_FS);
+        staticLoc = findLitLocations(litStatic);
+    }
+
+    if (!sky.id) {
+        sky = LoadShaderFromMemory(SKY_VS, SKY_FS);
+        skyInner = GetShaderLocation(sky, "innerColor");
+        skyOuter = GetShaderLocation(sky, "outerColor");
+    }
+
+    if (partModel.meshCount == 0) partModel = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
+
+    // one index buffer shared by every static mesh: quads as 0-1-2 0-2-3
+    if (!quadIndices) {
+        std::vector<unsigned short> idx((size_t)StaticBatcher::kMaxQuadsPerChunk * 6);
+        for (uint32_t q = 0; q < StaticBatcher::kMaxQuadsPerChunk; ++q) {
+            const unsigned short v = (unsigned short)(q * 4);
+            unsigned short* o = &idx[(size_t)q * 6];
+            o[0] = v; o[1] = v + 1; o[2] = v + 2; o[3] = v; o[4] = v + 2; o[5] = v + 3;
+        }
+        quadIndices = rlLoadVertexBufferElement(idx.data(), (int)(idx.size() * sizeof(unsigned short)), false);
+    }
+
+    // Sky cube
+    if (skyModel.meshCount == 0) {
+        skyModel = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
+        skyModel.materials[0].shader = sky;
+    }
+
+    if (res != shadowRes) {
+        for (int i=0;i<3;i++){
+            UnloadShadowmapRenderTexture(shadowLive[i]);
+            UnloadShadowmapRenderTexture(shadowStatic[i]);
+            shadowLive[i]   = LoadShadowmapRenderTexture(res, res);
+            shadowStatic[i] = LoadShadowmapRenderTexture(res, res);
+        }
+        shadowRes = res;
+    }
+}
+
+void RlglBackend::uploadMesh(uint32_t id, const StaticVertex* vertices, uint32_t count) {
+    if (id >= meshes.size()) meshes.resize(id + 1);
+    freeMesh(id);
+    GpuMesh& m = meshes[id];
+    m.vao = rlLoadVertexArray();
+    rlEnableVertexArray(m.vao);
+    m.vbo = rlLoadVertexBuffer(vertices, (int)(count * sizeof(StaticVertex)), false);
+    const int stride = (int)sizeof(StaticVertex);
+    const int pos = litStatic.locs[SHADER_LOC_VERTEX_POSITION];
+    const int nrm = litStatic.locs[SHADER_LOC_VERTEX_NORMAL];
+    const int col = litStatic.locs[SHADER_LOC_VERTEX_COLOR];
+    if (pos >= 0) { rlSetVertexAttribute(pos, 3, RL_FLOAT, false, stride, (int)offsetof(StaticVertex, position)); rlEnableVertexAttribute(pos); }
+    if (nrm >= 0) { rlSetVertexAttribute(nrm, 3, RL_FLOAT, false, stride, (int)offsetof(StaticVertex, normal));   rlEnableVertexAttribute(nrm); }
+    if (col >= 0) { rlSetVertexAttribute(col, 4, RL_UNSIGNED_BYTE, true, stride, (int)offsetof(StaticVertex, color)); rlEnableVertexAttribute(col); }
+    rlEnableVertexBufferElement(quadIndices); // recorded in the VAO
+    rlDisableVertexArray();
+}
+
+void RlglBackend::freeMesh(uint32_t id) {
+    if (id >= meshes.size()) return;
+    GpuMesh& m = meshes[id];
+    if (m.vao) rlUnloadVertexArray(m.vao);
+    if (m.vbo) rlUnloadVertexBuffer(m.vbo);
+    m = GpuMesh{};
+}
+
+void RlglBackend::Release() {
+    for (uint32_t id = 0; id < meshes.size(); ++id) freeMesh(id);
+    meshes.clear();
+    if (quadIndices) { rlUnloadVertexBuffer(quadIndices); quadIndices = 0; }
+    for (GpuInstances& b : buffers) {
+        if (b.vbo) rlUnloadVertexBuffer(b.vbo);
+        b = GpuInstances{};
+    }
+    for (int i=0;i<3;i++){
+        UnloadShadowmapRenderTexture(shadowLive[i]);   shadowLive[i] = {0};
+        UnloadShadowmapRenderTexture(shadowStatic[i]); shadowStatic[i] = {0};
+    }
+    shadowRes = 0;
+    if (skyModel.meshCount) { UnloadModel(skyModel); skyModel = {0}; }
+    if (partModel.meshCount){ UnloadModel(partModel); partModel = {0}; }
+    if (sky.id) { UnloadShader(sky); sky = {0}; }
+    if (lit.id) { UnloadShader(lit); lit = {0}; }
+    if (litStatic.id) { UnloadShader(litStatic); litStatic = {0}; }
+}
+
+// ---------------- Passes ----------------
+void RlglBackend::drawSky(const FrameUniforms& u) {
+    rlDisableDepthTest();
+    rlDisableDepthMask();
+    if (kCullBackFace) rlDisableBackfaceCulling();
+    BeginShaderMode(sky);
+        SetShaderValue(sky, skyInner, &u.skyInner, SHADER_UNIFORM_VEC3);
+        SetShaderValue(sky, skyOuter, &u.skyOuter, SHADER_UNIFORM_VEC3);
+        DrawModel(skyModel, {0,0,0}, 100.0f, WHITE);
+    EndShaderMode();
+    rlEnableDepthMask();
+    rlEnableDepthTest();
+}
+
+void RlglBackend::setLitUniforms(const Shader& s, const LitLocations& l, const FrameUniforms& u) {
+    for (int i=0;i<3;i++){
+        const int slot = kShadowSlot0 + i;
+        SetShaderValue(s, l.shadowMap[i], &slot, SHADER_UNIFORM_INT);
+        SetShaderValueMatrix(s, l.lightVP[i], u.lightVP[i]);
+        SetShaderValue(s, l.normalBias[i], &u.normalBias[i], SHADER_UNIFORM_FLOAT);
+    }
+
+    SetShaderValue(s, l.viewPos, &u.viewPos, SHADER_UNIFORM_VEC3);
+    SetShaderValue(s, l.sunDir, &u.sunDir, SHADER_UNIFORM_VEC3);
+    SetShaderValue(s, l.sky, &u.skyColor, SHADER_UNIFORM_VEC3);
+    SetShaderValue(s, l.ground, &u.groundColor, SHADER_UNIFORM_VEC3);
+    SetShaderValue(s, l.hemi, &u.hemiStrength, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(s, l.sun, &u.sunStrength, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(s, l.ambient, &u.ambientColor, SHADER_UNIFORM_VEC3);
+    SetShaderValue(s, l.spec, &u.specStrength, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(s, l.shiny, &u.shininess, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(s, l.fresnel, &u.fresnelStrength, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(s, l.ao, &u.aoStrength, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(s, l.groundY, &u.groundY, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(s, l.exposure, &u.exposure, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(s, l.transition, &u.transitionFrac, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(s, l.splits, u.cascadeSplits, SHADER_UNIFORM_VEC3);
+    SetShaderValue(s, l.shadowRes, &u.shadowRes, SHADER_UNIFORM_INT);
+    SetShaderValue(s, l.pcfStep, &u.pcfStep, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(s, l.biasMin, &u.biasMin, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(s, l.biasMax, &u.biasMax, SHADER_UNIFORM_FLOAT);
+}
+
+void RlglBackend::beginLit(const FrameUniforms& u) {
+    if (kCullBackFace) rlEnableBackfaceCulling();
+
+    for (int i=0;i<3;i++){
+        rlActiveTextureSlot(kShadowSlot0 + i);
+        rlEnableTexture(shadowLive[i].depth.id);
+    }
+    setLitUniforms(lit, litLoc, u);
+    setLitUniforms(litStatic, staticLoc, u);
+}
+
+void RlglBackend::drawOverlay() {
+    const RenderStats& s = GetRenderStats();
+    DrawFPS(10,10);
+    DrawText(TextFormat("parts %u  updated %u  journal %u",
+                        s.parts, s.partsUpdated, s.journalRecords), 10, 32, 10, DARKGRAY);
+    DrawText(TextFormat("visible %u  culled %u  cull %.3f ms  draws %u  upload %u B",
+                        s.visible, s.culled, s.cullMs, s.drawCalls, (unsigned)s.uploadBytes), 10, 44, 10, DARKGRAY);
+    DrawText(TextFormat("transparent %u  sort %.3f ms  prep %.3f ms on %u threads  commands %u",
+                        s.transparents, s.sortMs, s.prepMs,
+                        TaskScheduler::Get().WorkerCount() + 1, s.commands), 10, 56, 10, DARKGRAY);
+    DrawText(TextFormat("shadow casters %u / %u / %u",
+                        s.shadowCasters[0], s.shadowCasters[1], s.shadowCasters[2]), 10, 68, 10, DARKGRAY);
+    DrawText(TextFormat("shadow redraws static %llu / %llu / %llu  dynamic %llu / %llu / %llu  of %llu frames",
+                        (unsigned long long)s.shadowStaticRedraws[0], (unsigned long long)s.shadowStaticRedraws[1],
+                        (unsigned long long)s.shadowStaticRedraws[2], (unsigned long long)s.shadowDynamicRedraws[0],
+                        (unsigned long long)s.shadowDynamicRedraws[1], (unsigned long long)s.shadowDynamicRedraws[2],
+                        (unsigned long long)s.frames), 10, 80, 10, DARKGRAY);
+    DrawText(TextFormat("%s  %.1f fps  latency %.2f ms  sync %.3f ms  prep wait %.3f ms",
+                        s.pacing.pipelined ? "pipelined" : "sequential", s.pacing.framesPerSecond,
+                        s.pacing.latencyMs, s.syncMs, s.pacing.waitMs), 10, 92, 10, DARKGRAY);
+    DrawText(TextFormat("static merged %u parts -> %u meshes (%u drawn)  verts %u -> %u  hidden faces %u  rebuilt %u cells in %.3f ms",
+                        s.statics.parts, s.statics.chunks, s.statics.chunksDrawn, s.statics.verticesBefore,
+                        s.statics.verticesAfter, s.statics.hiddenFaces, s.statics.cellsRebuilt,
+                        s.statics.rebuildMs), 10, 104, 10, DARKGRAY);
+}
+
+// ---------------- Replay ----------------
+void RlglBackend::Execute(const RenderCommandList& list) {
+    ensureResources(list.uniforms.shadowRes);
+    const Mesh& cube = partModel.meshes[0];
+
+    for (const RenderCommand& c : list.commands) {
+        switch (c.op) {
+        case RenderOp::ReserveInstances: {
+            GpuInstances& b = buffers[c.buffer];
+            if (b.vbo) rlUnloadVertexBuffer(b.vbo);
+            b.vbo = rlLoadVertexBuffer(nullptr, (int)(c.count * sizeof(RenderInstance)), true);
+            b.capacity = c.count;
+            break;
+        }
+        case RenderOp::UploadInstances: {
+            const GpuInstances& b = buffers[c.buffer];
+            if (!b.vbo || c.first + c.count > b.capacity) break; // producer missed a Release()
+            rlUpdateVertexBuffer(b.vbo, &list.instances[c.arg], (int)(c.count * sizeof(RenderInstance)),
+                                 (int)(c.first * sizeof(RenderInstance)));
+            break;
+        }
+        case RenderOp::BeginShadow:
+            BeginTextureMode((c.flags & kShadowStaticMap) ? shadowStatic[c.cascade] : shadowLive[c.cascade]);
+            if (c.flags & kShadowClear) ClearBackground(WHITE); // clears depth too
+            BeginMode3D(list.views[c.arg]);
+            // disable backface culling for shadow pass to reduce acne
+            rlDisableBackfaceCulling();
+            break;
+        case RenderOp::EndShadow:
+            if (kCullBackFace) rlEnableBackfaceCulling();
+            EndMode3D();
+            EndTextureMode();
+            break;
+        case RenderOp::CopyShadow:
+            rlBindFramebuffer(RL_READ_FRAMEBUFFER, shadowStatic[c.cascade].id);
+            rlBindFramebuffer(RL_DRAW_FRAMEBUFFER, shadowLive[c.cascade].id);
+            rlBlitFramebuffer(0, 0, shadowRes, shadowRes, 0, 0, shadowRes, shadowRes, 0x00000100); // GL_DEPTH_BUFFER_BIT
+            rlDisableFramebuffer();
+            break;
+        case RenderOp::BeginMain:
+            BeginDrawing();
+            ClearBackground(RAYWHITE);
+            BeginMode3D(list.views[c.arg]);
+            break;
+        case RenderOp::DrawSky:
+            drawSky(list.uniforms);
+            break;
+        case RenderOp::BeginLit:
+            beginLit(list.uniforms);
+            break;
+        case RenderOp::DrawInstances: {
+            // color doesn't matter in shadow passes; depth-only framebuffers keep depth
+            const bool blend = (c.flags & kDrawBlendAlpha) != 0;
+            if (blend) { BeginBlendMode(BLEND_ALPHA); rlDisableDepthMask(); }
+            DrawMeshInstances(cube, lit, WHITE, buffers[c.buffer].vbo, (int)c.first, (int)c.count);
+            if (blend) { rlEnableDepthMask(); EndBlendMode(); }
+            break;
+        }
+        case RenderOp::UploadMesh:
+            uploadMesh(c.arg, &list.vertices[c.first], c.count);
+            break;
+        case RenderOp::FreeMesh:
+            freeMesh(c.arg);
+            break;
+        case RenderOp::DrawMesh:
+            if (c.arg < meshes.size()) DrawStaticMesh(litStatic, meshes[c.arg].vao, (int)c.count);
+            break;
+        case RenderOp::EndMain:
+            if (kCullBackFace) rlDisableBackfaceCulling();
+            EndMode3D();
+            drawOverlay();
+            EndDrawing();
+            break;
+        case RenderOp::Count:
+            break;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <raylib.h>
+#include <cstdint>
+#include <vector>
+#include "bootstrap/rendering/RenderBackend.h"
+
+// Replays command lists through raylib/rlgl: the instanced lit shader with
+// cascaded shadow maps, merged static meshes, the sky, and the stats overlay. Owns every GL object
+// the renderer uses; creates them on first Execute. GL thread only, and
+// Release() must run while the context is alive.
+class RlglBackend : public RenderBackend {
+public:
+    void Execute(const RenderCommandList& list) override;
+    void Release() override;
+
+private:
+    struct LitLocations {
+        int viewPos, sunDir, sky, ground, hemi, sun, ambient;
+        int spec, shiny, fresnel, ao, groundY, exposure, transition;
+        int lightVP[3], shadowMap[3], normalBias[3], splits;
+        int shadowRes, pcfStep, biasMin, biasMax;
+    };
+    struct GpuInstances { unsigned int vbo{0}; uint32_t capacity{0}; };
+    struct GpuMesh { unsigned int vao{0}, vbo{0}; };
+
+    static LitLocations findLitLocations(const Shader& s);
+    static void setLitUniforms(const Shader& s, const LitLocations& l, const FrameUniforms& u);
+    void ensureResources(int shadowRes);
+    void uploadMesh(uint32_t id, const StaticVertex* vertices, uint32_t count);
+    void freeMesh(uint32_t id);
+    void drawSky(const FrameUniforms& u);
+    void beginLit(const FrameUniforms& u);
+    void drawOverlay();
+
+    Shader lit{};
+    LitLocations litLoc{};
+    Shader litStatic{};   // same lighting, world-space vertices with colour
+    LitLocations staticLoc{};
+    Shader sky{};
+    int skyInner{-1}, skyOuter{-1};
+    Model partModel{};  // unit cube for all parts
+    Model skyModel{};
+    RenderTexture2D shadowLive[3]{};    // sampled by the main pass
+    RenderTexture2D shadowStatic[3]{};  // cached static depth, copied into shadowLive
+    int shadowRes{0};
+    GpuInstances buffers[kBufCount];
+    std::vector<GpuMesh> meshes;    // by mesh id
+    unsigned int quadIndices{0};    // shared by every mesh
+};
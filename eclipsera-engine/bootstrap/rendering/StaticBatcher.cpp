@@ -0,0 +1,320 @@
+#include "bootstrap/rendering/StaticBatcher.h"
+#include "bootstrap/rendering/RenderScene.h"
+#include "core/runtime/TaskScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static_assert(sizeof(StaticVertex) == 28, "static vertices are uploaded as-is");
+
+// Faces are tested from a point this far outside their centre; anything merged
+// that contains the point and the whole face rectangle covers the face.
+static constexpr float kProbe = 0.02f;
+static constexpr float kRectTolerance = 0.01f;
+// occluder lookup grid; boxes spanning more cells than kMaxOccluderCells are tested by every face
+static constexpr float  kOccluderGrid     = 4.0f;
+static constexpr size_t kMaxOccluderCells = 256;
+// past this many changed footprints every cell is rebuilt instead of testing each
+static constexpr size_t kMaxChangedBoxes  = 256;
+
+static inline uint64_t PackCellKey(int32_t x, int32_t y, int32_t z) {
+    auto u = [](int32_t v){ return (uint64_t)(uint32_t)(v + (1 << 20)) & 0x1FFFFFu; };
+    return (u(x) << 42) | (u(y) << 21) | u(z);
+}
+
+static inline float Axis(const Vector3& v, int a) { return a == 0 ? v.x : a == 1 ? v.y : v.z; }
+
+// Rotation columns that each point along one world axis: the box is its own AABB.
+static bool IsAxisAligned(const Matrix& m) {
+    const float cols[3][3] = { { m.m0, m.m1, m.m2 }, { m.m4, m.m5, m.m6 }, { m.m8, m.m9, m.m10 } };
+    for (const auto& c : cols) {
+        const float len = std::fabs(c[0]) + std::fabs(c[1]) + std::fabs(c[2]);
+        int axes = 0;
+        for (float x : c) axes += std::fabs(x) > 1e-4f * len;
+        if (axes != 1) return false;
+    }
+    return true;
+}
+
+// Merged axis-aligned boxes, bucketed by the occluder grid cells they overlap.
+namespace {
+struct OccluderIndex {
+    std::vector<std::pair<uint64_t, uint32_t>> entries;  // (grid key, slot), sorted
+    std::vector<uint32_t> large;
+
+    static int32_t GridCoord(float v) { return (int32_t)std::floor(v / kOccluderGrid); }
+
+    void Insert(const RenderProxy& rp, uint32_t slot) {
+        const Vector3 lo = { rp.center.x - rp.extents.x, rp.center.y - rp.extents.y, rp.center.z - rp.extents.z };
+        const Vector3 hi = { rp.center.x + rp.extents.x, rp.center.y + rp.extents.y, rp.center.z + rp.extents.z };
+        const int32_t x0 = GridCoord(lo.x), y0 = GridCoord(lo.y), z0 = GridCoord(lo.z);
+        const int32_t x1 = GridCoord(hi.x), y1 = GridCoord(hi.y), z1 = GridCoord(hi.z);
+        const size_t span = (size_t)(x1 - x0 + 1) * (size_t)(y1 - y0 + 1) * (size_t)(z1 - z0 + 1);
+        if (span > kMaxOccluderCells) { large.push_back(slot); return; }
+        for (int32_t x = x0; x <= x1; ++x)
+            for (int32_t y = y0; y <= y1; ++y)
+                for (int32_t z = z0; z <= z1; ++z) entries.push_back({ PackCellKey(x, y, z), slot });
+    }
+    void Finish() { std::sort(entries.begin(), entries.end()); }
+
+    template <class Fn>
+    bool Any(Vector3 p, Fn&& fn) const {
+        const uint64_t key = PackCellKey(GridCoord(p.x), GridCoord(p.y), GridCoord(p.z));
+        auto it = std::lower_bound(entries.begin(), entries.end(), std::make_pair(key, 0u));
+        for (; it != entries.end() && it->first == key; ++it) if (fn(it->second)) return true;
+        for (uint32_t s : large) if (fn(s)) return true;
+        return false;
+    }
+};
+
+struct CellBuild {
+    std::vector<StaticVertex> vertices;
+    uint32_t hidden{0};
+    Vector3  lo{}, hi{};
+};
+}
+
+// Append the six faces of one part, minus those a merged neighbour covers.
+static void EmitPartFaces(const std::vector<RenderProxy>& proxies, uint32_t slot,
+                          const OccluderIndex& occluders, CellBuild& out) {
+    const RenderProxy& rp = proxies[slot];
+    const Matrix& m = rp.xform;
+    const Vector3 col[3] = { { m.m0, m.m1, m.m2 }, { m.m4, m.m5, m.m6 }, { m.m8, m.m9, m.m10 } };
+    const Vector3 origin = { m.m12, m.m13, m.m14 };
+    const bool aligned = IsAxisAligned(m);
+    const Color color = ColorFromKey(rp.colorKey);
+
+    auto local = [&](float x, float y, float z) {
+        return Vector3{ origin.x + col[0].x*x + col[1].x*y + col[2].x*z,
+                        origin.y + col[0].y*x + col[1].y*y + col[2].y*z,
+                        origin.z + col[0].z*x + col[1].z*y + col[2].z*z };
+    };
+
+    for (int a = 0; a < 3; ++a) {
+        const float len = std::sqrt(col[a].x*col[a].x + col[a].y*col[a].y + col[a].z*col[a].z);
+        for (int s = -1; s <= 1; s += 2) {
+            // corners counter-clockwise seen from outside: tangents (t1, t2) with t1 x t2 = normal
+            const int u = (a + 1) % 3, v = (a + 2) % 3;
+            const int t1 = s > 0 ? u : v, t2 = s > 0 ? v : u;
+            Vector3 c[4];
+            const float d1[4] = { -0.5f, 0.5f, 0.5f, -0.5f }, d2[4] = { -0.5f, -0.5f, 0.5f, 0.5f };
+            for (int k = 0; k < 4; ++k) {
+                float l[3] = { 0, 0, 0 };
+                l[a] = 0.5f * s; l[t1] = d1[k]; l[t2] = d2[k];
+                c[k] = local(l[0], l[1], l[2]);
+            }
+            const float inv = len > 0.0f ? (float)s / len : 0.0f;
+            const Vector3 n = { col[a].x * inv, col[a].y * inv, col[a].z * inv };
+
+            if (aligned) {
+                const int w = std::fabs(n.x) > 0.5f ? 0 : std::fabs(n.y) > 0.5f ? 1 : 2;
+                const int wu = (w + 1) % 3, wv = (w + 2) % 3;
+                float rlo[3], rhi[3];
+                for (int i = 0; i < 3; ++i) {
+                    rlo[i] = std::min({ Axis(c[0], i), Axis(c[1], i), Axis(c[2], i), Axis(c[3], i) });
+                    rhi[i] = std::max({ Axis(c[0], i), Axis(c[1], i), Axis(c[2], i), Axis(c[3], i) });
+                }
+                const Vector3 probe = { 0.25f * (c[0].x + c[1].x + c[2].x + c[3].x) + n.x * kProbe,
+                                        0.25f * (c[0].y + c[1].y + c[2].y + c[3].y) + n.y * kProbe,
+                                        0.25f * (c[0].z + c[1].z + c[2].z + c[3].z) + n.z * kProbe };
+                const bool covered = occluders.Any(probe, [&](uint32_t o){
+                    if (o == slot) return false;
+                    const RenderProxy& b = proxies[o];
+                    for (int i = 0; i < 3; ++i) {
+                        const float bc = Axis(b.center, i), be = Axis(b.extents, i), p = Axis(probe, i);
+                        if (p < bc - be || p > bc + be) return false;
+                    }
+                    for (int i : { wu, wv }) {
+                        const float bc = Axis(b.center, i), be = Axis(b.extents, i);
+                        if (bc - be > rlo[i] + kRectTolerance || bc + be < rhi[i] - kRectTolerance) return false;
+                    }
+                    return true;
+                });
+                if (covered) { ++out.hidden; continue; }
+            }
+            for (const Vector3& p : c) out.vertices.push_back({ p, n, color });
+        }
+    }
+}
+
+// -------- membership --------
+uint32_t StaticBatcher::cellFor(Vector3 p) {
+    const int32_t x = (int32_t)std::floor(p.x / kCellSize);
+    const int32_t y = (int32_t)std::floor(p.y / kCellSize);
+    const int32_t z = (int32_t)std::floor(p.z / kCellSize);
+    auto [it, inserted] = cellIndex.try_emplace(PackCellKey(x, y, z), (uint32_t)cells.size());
+    if (inserted) cells.emplace_back();
+    return it->second;
+}
+
+void StaticBatcher::markChanged(const RenderProxy& rp) {
+    if (allChanged) return;
+    if (changed.size() >= kMaxChangedBoxes) { changed.clear(); allChanged = true; return; }
+    changed.push_back({ { rp.center.x - rp.extents.x, rp.center.y - rp.extents.y, rp.center.z - rp.extents.z },
+                        { rp.center.x + rp.extents.x, rp.center.y + rp.extents.y, rp.center.z + rp.extents.z } });
+}
+
+void StaticBatcher::Add(std::vector<RenderProxy>& proxies, uint32_t slot) {
+    RenderProxy& rp = proxies[slot];
+    rp.cell = cellFor(rp.center);
+    Cell& c = cells[rp.cell];
+    const Vector3 lo = { rp.center.x - rp.extents.x, rp.center.y - rp.extents.y, rp.center.z - rp.extents.z };
+    const Vector3 hi = { rp.center.x + rp.extents.x, rp.center.y + rp.extents.y, rp.center.z + rp.extents.z };
+    if (c.members.empty()) { c.lo = lo; c.hi = hi; }
+    else {
+        c.lo = { std::min(c.lo.x, lo.x), std::min(c.lo.y, lo.y), std::min(c.lo.z, lo.z) };
+        c.hi = { std::max(c.hi.x, hi.x), std::max(c.hi.y, hi.y), std::max(c.hi.z, hi.z) };
+    }
+    rp.member = (uint32_t)c.members.size();
+    c.members.push_back(slot);
+    c.dirty = true;
+    markChanged(rp);
+    ++stats.parts;
+}
+
+void StaticBatcher::Remove(std::vector<RenderProxy>& proxies, uint32_t slot) {
+    RenderProxy& rp = proxies[slot];
+    Cell& c = cells[rp.cell];
+    const uint32_t last = (uint32_t)c.members.size() - 1;
+    if (rp.member != last) {
+        const uint32_t moved = c.members[last];
+        c.members[rp.member] = moved;
+        proxies[moved].member = rp.member;
+    }
+    c.members.pop_back();
+    c.dirty = true;
+    markChanged(rp);
+    rp.cell = kNoCell;
+    --stats.parts;
+}
+
+void StaticBatcher::Touch(const RenderProxy& rp) { cells[rp.cell].dirty = true; }
+
+void StaticBatcher::Renumber(const RenderProxy& rp, uint32_t slot) { cells[rp.cell].members[rp.member] = slot; }
+
+void StaticBatcher::Clear() {
+    for (Cell& c : cells)
+        for (uint32_t id : c.chunks) { pendingFree.push_back(id); chunkBounds.Clear(id); chunkQuads[id] = 0; }
+    cells.clear();
+    cellIndex.clear();
+    changed.clear();
+    allChanged = false;
+    const uint32_t rebuilt = stats.cellsRebuilt;
+    const float ms = stats.rebuildMs;
+    stats = Stats{};
+    stats.cellsRebuilt = rebuilt;
+    stats.rebuildMs = ms;
+}
+
+uint32_t StaticBatcher::allocMesh() {
+    if (!freeMeshes.empty()) { const uint32_t id = freeMeshes.back(); freeMeshes.pop_back(); return id; }
+    chunkQuads.push_back(0);
+    chunkBounds.Reserve(meshCount + 1);
+    return meshCount++;
+}
+
+// -------- rebuild --------
+size_t StaticBatcher::EmitUploads(const std::vector<RenderProxy>& proxies, RenderCommandList& list) {
+    for (uint32_t id : pendingFree) { list.Push(RenderOp::FreeMesh, 0, 0, 0, id); freeMeshes.push_back(id); }
+    pendingFree.clear();
+
+    // cells whose members a changed footprint can cover (or uncover)
+    if (allChanged || !changed.empty()) {
+        for (Cell& c : cells) {
+            if (c.dirty || c.members.empty()) continue;
+            if (allChanged) { c.dirty = true; continue; }
+            for (const Box& b : changed) {
+                if (b.lo.x > c.hi.x + kProbe || b.hi.x < c.lo.x - kProbe) continue;
+                if (b.lo.y > c.hi.y + kProbe || b.hi.y < c.lo.y - kProbe) continue;
+                if (b.lo.z > c.hi.z + kProbe || b.hi.z < c.lo.z - kProbe) continue;
+                c.dirty = true;
+                break;
+            }
+        }
+        changed.clear();
+        allChanged = false;
+    }
+
+    static std::vector<uint32_t> dirty;
+    dirty.clear();
+    for (uint32_t i = 0; i < cells.size(); ++i) if (cells[i].dirty) dirty.push_back(i);
+    if (dirty.empty()) return 0;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    OccluderIndex occluders;
+    for (const Cell& c : cells)
+        for (uint32_t s : c.members)
+            if (IsAxisAligned(proxies[s].xform)) occluders.Insert(proxies[s], s);
+    occluders.Finish();
+
+    static std::vector<CellBuild> builds;
+    if (builds.size() < dirty.size()) builds.resize(dirty.size());
+    TaskScheduler::Get().ParallelFor(dirty.size(), 1, [&](size_t b, size_t e){
+        for (size_t k = b; k < e; ++k) {
+            const Cell& c = cells[dirty[k]];
+            CellBuild& out = builds[k];
+            out.vertices.clear();
+            out.hidden = 0;
+            for (uint32_t s : c.members) EmitPartFaces(proxies, s, occluders, out);
+            for (size_t i = 0; i < c.members.size(); ++i) {
+                const RenderProxy& rp = proxies[c.members[i]];
+                const Vector3 lo = { rp.center.x - rp.extents.x, rp.center.y - rp.extents.y, rp.center.z - rp.extents.z };
+                const Vector3 hi = { rp.center.x + rp.extents.x, rp.center.y + rp.extents.y, rp.center.z + rp.extents.z };
+                if (i == 0) { out.lo = lo; out.hi = hi; continue; }
+                out.lo = { std::min(out.lo.x, lo.x), std::min(out.lo.y, lo.y), std::min(out.lo.z, lo.z) };
+                out.hi = { std::max(out.hi.x, hi.x), std::max(out.hi.y, hi.y), std::max(out.hi.z, hi.z) };
+            }
+        }
+    });
+
+    size_t bytes = 0;
+    for (size_t k = 0; k < dirty.size(); ++k) {
+        Cell& c = cells[dirty[k]];
+        const CellBuild& out = builds[k];
+        const uint32_t quads = (uint32_t)(out.vertices.size() / 4);
+        const uint32_t chunks = (quads + kMaxQuadsPerChunk - 1) / kMaxQuadsPerChunk;
+
+        stats.quads       += quads - c.quads;
+        stats.hiddenQuads += out.hidden - c.hidden;
+        stats.chunks      += chunks - (uint32_t)c.chunks.size();
+        c.quads = quads; c.hidden = out.hidden;
+        c.lo = out.lo; c.hi = out.hi;
+        c.dirty = false;
+
+        while (c.chunks.size() > chunks) {
+            const uint32_t id = c.chunks.back();
+            c.chunks.pop_back();
+            list.Push(RenderOp::FreeMesh, 0, 0, 0, id);
+            chunkBounds.Clear(id);
+            chunkQuads[id] = 0;
+            freeMeshes.push_back(id);
+        }
+        while (c.chunks.size() < chunks) c.chunks.push_back(allocMesh());
+
+        for (uint32_t i = 0; i < chunks; ++i) {
+            const uint32_t id = c.chunks[i];
+            const uint32_t q0 = i * kMaxQuadsPerChunk, n = std::min(kMaxQuadsPerChunk, quads - q0);
+            const StaticVertex* v = out.vertices.data() + (size_t)q0 * 4;
+            Vector3 lo = v[0].position, hi = v[0].position;
+            for (uint32_t j = 1; j < n * 4; ++j) {
+                const Vector3 p = v[j].position;
+                lo = { std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z) };
+                hi = { std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z) };
+            }
+            chunkBounds.Set(id, { 0.5f*(lo.x + hi.x), 0.5f*(lo.y + hi.y), 0.5f*(lo.z + hi.z) },
+                                { 0.5f*(hi.x - lo.x), 0.5f*(hi.y - lo.y), 0.5f*(hi.z - lo.z) });
+            chunkQuads[id] = n;
+
+            const uint32_t offset = (uint32_t)list.vertices.size();
+            list.vertices.insert(list.vertices.end(), v, v + (size_t)n * 4);
+            list.Push(RenderOp::UploadMesh, 0, offset, n * 4, id);
+            bytes += (size_t)n * 4 * sizeof(StaticVertex);
+        }
+    }
+
+    stats.cells = 0;
+    for (const Cell& c : cells) stats.cells += !c.members.empty();
+    stats.cellsRebuilt = (uint32_t)dirty.size();
+    stats.rebuildMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return bytes;
+}
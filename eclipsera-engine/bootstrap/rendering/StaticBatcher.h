@@ -0,0 +1,76 @@
+#pragma once
+#include <raylib.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "bootstrap/rendering/Frustum.h"
+#include "bootstrap/rendering/RenderCommands.h"
+
+struct RenderProxy;
+
+// Merges static opaque parts into world-space meshes, one set per grid cell,
+// so a settled map is drawn with a few large draws instead of one instance per
+// part. Faces covered by another merged axis-aligned box (touching or slightly
+// overlapping, as builders leave them) are dropped. A cell is rebuilt on the
+// next EmitUploads when a member joins, leaves or changes colour, or when a
+// merged box near its members does. Each cell's quads are split into chunks
+// that fit 16-bit indices; a chunk is one backend mesh, addressed by id.
+class StaticBatcher {
+public:
+    static constexpr float    kCellSize         = 64.0f;
+    static constexpr uint32_t kMaxQuadsPerChunk = 16383;  // 4 vertices each, 16-bit indices
+    static constexpr uint32_t kNoCell           = 0xFFFFFFFFu;
+
+    struct Stats {
+        uint32_t parts{0};          // merged parts
+        uint32_t cells{0};          // cells holding them
+        uint32_t chunks{0};         // meshes they are drawn with
+        uint32_t quads{0};          // faces kept
+        uint32_t hiddenQuads{0};    // faces dropped as covered
+        uint32_t cellsRebuilt{0};   // by the last EmitUploads that rebuilt anything
+        float    rebuildMs{0.0f};
+    };
+
+    // Membership follows RenderProxy::cell/member; slots are the caller's proxy slots.
+    void Add(std::vector<RenderProxy>& proxies, uint32_t slot);
+    void Remove(std::vector<RenderProxy>& proxies, uint32_t slot);
+    void Touch(const RenderProxy& rp);  // colour changed; geometry is unchanged
+    void Renumber(const RenderProxy& rp, uint32_t slot);  // rp was moved to 'slot'
+    // Forget every member; meshes already sent are freed by the next EmitUploads.
+    void Clear();
+
+    // Rebuild dirty cells (in parallel on the TaskScheduler) and record their mesh
+    // uploads and frees into 'list'; returns the bytes they send.
+    size_t EmitUploads(const std::vector<RenderProxy>& proxies, RenderCommandList& list);
+
+    const PackedBounds& ChunkBounds() const { return chunkBounds; }  // indexed by mesh id
+    uint32_t ChunkIndexCount(uint32_t id) const { return chunkQuads[id] * 6; }
+    const Stats& GetStats() const { return stats; }
+
+private:
+    struct Cell {
+        std::vector<uint32_t> members;  // proxy slots
+        std::vector<uint32_t> chunks;   // mesh ids
+        Vector3  lo{}, hi{};            // union of the members' AABBs, as of the last rebuild or add
+        uint32_t quads{0}, hidden{0};
+        bool     dirty{false};
+    };
+    struct Box { Vector3 lo, hi; };
+
+    uint32_t cellFor(Vector3 p);
+    void markChanged(const RenderProxy& rp);
+    uint32_t allocMesh();
+
+    std::vector<Cell> cells;
+    std::unordered_map<uint64_t, uint32_t> cellIndex;
+    std::vector<Box>      changed;   // footprints that joined or left since the last rebuild
+    bool                  allChanged{false};
+
+    std::vector<uint32_t> freeMeshes;
+    std::vector<uint32_t> pendingFree;  // sent meshes to drop on the next EmitUploads
+    uint32_t              meshCount{0};
+    PackedBounds          chunkBounds;
+    std::vector<uint32_t> chunkQuads;
+    Stats                 stats;
+};
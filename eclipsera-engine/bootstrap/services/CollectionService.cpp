@@ -0,0 +1,302 @@
+#include "bootstrap/services/CollectionService.h"
+#include "bootstrap/Game.h"
+#include "bootstrap/ScriptingAPI.h"
+#include "core/logging/Logging.h"
+#include "lua.h"
+#include "lualib.h"
+#include <cstring>
+#include <unordered_map>
+
+extern void Lua_PushSignal(lua_State* L, const std::shared_ptr<RTScriptSignal>& sig);
+
+namespace {
+
+struct TagIndex {
+    std::string name;
+    std::vector<Instance*> members;   // dense, swap-remove via TagRef::slot
+    std::shared_ptr<RTScriptSignal> added;
+    std::shared_ptr<RTScriptSignal> removed;
+};
+
+struct TagRegistry {
+    std::unordered_map<std::string, uint16_t> ids;
+    std::vector<TagIndex> tags;
+};
+
+// leaked on purpose: instances may still unindex themselves during static teardown
+TagRegistry& reg() {
+    static TagRegistry* r = new TagRegistry();
+    return *r;
+}
+
+Instance::TagRef* findRef(Instance* inst, uint16_t id) {
+    for (auto& t : inst->Tags) if (t.id == id) return &t;
+    return nullptr;
+}
+
+LuaScheduler* scheduler() {
+    return (g_game && g_game->luaScheduler) ? g_game->luaScheduler.get() : nullptr;
+}
+
+void fireTagSignal(const std::shared_ptr<RTScriptSignal>& sig, Instance* inst) {
+    if (!sig || sig->IsClosed()) return;
+    LuaScheduler* sch = scheduler();
+    lua_State* Lm = sch ? sch->GetMainState() : nullptr;
+    if (!Lm) return;
+    Lua_PushInstance(Lm, inst->shared_from_this());
+    sig->Fire(Lm, lua_gettop(Lm), 1);
+    lua_pop(Lm, 1);
+}
+
+void indexInsert(Instance* inst, Instance::TagRef& ref) {
+    if (ref.slot != Instance::TagRef::npos) return;
+    auto& ti = reg().tags[ref.id];
+    ref.slot = (uint32_t)ti.members.size();
+    ti.members.push_back(inst);
+}
+
+void indexErase(Instance* inst, Instance::TagRef& ref) {
+    if (ref.slot == Instance::TagRef::npos) return;
+    auto& ti = reg().tags[ref.id];
+    const uint32_t slot = ref.slot;
+    Instance* last = ti.members.back();
+    ti.members[slot] = last;
+    ti.members.pop_back();
+    if (last != inst) {
+        if (auto* lr = findRef(last, ref.id)) lr->slot = slot;
+    }
+    ref.slot = Instance::TagRef::npos;
+}
+
+} // namespace
+
+// ---------------- interning ----------------
+uint16_t CollectionService::InternTag(const std::string& name) {
+    auto& r = reg();
+    auto it = r.ids.find(name);
+    if (it != r.ids.end()) return it->second;
+    if (r.tags.size() >= kInvalidTag) {
+        LOGW("CollectionService: tag limit reached, ignoring '%s'", name.c_str());
+        return kInvalidTag;
+    }
+    const uint16_t id = (uint16_t)r.tags.size();
+    r.tags.push_back(TagIndex{ name, {}, nullptr, nullptr });
+    r.ids.emplace(name, id);
+    return id;
+}
+
+uint16_t CollectionService::FindTag(const std::string& name) {
+    auto& r = reg();
+    auto it = r.ids.find(name);
+    return it == r.ids.end() ? kInvalidTag : it->second;
+}
+
+const std::string& CollectionService::TagName(uint16_t id) {
+    static const std::string empty;
+    auto& r = reg();
+    return id < r.tags.size() ? r.tags[id].name : empty;
+}
+
+size_t CollectionService::TagCount() { return reg().tags.size(); }
+
+// ---------------- membership ----------------
+bool CollectionService::IsInDataModel(const Instance* inst) {
+    for (auto p = inst; p; ) {
+        if (p->Class == InstanceClass::Game) return true;
+        auto sp = p->Parent.lock();
+        p = sp.get();
+    }
+    return false;
+}
+
+bool CollectionService::AddTag(Instance* inst, const std::string& tag) {
+    if (!inst || tag.empty()) return false;
+    const uint16_t id = InternTag(tag);
+    if (id == kInvalidTag || findRef(inst, id)) return false;
+
+    inst->Tags.push_back(Instance::TagRef{ id, Instance::TagRef::npos });
+    if (inst->Alive && IsInDataModel(inst)) {
+        indexInsert(inst, inst->Tags.back());
+        fireTagSignal(reg().tags[id].added, inst);
+    }
+    return true;
+}
+
+bool CollectionService::RemoveTag(Instance* inst, const std::string& tag) {
+    if (!inst) return false;
+    const uint16_t id = FindTag(tag);
+    if (id == kInvalidTag) return false;
+    for (size_t i = 0; i < inst->Tags.size(); ++i) {
+        if (inst->Tags[i].id != id) continue;
+        const bool wasIndexed = inst->Tags[i].slot != Instance::TagRef::npos;
+        indexErase(inst, inst->Tags[i]);
+        inst->Tags[i] = inst->Tags.back();
+        inst->Tags.pop_back();
+        if (wasIndexed) fireTagSignal(reg().tags[id].removed, inst);
+        return true;
+    }
+    return false;
+}
+
+bool CollectionService::HasTag(const Instance* inst, const std::string& tag) {
+    if (!inst) return false;
+    const uint16_t id = FindTag(tag);
+    if (id == kInvalidTag) return false;
+    for (const auto& t : inst->Tags) if (t.id == id) return true;
+    return false;
+}
+
+std::vector<std::string> CollectionService::GetTags(const Instance* inst) {
+    std::vector<std::string> out;
+    if (!inst) return out;
+    out.reserve(inst->Tags.size());
+    for (const auto& t : inst->Tags) out.push_back(TagName(t.id));
+    return out;
+}
+
+const std::vector<Instance*>& CollectionService::GetTagged(uint16_t id) {
+    static const std::vector<Instance*> none;
+    auto& r = reg();
+    return id < r.tags.size() ? r.tags[id].members : none;
+}
+
+std::shared_ptr<RTScriptSignal> CollectionService::GetInstanceAddedSignal(uint16_t id) {
+    auto& r = reg();
+    if (id >= r.tags.size()) return nullptr;
+    auto& ti = r.tags[id];
+    if (!ti.added) ti.added = std::make_shared<RTScriptSignal>(scheduler());
+    return ti.added;
+}
+
+std::shared_ptr<RTScriptSignal> CollectionService::GetInstanceRemovedSignal(uint16_t id) {
+    auto& r = reg();
+    if (id >= r.tags.size()) return nullptr;
+    auto& ti = r.tags[id];
+    if (!ti.removed) ti.removed = std::make_shared<RTScriptSignal>(scheduler());
+    return ti.removed;
+}
+
+void CollectionService::OnAncestryChanged(Instance* root, bool inDataModel) {
+    if (!root || reg().tags.empty()) return;
+
+    // collect first: signal handlers may reparent things while we walk
+    std::vector<std::shared_ptr<Instance>> touched;
+    std::vector<Instance*> stack{ root };
+    while (!stack.empty()) {
+        Instance* n = stack.back(); stack.pop_back();
+        if (!n->Tags.empty()) touched.push_back(n->shared_from_this());
+        for (auto& ch : n->Children) if (ch) stack.push_back(ch.get());
+    }
+
+    for (auto& sp : touched) {
+        Instance* n = sp.get();
+        for (size_t i = 0; i < n->Tags.size(); ++i) {
+            auto& ref = n->Tags[i];
+            const uint16_t id = ref.id;
+            if (inDataModel && n->Alive) {
+                if (ref.slot != Instance::TagRef::npos) continue;
+                indexInsert(n, ref);
+                fireTagSignal(reg().tags[id].added, n);
+            } else {
+                if (ref.slot == Instance::TagRef::npos) continue;
+                indexErase(n, ref);
+                fireTagSignal(reg().tags[id].removed, n);
+            }
+        }
+    }
+}
+
+void CollectionService::Forget(Instance* inst) {
+    if (!inst) return;
+    for (auto& ref : inst->Tags) indexErase(inst, ref);
+}
+
+// ---------------- Lua ----------------
+static Instance* checkInstanceArg(lua_State* L, int idx) {
+    auto* p = static_cast<std::shared_ptr<Instance>*>(luaL_checkudata(L, idx, "Librebox.Instance"));
+    if (!p || !*p) { luaL_error(L, "expected Instance"); return nullptr; }
+    return p->get();
+}
+
+static int l_cs_addtag(lua_State* L) {
+    Instance* inst = checkInstanceArg(L, 2);
+    CollectionService::AddTag(inst, luaL_checkstring(L, 3));
+    return 0;
+}
+
+static int l_cs_removetag(lua_State* L) {
+    Instance* inst = checkInstanceArg(L, 2);
+    CollectionService::RemoveTag(inst, luaL_checkstring(L, 3));
+    return 0;
+}
+
+static int l_cs_hastag(lua_State* L) {
+    Instance* inst = checkInstanceArg(L, 2);
+    lua_pushboolean(L, CollectionService::HasTag(inst, luaL_checkstring(L, 3)));
+    return 1;
+}
+
+static int l_cs_gettags(lua_State* L) {
+    Instance* inst = checkInstanceArg(L, 2);
+    lua_createtable(L, (int)inst->Tags.size(), 0);
+    int i = 1;
+    for (const auto& t : inst->Tags) {
+        const auto& n = CollectionService::TagName(t.id);
+        lua_pushlstring(L, n.data(), n.size());
+        lua_rawseti(L, -2, i++);
+    }
+    return 1;
+}
+
+static int l_cs_gettagged(lua_State* L) {
+    const uint16_t id = CollectionService::FindTag(luaL_checkstring(L, 2));
+    const auto& members = CollectionService::GetTagged(id);
+    lua_createtable(L, (int)members.size(), 0);
+    int i = 1;
+    for (Instance* m : members) {
+        Lua_PushInstance(L, m->shared_from_this());
+        lua_rawseti(L, -2, i++);
+    }
+    return 1;
+}
+
+static int l_cs_getalltags(lua_State* L) {
+    const size_t n = CollectionService::TagCount();
+    lua_createtable(L, (int)n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        const auto& s = CollectionService::TagName((uint16_t)i);
+        lua_pushlstring(L, s.data(), s.size());
+        lua_rawseti(L, -2, (int)i + 1);
+    }
+    return 1;
+}
+
+static int l_cs_addedsignal(lua_State* L) {
+    const uint16_t id = CollectionService::InternTag(luaL_checkstring(L, 2));
+    Lua_PushSignal(L, CollectionService::GetInstanceAddedSignal(id));
+    return 1;
+}
+
+static int l_cs_removedsignal(lua_State* L) {
+    const uint16_t id = CollectionService::InternTag(luaL_checkstring(L, 2));
+    Lua_PushSignal(L, CollectionService::GetInstanceRemovedSignal(id));
+    return 1;
+}
+
+CollectionService::CollectionService() : Service("CollectionService", InstanceClass::CollectionService) {}
+
+bool CollectionService::LuaGet(lua_State* L, const char* k) const {
+    if (!strcmp(k, "AddTag"))                    { lua_pushcfunction(L, l_cs_addtag,        "AddTag");                    return true; }
+    if (!strcmp(k, "RemoveTag"))                 { lua_pushcfunction(L, l_cs_removetag,     "RemoveTag");                 return true; }
+    if (!strcmp(k, "HasTag"))                    { lua_pushcfunction(L, l_cs_hastag,        "HasTag");                    return true; }
+    if (!strcmp(k, "GetTags"))                   { lua_pushcfunction(L, l_cs_gettags,       "GetTags");                   return true; }
+    if (!strcmp(k, "GetTagged"))                 { lua_pushcfunction(L, l_cs_gettagged,     "GetTagged");                 return true; }
+    if (!strcmp(k, "GetAllTags"))                { lua_pushcfunction(L, l_cs_getalltags,    "GetAllTags");                return true; }
+    if (!strcmp(k, "GetInstanceAddedSignal"))    { lua_pushcfunction(L, l_cs_addedsignal,   "GetInstanceAddedSignal");    return true; }
+    if (!strcmp(k, "GetInstanceRemovedSignal"))  { lua_pushcfunction(L, l_cs_removedsignal, "GetInstanceRemovedSignal");  return true; }
+    return false;
+}
+
+static Instance::Registrar s_regCollectionService("CollectionService", [] {
+    return std::make_shared<CollectionService>();
+});
@@ -0,0 +1,47 @@
+#pragma once
+#include "bootstrap/services/Service.h"
+#include "bootstrap/signals/Signal.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct lua_State;
+
+// Tag registry. Tag names are interned to small ids; every tag keeps a dense
+// member list of the tagged instances that currently live under the DataModel.
+// Instances remember their slot in that list (Instance::TagRef), so add/remove
+// is O(1) swap-remove and GetTagged costs O(members), never O(world).
+struct CollectionService : Service {
+    static constexpr uint16_t kInvalidTag = 0xFFFF;
+
+    CollectionService();
+
+    bool LuaGet(lua_State* L, const char* key) const override;
+
+    // -------- interning --------
+    static uint16_t InternTag(const std::string& name);
+    static uint16_t FindTag(const std::string& name);   // kInvalidTag if never used
+    static const std::string& TagName(uint16_t id);
+    static size_t TagCount();
+
+    // -------- tagging --------
+    static bool AddTag(Instance* inst, const std::string& tag);
+    static bool RemoveTag(Instance* inst, const std::string& tag);
+    static bool HasTag(const Instance* inst, const std::string& tag);
+    static std::vector<std::string> GetTags(const Instance* inst);
+
+    // members currently under the DataModel (empty for unknown ids)
+    static const std::vector<Instance*>& GetTagged(uint16_t id);
+
+    static std::shared_ptr<RTScriptSignal> GetInstanceAddedSignal(uint16_t id);
+    static std::shared_ptr<RTScriptSignal> GetInstanceRemovedSignal(uint16_t id);
+
+    // -------- hooks from Instance --------
+    // Called after 'root' entered (inDataModel=true) or left the DataModel;
+    // walks the subtree and (un)indexes every tagged instance.
+    static void OnAncestryChanged(Instance* root, bool inDataModel);
+    // Drop 'inst' from every member list without firing signals (dtor path).
+    static void Forget(Instance* inst);
+    static bool IsInDataModel(const Instance* inst);
+};
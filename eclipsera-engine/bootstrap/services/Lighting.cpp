@@ -21,11 +21,21 @@ bool Lighting::LuaGet(lua_State* L, const char* k) const {
     return false;
 }
 bool Lighting::LuaSet(lua_State* L, const char* k, int idx) {
-    if (!strcmp(k,"Brightness")) { Brightness = (float)luaL_checknumber(L, idx); return true; }
-    if (!strcmp(k,"ClockTime")) { ClockTime = (float)luaL_checknumber(L, idx); return true; }
+    if (!strcmp(k,"Brightness")) {
+        const double v = (float)luaL_checknumber(L, idx);
+        if (v != Brightness) { Brightness = v; PropertyChanged(PropBit(Prop::Brightness)); }
+        return true;
+    }
+    if (!strcmp(k,"ClockTime")) {
+        const double v = (float)luaL_checknumber(L, idx);
+        if (v != ClockTime) { ClockTime = v; PropertyChanged(PropBit(Prop::ClockTime)); }
+        return true;
+    }
     if (!strcmp(k,"Ambient")) {
         const auto* c = lb::check<Color3>(L, idx);
+        if (*c == Ambient) return true;
         Ambient = { c->r, c->g, c->b };
+        PropertyChanged(PropBit(Prop::Ambient));
         return true;
     }
     // add others
@@ -0,0 +1,220 @@
+#include "bootstrap/services/PhysicsService.h"
+#include "bootstrap/Game.h"
+#include "bootstrap/instances/BasePart.h"
+#include "core/logging/Logging.h"
+#include "subsystems/physics/PhysicsWorld.h"
+#include "lua.h"
+#include "lualib.h"
+#include <cstring>
+#include <vector>
+
+static_assert(PhysicsService::kMaxGroups == Broadphase::kMaxGroups, "collision groups are broadphase groups");
+
+namespace {
+
+struct GroupRegistry {
+    std::string names[PhysicsService::kMaxGroups];  // empty while free
+    uint32_t    masks[PhysicsService::kMaxGroups];
+
+    GroupRegistry() {
+        names[0] = "Default";
+        for (uint32_t& m : masks) m = ~0u;
+    }
+};
+
+// leaked on purpose, like the other service registries
+GroupRegistry& reg() {
+    static GroupRegistry* r = new GroupRegistry();
+    return *r;
+}
+
+void publish() {
+    PhysicsWorld::Get().SetCollisionGroupMasks(reg().masks);
+}
+
+// a freed id collides with everything again, so reusing it starts clean
+void resetGroup(uint8_t id) {
+    auto& r = reg();
+    r.masks[id] = ~0u;
+    for (uint32_t& m : r.masks) m |= 1u << id;
+}
+
+} // namespace
+
+// ---------------- groups ----------------
+uint8_t PhysicsService::RegisterGroup(const std::string& name) {
+    if (name.empty()) return kInvalidGroup;
+    const uint8_t existing = FindGroup(name);
+    if (existing != kInvalidGroup) return existing;
+    auto& r = reg();
+    for (uint32_t id = 1; id < kMaxGroups; ++id) {
+        if (!r.names[id].empty()) continue;
+        r.names[id] = name;
+        resetGroup((uint8_t)id);
+        publish();
+        return (uint8_t)id;
+    }
+    LOGW("PhysicsService: collision group limit (%u) reached, ignoring '%s'", kMaxGroups, name.c_str());
+    return kInvalidGroup;
+}
+
+bool PhysicsService::UnregisterGroup(const std::string& name) {
+    const uint8_t id = FindGroup(name);
+    if (id == kInvalidGroup || id == 0) return false;
+    reg().names[id].clear();
+    resetGroup(id);
+    publish();
+
+    // parts still naming the id would silently join whatever group takes it next
+    if (!g_game) return true;
+    std::vector<Instance*> stack{ g_game.get() };
+    while (!stack.empty()) {
+        Instance* n = stack.back(); stack.pop_back();
+        if (n->Class == InstanceClass::Part) {
+            auto* p = static_cast<BasePart*>(n);
+            if (p->CollisionGroupId == id) {
+                p->CollisionGroupId = 0;
+                p->PropertyChanged(PropBit(Prop::CollisionGroup));
+            }
+        }
+        for (auto& ch : n->Children) if (ch) stack.push_back(ch.get());
+    }
+    return true;
+}
+
+bool PhysicsService::RenameGroup(const std::string& from, const std::string& to) {
+    const uint8_t id = FindGroup(from);
+    if (id == kInvalidGroup || id == 0 || to.empty() || FindGroup(to) != kInvalidGroup) return false;
+    reg().names[id] = to;
+    return true;
+}
+
+uint8_t PhysicsService::FindGroup(const std::string& name) {
+    if (name.empty()) return kInvalidGroup;
+    auto& r = reg();
+    for (uint32_t id = 0; id < kMaxGroups; ++id)
+        if (r.names[id] == name) return (uint8_t)id;
+    return kInvalidGroup;
+}
+
+const std::string& PhysicsService::GroupName(uint8_t id) {
+    static const std::string empty;
+    return id < kMaxGroups ? reg().names[id] : empty;
+}
+
+bool PhysicsService::IsRegistered(uint8_t id) {
+    return id < kMaxGroups && !reg().names[id].empty();
+}
+
+void PhysicsService::SetCollidable(uint8_t a, uint8_t b, bool collidable) {
+    if (!IsRegistered(a) || !IsRegistered(b)) return;
+    auto& r = reg();
+    const uint32_t ma = r.masks[a], mb = r.masks[b];
+    if (collidable) { r.masks[a] |= 1u << b; r.masks[b] |= 1u << a; }
+    else            { r.masks[a] &= ~(1u << b); r.masks[b] &= ~(1u << a); }
+    if (r.masks[a] != ma || r.masks[b] != mb) publish();
+}
+
+bool PhysicsService::AreCollidable(uint8_t a, uint8_t b) {
+    if (a >= kMaxGroups || b >= kMaxGroups) return false;
+    return (reg().masks[a] >> b) & 1u;
+}
+
+uint32_t PhysicsService::GroupMask(uint8_t id) {
+    return id < kMaxGroups ? reg().masks[id] : 0u;
+}
+
+// ---------------- Lua ----------------
+static uint8_t checkGroup(lua_State* L, int idx) {
+    const char* name = luaL_checkstring(L, idx);
+    const uint8_t id = PhysicsService::FindGroup(name);
+    if (id == PhysicsService::kInvalidGroup) luaL_error(L, "collision group '%s' is not registered", name);
+    return id;
+}
+
+static int l_ps_register(lua_State* L) {
+    const char* name = luaL_checkstring(L, 2);
+    if (!*name) luaL_error(L, "RegisterCollisionGroup: name cannot be empty");
+    if (PhysicsService::RegisterGroup(name) == PhysicsService::kInvalidGroup)
+        luaL_error(L, "RegisterCollisionGroup: cannot have more than %d collision groups", (int)PhysicsService::kMaxGroups);
+    return 0;
+}
+
+static int l_ps_unregister(lua_State* L) {
+    const char* name = luaL_checkstring(L, 2);
+    if (std::strcmp(name, "Default") == 0) luaL_error(L, "UnregisterCollisionGroup: cannot remove the Default group");
+    PhysicsService::UnregisterGroup(name);
+    return 0;
+}
+
+static int l_ps_rename(lua_State* L) {
+    const uint8_t id = checkGroup(L, 2);
+    const char* to = luaL_checkstring(L, 3);
+    if (id == 0) luaL_error(L, "RenameCollisionGroup: cannot rename the Default group");
+    if (!*to) luaL_error(L, "RenameCollisionGroup: name cannot be empty");
+    const uint8_t other = PhysicsService::FindGroup(to);
+    if (other == id) return 0;
+    if (other != PhysicsService::kInvalidGroup) luaL_error(L, "RenameCollisionGroup: '%s' is already registered", to);
+    PhysicsService::RenameGroup(PhysicsService::GroupName(id), to);
+    return 0;
+}
+
+static int l_ps_isregistered(lua_State* L) {
+    lua_pushboolean(L, PhysicsService::FindGroup(luaL_checkstring(L, 2)) != PhysicsService::kInvalidGroup);
+    return 1;
+}
+
+static int l_ps_setcollidable(lua_State* L) {
+    const uint8_t a = checkGroup(L, 2);
+    const uint8_t b = checkGroup(L, 3);
+    luaL_checktype(L, 4, LUA_TBOOLEAN);
+    PhysicsService::SetCollidable(a, b, lua_toboolean(L, 4));
+    return 0;
+}
+
+static int l_ps_arecollidable(lua_State* L) {
+    const uint8_t a = checkGroup(L, 2);
+    const uint8_t b = checkGroup(L, 3);
+    lua_pushboolean(L, PhysicsService::AreCollidable(a, b));
+    return 1;
+}
+
+// { { name = "Default", mask = 0xFFFFFFFF }, ... } in id order
+static int l_ps_getgroups(lua_State* L) {
+    lua_createtable(L, 0, 0);
+    int i = 1;
+    for (uint32_t id = 0; id < PhysicsService::kMaxGroups; ++id) {
+        if (!PhysicsService::IsRegistered((uint8_t)id)) continue;
+        lua_createtable(L, 0, 2);
+        const std::string& n = PhysicsService::GroupName((uint8_t)id);
+        lua_pushlstring(L, n.data(), n.size());
+        lua_setfield(L, -2, "name");
+        lua_pushnumber(L, (double)PhysicsService::GroupMask((uint8_t)id));
+        lua_setfield(L, -2, "mask");
+        lua_rawseti(L, -2, i++);
+    }
+    return 1;
+}
+
+static int l_ps_getmax(lua_State* L) {
+    lua_pushinteger(L, (int)PhysicsService::kMaxGroups);
+    return 1;
+}
+
+PhysicsService::PhysicsService() : Service("PhysicsService", InstanceClass::PhysicsService) {}
+
+bool PhysicsService::LuaGet(lua_State* L, const char* k) const {
+    if (!strcmp(k, "RegisterCollisionGroup"))       { lua_pushcfunction(L, l_ps_register,       "RegisterCollisionGroup");       return true; }
+    if (!strcmp(k, "UnregisterCollisionGroup"))     { lua_pushcfunction(L, l_ps_unregister,     "UnregisterCollisionGroup");     return true; }
+    if (!strcmp(k, "RenameCollisionGroup"))         { lua_pushcfunction(L, l_ps_rename,         "RenameCollisionGroup");         return true; }
+    if (!strcmp(k, "IsCollisionGroupRegistered"))   { lua_pushcfunction(L, l_ps_isregistered,   "IsCollisionGroupRegistered");   return true; }
+    if (!strcmp(k, "CollisionGroupSetCollidable"))  { lua_pushcfunction(L, l_ps_setcollidable,  "CollisionGroupSetCollidable");  return true; }
+    if (!strcmp(k, "CollisionGroupsAreCollidable")) { lua_pushcfunction(L, l_ps_arecollidable,  "CollisionGroupsAreCollidable"); return true; }
+    if (!strcmp(k, "GetRegisteredCollisionGroups")) { lua_pushcfunction(L, l_ps_getgroups,      "GetRegisteredCollisionGroups"); return true; }
+    if (!strcmp(k, "GetMaxCollisionGroups"))        { lua_pushcfunction(L, l_ps_getmax,         "GetMaxCollisionGroups");        return true; }
+    return false;
+}
+
+static Instance::Registrar s_regPhysicsService("PhysicsService", [] {
+    return std::make_shared<PhysicsService>();
+});
@@ -0,0 +1,34 @@
+#pragma once
+#include "bootstrap/services/Service.h"
+#include <cstdint>
+#include <string>
+
+struct lua_State;
+
+// Collision groups. Up to kMaxGroups named groups, each a bit; group g keeps
+// the mask of groups it collides with. Group 0 is "Default" and cannot be
+// removed. Parts store their group id (BasePart::CollisionGroupId), and every
+// change to the masks is pushed to the PhysicsWorld, whose broadphase drops
+// pairs of groups that do not collide before the narrowphase sees them.
+struct PhysicsService : Service {
+    static constexpr uint8_t  kInvalidGroup = 0xFF;
+    static constexpr uint32_t kMaxGroups    = 32;
+
+    PhysicsService();
+
+    bool LuaGet(lua_State* L, const char* key) const override;
+
+    // New groups collide with every group. Registering a name twice returns
+    // the existing id; kInvalidGroup when the name is empty or all ids are used.
+    static uint8_t RegisterGroup(const std::string& name);
+    // Parts under the DataModel that were in the group move to Default.
+    static bool    UnregisterGroup(const std::string& name);
+    static bool    RenameGroup(const std::string& from, const std::string& to);
+    static uint8_t FindGroup(const std::string& name);   // kInvalidGroup if not registered
+    static const std::string& GroupName(uint8_t id);     // empty for free ids
+    static bool    IsRegistered(uint8_t id);
+
+    static void     SetCollidable(uint8_t a, uint8_t b, bool collidable);
+    static bool     AreCollidable(uint8_t a, uint8_t b);
+    static uint32_t GroupMask(uint8_t id);
+};
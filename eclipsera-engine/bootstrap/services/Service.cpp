@@ -9,9 +9,9 @@ Service::Service(std::string name, InstanceClass cls)
     // do not add to registry here; we do it when first accessed
 }
 
-Service::~Service() {
-    registry.erase(Name);
-}
+// The registry owns its services, so one only dies once its entry is gone:
+// erasing here would reenter the map while it is being cleared at exit.
+Service::~Service() = default;
 
 std::shared_ptr<Service> Service::Get(const std::string& name) {
     auto it = registry.find(name);
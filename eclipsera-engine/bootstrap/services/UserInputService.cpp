@@ -40,6 +40,10 @@ static const std::unordered_map<int, const char*> keyNameMap = {
     {KEY_RIGHT_ALT, "RightAlt"}
 };
 
+static bool gNullInput = false;
+
+void UserInputService::SetNullInput(bool on) { gNullInput = on; }
+
 UserInputService::UserInputService() : Service("UserInputService", InstanceClass::UserInputService) {}
 
 void UserInputService::EnsureSignals() const {
@@ -60,7 +64,7 @@ bool UserInputService::LuaGet(lua_State* L, const char* k) const {
     if (!strcmp(k, "MouseMoved"))     { Lua_PushSignal(L, MouseMoved); return true; }
     
     if (!strcmp(k, "MousePosition")) {
-        Vector2 mousePos = GetMousePosition();
+        Vector2 mousePos = gNullInput ? Vector2{ 0.0f, 0.0f } : GetMousePosition();
         lua_createtable(L, 0, 2);
         lua_pushnumber(L, mousePos.x);
         lua_setfield(L, -2, "X");
@@ -69,17 +73,20 @@ bool UserInputService::LuaGet(lua_State* L, const char* k) const {
         return true;
     }
 
-    if (!strcmp(k, "MouseEnabled"))   { lua_pushboolean(L, true); return true; }
-    if (!strcmp(k, "KeyboardEnabled")) { lua_pushboolean(L, true); return true; }
-    if (!strcmp(k, "MouseIconEnabled")) { lua_pushboolean(L, !IsCursorHidden()); return true; }
+    if (!strcmp(k, "MouseEnabled"))   { lua_pushboolean(L, !gNullInput); return true; }
+    if (!strcmp(k, "KeyboardEnabled")) { lua_pushboolean(L, !gNullInput); return true; }
+    if (!strcmp(k, "MouseIconEnabled")) { lua_pushboolean(L, !gNullInput && !IsCursorHidden()); return true; }
     
     return false;
 }
 
 bool UserInputService::LuaSet(lua_State* L, const char* k, int idx) {
     if (!strcmp(k, "MouseIconEnabled")) {
+        if (gNullInput) return true;  // no cursor to show or hide
         bool enabled = lua_toboolean(L, idx);
+        if (enabled == !IsCursorHidden()) return true;
         if (enabled) ShowCursor(); else HideCursor();
+        PropertyChanged(PropBit(Prop::MouseIconEnabled));
         return true;
     }
     return false;
@@ -171,6 +178,7 @@ void UserInputService::PushInputObject(lua_State* L, const char* inputType, cons
 }
 
 void UserInputService::Update() {
+    if (gNullInput) return;
     Vector2 mousePos = GetMousePosition();
 
     // Handle mouse movement
@@ -12,6 +12,9 @@ public:
     bool LuaSet(lua_State* L, const char* k, int idx) override;
     void Update();
 
+    // Headless runs have no window: report no devices and never read raylib input.
+    static void SetNullInput(bool on);
+
 private:
     void EnsureSignals() const;
     void PushInputObject(lua_State* L, const char* inputType, const char* keyName, Vector2 mousePos);
@@ -25,8 +25,10 @@ out vec3 vWPos;
 out vec4 vLS0;
 out vec4 vLS1;
 out vec4 vLS2;
+out vec4 vColor;
 
 void main(){
+    vColor = vec4(1.0); // material colour comes from colDiffuse alone
     mat3 nmat = mat3(transpose(inverse(matModel)));
     vN = normalize(nmat * vertexNormal);
     vec4 worldPos = matModel * vec4(vertexPosition,1.0);
@@ -55,6 +57,8 @@ in vec3 vertexNormal;
 
 // Per-instance model matrix provided as vertex attribute
 in mat4 instanceTransform;
+// Per-instance colour (RGBA8, normalized), multiplied with colDiffuse
+in vec4 instanceColor;
 
 uniform mat4 mvp;
 uniform mat4 lightVP0;
@@ -70,8 +74,10 @@ out vec3 vWPos;
 out vec4 vLS0;
 out vec4 vLS1;
 out vec4 vLS2;
+out vec4 vColor;
 
 void main(){
+    vColor = instanceColor;
     mat3 nmat = mat3(transpose(inverse(instanceTransform)));
     vN = normalize(nmat * vertexNormal);
 
@@ -92,6 +98,46 @@ void main(){
     
 )";
 
+// Merged static geometry: vertices are already in world space and carry their colour
+inline const char* LIT_VS_STATIC = R"(
+
+#version 330
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+in vec4 vertexColor;
+
+uniform mat4 mvp;
+uniform mat4 lightVP0;
+uniform mat4 lightVP1;
+uniform mat4 lightVP2;
+
+uniform float normalBiasWS0;
+uniform float normalBiasWS1;
+uniform float normalBiasWS2;
+
+out vec3 vN;
+out vec3 vWPos;
+out vec4 vLS0;
+out vec4 vLS1;
+out vec4 vLS2;
+out vec4 vColor;
+
+void main(){
+    vColor = vertexColor;
+    vN = vertexNormal;
+
+    vec4 worldPos = vec4(vertexPosition,1.0);
+    vWPos = worldPos.xyz;
+
+    vLS0 = lightVP0 * (worldPos + vec4(vN * normalBiasWS0, 0.0));
+    vLS1 = lightVP1 * (worldPos + vec4(vN * normalBiasWS1, 0.0));
+    vLS2 = lightVP2 * (worldPos + vec4(vN * normalBiasWS2, 0.0));
+
+    gl_Position = mvp * worldPos;
+}
+    
+)";
+
 inline const char* LIT_FS = R"(
 
 #version 330
@@ -100,6 +146,7 @@ in vec3 vWPos;
 in vec4 vLS0;
 in vec4 vLS1;
 in vec4 vLS2;
+in vec4 vColor;
 
 out vec4 FragColor;
 
@@ -236,7 +283,8 @@ void main(){
     float shadow = ShadowBlend(p0, p1, p2, ndl, viewDepth, cascadeSplits);
 
     // Convert material color from sRGB to linear before lighting
-    vec3 base = pow(colDiffuse.rgb, vec3(2.2));
+    vec4 albedo = colDiffuse * vColor;
+    vec3 base = pow(albedo.rgb, vec3(2.2));
 
     // Diffuse sunlight contribution
     float sunTerm = sunStrength * ndl * shadow;
@@ -254,7 +302,7 @@ void main(){
 
     // Gamma correct (linear -> sRGB)
     color = pow(max(color, vec3(0.0)), vec3(1.0/2.2));
-    FragColor = vec4(color, colDiffuse.a);
+    FragColor = vec4(color, albedo.a);
 }
     
 )";
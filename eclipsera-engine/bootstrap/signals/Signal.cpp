@@ -1,11 +1,11 @@
 #include "Signal.h"
 
-RTScriptSignal::RTScriptSignal(LuaScheduler* s) : sched(s) {
+RTScriptSignal::RTScriptSignal(LuaScheduler* s, size_t capacity) : sched(s) {
     Lm = s ? s->GetMainState() : nullptr;
-    listeners.reserve(5120);
-    activeIdx.reserve(5120);
-    tmpActive.reserve(5120);
-    id2idx.reserve(5120);
+    listeners.reserve(capacity);
+    activeIdx.reserve(capacity);
+    tmpActive.reserve(capacity);
+    id2idx.reserve(capacity);
 }
 
 RTScriptSignal::~RTScriptSignal() {
@@ -19,7 +19,8 @@ size_t RTScriptSignal::Connect(lua_State* L, bool once, bool parallel){
     // move callback to main, take a registry ref (Luau API)
     lua_pushvalue(L, 1);
     lua_xmove(L, Lm, 1);
-    int ref = lua_ref(Lm, -1); // pops the value
+    int ref = lua_ref(Lm, -1);
+    lua_pop(Lm, 1); // lua_ref leaves the value on the stack
 
     Listener li;
     li.id = nextId++;
@@ -33,15 +34,18 @@ size_t RTScriptSignal::Connect(lua_State* L, bool once, bool parallel){
         lua_newthread(Lm);
         li.co = lua_tothread(Lm, -1);
         luaL_sandboxthread(li.co);
-        li.threadRef = lua_ref(Lm, -1); // pops that shit thread
+        li.threadRef = lua_ref(Lm, -1);
+        lua_pop(Lm, 1);
     }
 
+    const bool had = HasListeners();
     const size_t idx = listeners.size();
     listeners.push_back(li);
     id2idx[li.id] = idx;
 
     activeIdx.push_back(idx);
     listeners[idx].activePos = activeIdx.size() - 1;
+    listenersChanged(had);
 
     return li.id;
 }
@@ -83,6 +87,7 @@ void RTScriptSignal::Disconnect(size_t id){
     }
 
     id2idx.erase(it);
+    listenersChanged(true);
 }
 
 int RTScriptSignal::Wait(lua_State* L){
@@ -111,6 +116,7 @@ int RTScriptSignal::Wait(lua_State* L){
         return 0;
     }
 
+    const bool had = HasListeners();
     if (auto* self = static_cast<BaseScript*>(lua_getthreaddata(L))) {
         sched->SetWaitEvent(self);
         waiters.push_back(Waiter{Waiter::Kind::Script, self, nullptr});
@@ -118,14 +124,17 @@ int RTScriptSignal::Wait(lua_State* L){
         sched->SetTaskWaitEvent(L);
         waiters.push_back(Waiter{Waiter::Kind::Task, nullptr, L});
     }
+    listenersChanged(had);
     return lua_yield(L, 0);
 }
 
 void RTScriptSignal::wakeWaitersWithArgsOnNextFrame(lua_State* src, int firstArgIdx, int argc){
     if (!sched || !Lm) return;
 
+    if (waiters.empty()) return;
     auto ws = std::move(waiters);
     waiters.clear();
+    listenersChanged(true);
 
     for (auto& w : ws){
         lua_State* co = (w.kind == Waiter::Kind::Script)
@@ -1,4 +1,5 @@
 #pragma once
+#include <functional>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -28,7 +29,8 @@ struct RTScriptSignal : std::enable_shared_from_this<RTScriptSignal> {
         lua_State*  co{nullptr};
     };
 
-    explicit RTScriptSignal(LuaScheduler* s);
+    // 'capacity' listeners are reserved up front; per-instance signals pass a small one.
+    explicit RTScriptSignal(LuaScheduler* s, size_t capacity = 5120);
     ~RTScriptSignal();
 
     // Lua bindings:
@@ -41,6 +43,11 @@ struct RTScriptSignal : std::enable_shared_from_this<RTScriptSignal> {
     void   Disconnect(size_t id);
     bool   IsConnected(size_t id) const;
     bool   IsClosed() const { return closed; }
+    bool   HasListeners() const { return !activeIdx.empty() || !waiters.empty(); }
+
+    // Called when HasListeners() turns true or false (not by Close). It may
+    // run in the middle of a Fire, so it must not destroy the signal.
+    std::function<void()> OnListenersChanged;
 
 private:
     LuaScheduler* sched{};
@@ -54,6 +61,7 @@ private:
     std::vector<size_t> tmpActive;                   // per-fire snapshot
     std::vector<Waiter> waiters;
 
+    void listenersChanged(bool had) { if (had != HasListeners() && OnListenersChanged) OnListenersChanged(); }
     void wakeWaitersWithArgsOnNextFrame(lua_State* src, int firstArgIdx, int argc);
     void callListenersDeferred(lua_State* src, int firstArgIdx, int argc);
 };
@@ -142,6 +142,12 @@ void EnumRegistry::InitializeBuiltinEnums() {
     keyCode->AddItem("MouseButton2", 52);
     keyCode->AddItem("MouseButton3", 53);
     RegisterEnum("KeyCode", keyCode);
+
+    // RaycastFilterType enum
+    Enum* raycastFilterType = new Enum("RaycastFilterType");
+    raycastFilterType->AddItem("Exclude", 0);
+    raycastFilterType->AddItem("Include", 1);
+    RegisterEnum("RaycastFilterType", raycastFilterType);
 }
 
 // Lua helper functions
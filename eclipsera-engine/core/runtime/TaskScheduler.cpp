@@ -0,0 +1,87 @@
+#include "core/runtime/TaskScheduler.h"
+#include <algorithm>
+
+// which pool (if any) the current thread works for, and its queue
+static thread_local const TaskScheduler* tlsPool = nullptr;
+static thread_local unsigned tlsIndex = 0;
+
+TaskScheduler& TaskScheduler::Get() {
+    static TaskScheduler* pool = [] {
+        const unsigned hw = std::thread::hardware_concurrency();
+        return new TaskScheduler(hw > 1 ? std::min(hw - 1, 15u) : 0u);
+    }(); // leaked: jobs may still be queued while static destructors run
+    return *pool;
+}
+
+TaskScheduler::TaskScheduler(unsigned workers) {
+    for (unsigned i = 0; i <= workers; ++i) queues.push_back(std::make_unique<Queue>());
+    threads.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i) threads.emplace_back([this, i]{ workerMain(i); });
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lk(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads) t.join();
+}
+
+unsigned TaskScheduler::selfIndex() const {
+    return tlsPool == this ? tlsIndex : (unsigned)threads.size();
+}
+
+void TaskScheduler::Submit(Counter& c, Job job) {
+    c.pending.fetch_add(1, std::memory_order_relaxed);
+    Queue& q = *queues[selfIndex()];
+    {
+        std::lock_guard<std::mutex> lk(q.m);
+        q.jobs.emplace_back([j = std::move(job), &c]{
+            j();
+            c.pending.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    if (threads.empty()) return;
+    { std::lock_guard<std::mutex> lk(sleepMutex); } // pairs with the predicate check in workerMain
+    wake.notify_one();
+}
+
+bool TaskScheduler::tryRun(unsigned self) {
+    if (queued.load(std::memory_order_acquire) == 0) return false;
+
+    Job job;
+    const unsigned n = (unsigned)queues.size();
+    for (unsigned k = 0; k < n && !job; ++k) {
+        const unsigned i = (self + k) % n;
+        Queue& q = *queues[i];
+        std::lock_guard<std::mutex> lk(q.m);
+        if (q.jobs.empty()) continue;
+        // own queue LIFO (still warm in cache), others FIFO (oldest, likely largest remaining work)
+        if (i == self) { job = std::move(q.jobs.back());  q.jobs.pop_back(); }
+        else           { job = std::move(q.jobs.front()); q.jobs.pop_front(); }
+    }
+    if (!job) return false;
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    job();
+    return true;
+}
+
+void TaskScheduler::Wait(Counter& c) {
+    const unsigned self = selfIndex();
+    while (c.pending.load(std::memory_order_acquire) != 0) {
+        if (!tryRun(self)) std::this_thread::yield();
+    }
+}
+
+void TaskScheduler::workerMain(unsigned self) {
+    tlsPool = this;
+    tlsIndex = self;
+    for (;;) {
+        if (tryRun(self)) continue;
+        std::unique_lock<std::mutex> lk(sleepMutex);
+        wake.wait(lk, [this]{ return stopping || queued.load(std::memory_order_acquire) != 0; });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing job pool for short CPU-bound jobs (render prep, physics).
+// Every worker owns a deque: it pushes and pops at the back, and idle
+// workers steal from the front of the others. Threads outside the pool share
+// one extra deque. Wait() runs jobs while it waits, so the caller is one more
+// worker and a pool with zero threads still makes progress inline.
+class TaskScheduler {
+public:
+    using Job = std::function<void()>;
+
+    // Jobs submitted against a counter; Wait() returns once all have finished.
+    struct Counter {
+        std::atomic<uint32_t> pending{0};
+    };
+
+    // Process-wide pool: hardware threads minus one (the main thread helps).
+    static TaskScheduler& Get();
+
+    explicit TaskScheduler(unsigned workers);
+    ~TaskScheduler();
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    unsigned WorkerCount() const { return (unsigned)threads.size(); }
+
+    void Submit(Counter& c, Job job);
+    void Wait(Counter& c);
+
+    // Run f(begin, end) over [0, count) in chunks of about 'grain' items.
+    // Chunk boundaries are multiples of 'grain'. Blocks until every chunk ran.
+    template <class F>
+    void ParallelFor(size_t count, size_t grain, F&& f) {
+        if (count == 0) return;
+        if (grain == 0) grain = 1;
+        const size_t chunks = (count + grain - 1) / grain;
+        if (chunks == 1 || threads.empty()) { f((size_t)0, count); return; }
+        Counter c;
+        for (size_t k = 1; k < chunks; ++k) {
+            const size_t b = k * grain, e = b + grain < count ? b + grain : count;
+            Submit(c, [&f, b, e]{ f(b, e); });
+        }
+        f((size_t)0, grain);
+        Wait(c);
+    }
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<Job> jobs;
+    };
+
+    bool tryRun(unsigned self);
+    void workerMain(unsigned self);
+    unsigned selfIndex() const;
+
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<Queue>> queues; // [0, workers) per worker, [workers] shared by outside threads
+    std::atomic<uint32_t> queued{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping{false};
+};
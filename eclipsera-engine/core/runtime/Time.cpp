@@ -0,0 +1,20 @@
+#include "core/runtime/Time.h"
+#include <chrono>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+static Clock::time_point Epoch() {
+    static const Clock::time_point epoch = Clock::now();
+    return epoch;
+}
+
+double timing::Now() {
+    const Clock::time_point epoch = Epoch();
+    return std::chrono::duration<double>(Clock::now() - epoch).count();
+}
+
+void timing::SleepUntil(double t) {
+    const auto at = Epoch() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(t));
+    std::this_thread::sleep_until(at);
+}
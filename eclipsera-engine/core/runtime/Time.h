@@ -0,0 +1,10 @@
+#pragma once
+
+// Monotonic wall-clock time for the main loop and the script scheduler:
+// seconds since the first call, from std::chrono::steady_clock. Unlike
+// raylib's GetTime() it needs no window and never jumps with the system clock.
+namespace timing {
+    double Now();
+    // Block the calling thread until Now() reaches 't'; returns at once if it has.
+    void   SleepUntil(double t);
+}
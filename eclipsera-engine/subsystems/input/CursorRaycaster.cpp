@@ -0,0 +1,24 @@
+#include "subsystems/input/CursorRaycaster.h"
+#include "raymath.h"
+
+CursorRaycaster& CursorRaycaster::Get() {
+    static CursorRaycaster* c = new CursorRaycaster(); // leaked, like the other subsystem singletons
+    return *c;
+}
+
+void CursorRaycaster::SetView(const Camera3D& cam, int w, int h) {
+    camera = cam;
+    width  = w > 0 ? w : 1;
+    height = h > 0 ? h : 1;
+}
+
+Ray CursorRaycaster::ScreenPointToRay(Vector2 point) const {
+    Ray r = GetScreenToWorldRayEx(point, camera, width, height);
+    r.direction = Vector3Normalize(r.direction);
+    return r;
+}
+
+bool CursorRaycaster::Pick(const std::shared_ptr<Workspace>& ws, Vector2 point, PhysicsWorld::RayHit& hit) const {
+    const Ray r = ScreenPointToRay(point);
+    return PhysicsWorld::Get().Raycast(ws, r.position, Vector3Scale(r.direction, kMaxDistance), nullptr, hit);
+}
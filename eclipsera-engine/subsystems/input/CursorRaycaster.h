@@ -0,0 +1,29 @@
+#pragma once
+#include <raylib.h>
+#include <memory>
+#include "subsystems/physics/PhysicsWorld.h"
+
+struct Workspace;
+
+// Screen-space picking. The main loop hands over the view it renders each
+// frame; scripts (Camera:ScreenPointToRay) and tools turn screen points into
+// world rays against it, and Pick casts them through the physics world.
+class CursorRaycaster {
+public:
+    static constexpr float kMaxDistance = 5000.0f;  // studs cast by Pick
+
+    static CursorRaycaster& Get();
+
+    void SetView(const Camera3D& camera, int width, int height);
+    int  Width() const { return width; }
+    int  Height() const { return height; }
+
+    // Ray through a pixel; the direction is unit length.
+    Ray  ScreenPointToRay(Vector2 point) const;
+    // First part under a pixel, within kMaxDistance.
+    bool Pick(const std::shared_ptr<Workspace>& ws, Vector2 point, PhysicsWorld::RayHit& hit) const;
+
+private:
+    Camera3D camera{};
+    int width{1}, height{1};
+};
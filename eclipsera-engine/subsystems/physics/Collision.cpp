@@ -0,0 +1,983 @@
+#include "subsystems/physics/Collision.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#ifdef ECLIPSERA_SSE2
+#include <emmintrin.h>
+#endif
+
+// -------- tree nodes --------
+int32_t AabbTree::allocNode() {
+    int32_t id;
+    if (freeList != kNull) {
+        id = freeList;
+        freeList = nodes[id].parent;
+    } else {
+        id = (int32_t)nodes.size();
+        nodes.emplace_back();
+    }
+    Node& n = nodes[id];
+    n.parent = n.child1 = n.child2 = kNull;
+    n.height = 0;
+    n.userData = 0;
+    n.enlarged = false;
+    return id;
+}
+
+void AabbTree::freeNode(int32_t id) {
+    nodes[id].parent = freeList;
+    nodes[id].height = -1;
+    freeList = id;
+}
+
+void AabbTree::Clear() {
+    nodes.clear();
+    root = freeList = kNull;
+    leaves = 0;
+}
+
+// -------- proxies --------
+int32_t AabbTree::CreateProxy(const Aabb& fat, uint32_t userData) {
+    const int32_t id = allocNode();
+    nodes[id].box = fat;
+    nodes[id].userData = userData;
+    insertLeaf(id);
+    ++leaves;
+    return id;
+}
+
+void AabbTree::DestroyProxy(int32_t id) {
+    removeLeaf(id);
+    freeNode(id);
+    --leaves;
+}
+
+void AabbTree::MoveProxy(int32_t id, const Aabb& fat) {
+    removeLeaf(id);
+    nodes[id].box = fat;
+    insertLeaf(id);
+}
+
+void AabbTree::EnlargeProxy(int32_t id, const Aabb& fat) {
+    nodes[id].box = fat;
+    int32_t p = nodes[id].parent;
+    // grow ancestors until one already covers the box ...
+    while (p != kNull) {
+        Node& n = nodes[p];
+        const bool covered = AabbContains(n.box, fat);
+        if (!covered) n.box = AabbUnion(n.box, fat);
+        n.enlarged = true;
+        p = n.parent;
+        if (covered) break;
+    }
+    // ... and mark the rest of the path so Rebuild reaches this subtree
+    for (; p != kNull && !nodes[p].enlarged; p = nodes[p].parent) nodes[p].enlarged = true;
+}
+
+void AabbTree::Rebuild(bool full) {
+    if (root == kNull || nodes[root].child1 == kNull) return;
+    if (!full && !nodes[root].enlarged) return;
+
+    // free the enlarged internal nodes; what hangs below them is placed as-is
+    rebuildItems.clear();
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        const int32_t id = stack.back();
+        stack.pop_back();
+        Node& n = nodes[id];
+        if (n.child1 == kNull || (!full && !n.enlarged)) {
+            n.enlarged = false;
+            rebuildItems.push_back(id);
+            continue;
+        }
+        stack.push_back(n.child1);
+        stack.push_back(n.child2);
+        freeNode(id);
+    }
+    root = build(rebuildItems.data(), rebuildItems.size(), kNull);
+}
+
+// Top-down build over 'items' (leaves or kept subtrees): split at the best of a
+// few bins along the widest axis of their centres, by surface area heuristic.
+int32_t AabbTree::build(int32_t* items, size_t count, int32_t parent) {
+    if (count == 1) { nodes[items[0]].parent = parent; return items[0]; }
+
+    auto centre = [&](int32_t id, int axis){
+        const Aabb& b = nodes[id].box;
+        return axis == 0 ? b.min.x + b.max.x : axis == 1 ? b.min.y + b.max.y : b.min.z + b.max.z;
+    };
+    float lo[3] = {  1e30f,  1e30f,  1e30f }, hi[3] = { -1e30f, -1e30f, -1e30f };
+    for (size_t i = 0; i < count; ++i)
+        for (int a = 0; a < 3; ++a) { const float c = centre(items[i], a); lo[a] = std::min(lo[a], c); hi[a] = std::max(hi[a], c); }
+    int axis = 0;
+    for (int a = 1; a < 3; ++a) if (hi[a] - lo[a] > hi[axis] - lo[axis]) axis = a;
+
+    size_t split = count / 2;
+    const float extent = hi[axis] - lo[axis];
+    if (extent > 0.0f) {
+        constexpr int kBins = 12;
+        struct Bin { Aabb box; size_t count; } bins[kBins];
+        for (Bin& b : bins) b.count = 0;
+        const float scale = kBins / extent;
+        auto binOf = [&](int32_t id){ return std::min(kBins - 1, (int)((centre(id, axis) - lo[axis]) * scale)); };
+        for (size_t i = 0; i < count; ++i) {
+            Bin& b = bins[binOf(items[i])];
+            b.box = b.count++ ? AabbUnion(b.box, nodes[items[i]].box) : nodes[items[i]].box;
+        }
+        // cost of splitting after bin k: left count * area + right count * area
+        float rightArea[kBins];
+        size_t rightCount[kBins];
+        Aabb acc{};
+        size_t n = 0;
+        for (int k = kBins - 1; k > 0; --k) {
+            if (bins[k].count) { acc = n ? AabbUnion(acc, bins[k].box) : bins[k].box; n += bins[k].count; }
+            rightArea[k] = n ? AabbArea(acc) : 0.0f;
+            rightCount[k] = n;
+        }
+        float best = 1e30f;
+        int bestBin = -1;
+        n = 0;
+        for (int k = 0; k < kBins - 1; ++k) {
+            if (bins[k].count) { acc = n ? AabbUnion(acc, bins[k].box) : bins[k].box; n += bins[k].count; }
+            if (!n || !rightCount[k + 1]) continue;
+            const float cost = n * AabbArea(acc) + rightCount[k + 1] * rightArea[k + 1];
+            if (cost < best) { best = cost; bestBin = k; }
+        }
+        if (bestBin >= 0) {
+            int32_t* mid = std::partition(items, items + count, [&](int32_t id){ return binOf(id) <= bestBin; });
+            split = (size_t)(mid - items);
+        }
+    }
+    if (split == 0 || split == count) {
+        split = count / 2;
+        std::nth_element(items, items + split, items + count,
+                         [&](int32_t a, int32_t b){ return centre(a, axis) < centre(b, axis); });
+    }
+
+    const int32_t id = allocNode();
+    const int32_t c1 = build(items, split, id);
+    const int32_t c2 = build(items + split, count - split, id);
+    Node& n = nodes[id];
+    n.parent = parent;
+    n.child1 = c1;
+    n.child2 = c2;
+    n.box = AabbUnion(nodes[c1].box, nodes[c2].box);
+    n.height = 1 + std::max(nodes[c1].height, nodes[c2].height);
+    return id;
+}
+
+// -------- structure --------
+void AabbTree::insertLeaf(int32_t leaf) {
+    if (root == kNull) { root = leaf; nodes[leaf].parent = kNull; return; }
+
+    // descend toward the sibling whose union with the leaf adds the least area
+    const Aabb box = nodes[leaf].box;
+    int32_t index = root;
+    while (nodes[index].child1 != kNull) {
+        const Node& n = nodes[index];
+        const float area = AabbArea(n.box);
+        const float combined = AabbArea(AabbUnion(n.box, box));
+        const float cost = 2.0f * combined;            // new parent for this node and the leaf
+        const float inherit = 2.0f * (combined - area); // pushed onto every ancestor below here
+
+        auto descendCost = [&](int32_t c){
+            const Node& cn = nodes[c];
+            const float grown = AabbArea(AabbUnion(box, cn.box));
+            return (cn.child1 == kNull ? grown : grown - AabbArea(cn.box)) + inherit;
+        };
+        const float cost1 = descendCost(n.child1), cost2 = descendCost(n.child2);
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? n.child1 : n.child2;
+    }
+
+    const int32_t sibling = index;
+    const int32_t oldParent = nodes[sibling].parent;
+    const int32_t newParent = allocNode();
+    Node& p = nodes[newParent];
+    p.parent = oldParent;
+    p.box = AabbUnion(box, nodes[sibling].box);
+    p.height = nodes[sibling].height + 1;
+    p.child1 = sibling;
+    p.child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == kNull) root = newParent;
+    else if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+    else nodes[oldParent].child2 = newParent;
+
+    refitUp(nodes[leaf].parent);
+}
+
+void AabbTree::removeLeaf(int32_t leaf) {
+    if (leaf == root) { root = kNull; return; }
+
+    const int32_t parent = nodes[leaf].parent;
+    const int32_t grand = nodes[parent].parent;
+    const int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grand == kNull) {
+        root = sibling;
+        nodes[sibling].parent = kNull;
+        freeNode(parent);
+        return;
+    }
+    if (nodes[grand].child1 == parent) nodes[grand].child1 = sibling;
+    else nodes[grand].child2 = sibling;
+    nodes[sibling].parent = grand;
+    freeNode(parent);
+    refitUp(grand);
+}
+
+// rebalance and refit bounds and heights from 'id' to the root
+void AabbTree::refitUp(int32_t id) {
+    while (id != kNull) {
+        id = balance(id);
+        Node& n = nodes[id];
+        const Node& c1 = nodes[n.child1];
+        const Node& c2 = nodes[n.child2];
+        n.height = 1 + std::max(c1.height, c2.height);
+        n.box = AabbUnion(c1.box, c2.box);
+        id = n.parent;
+    }
+}
+
+// Rotate the taller child of 'a' up when the children's heights differ by more
+// than one; returns the node now at a's position.
+int32_t AabbTree::balance(int32_t ia) {
+    Node& a = nodes[ia];
+    if (a.child1 == kNull || a.height < 2) return ia;
+
+    const int32_t ib = a.child1, ic = a.child2;
+    Node& b = nodes[ib];
+    Node& c = nodes[ic];
+    const int32_t skew = c.height - b.height;
+
+    // swap in the up-rotated child 'up' (the other child stays under a as 'keep')
+    auto rotate = [&](int32_t iup, Node& up, Node& keep, bool upIsChild2){
+        const int32_t i1 = up.child1, i2 = up.child2;
+        Node& n1 = nodes[i1];
+        Node& n2 = nodes[i2];
+
+        up.child1 = ia;
+        up.parent = a.parent;
+        a.parent = iup;
+        if (up.parent == kNull) root = iup;
+        else if (nodes[up.parent].child1 == ia) nodes[up.parent].child1 = iup;
+        else nodes[up.parent].child2 = iup;
+
+        // the taller grandchild stays with 'up', the shorter one replaces 'up' under a
+        const bool firstTaller = n1.height > n2.height;
+        const int32_t stay = firstTaller ? i1 : i2, move = firstTaller ? i2 : i1;
+        up.child2 = stay;
+        if (upIsChild2) a.child2 = move; else a.child1 = move;
+        nodes[move].parent = ia;
+        a.box = AabbUnion(keep.box, nodes[move].box);
+        up.box = AabbUnion(a.box, nodes[stay].box);
+        a.height = 1 + std::max(keep.height, nodes[move].height);
+        up.height = 1 + std::max(a.height, nodes[stay].height);
+        return iup;
+    };
+
+    if (skew > 1)  return rotate(ic, c, b, true);
+    if (skew < -1) return rotate(ib, b, c, false);
+    return ia;
+}
+
+// -------- broadphase --------
+static constexpr int32_t kMaxHeightRatio = 3;
+
+static Aabb Fatten(const Aabb& box, Vector3 displacement) {
+    const float m = Broadphase::kMargin, k = Broadphase::kDisplacementStretch;
+    Aabb fat = { { box.min.x - m, box.min.y - m, box.min.z - m }, { box.max.x + m, box.max.y + m, box.max.z + m } };
+    const float d[3] = { displacement.x * k, displacement.y * k, displacement.z * k };
+    float* lo[3] = { &fat.min.x, &fat.min.y, &fat.min.z };
+    float* hi[3] = { &fat.max.x, &fat.max.y, &fat.max.z };
+    for (int i = 0; i < 3; ++i) { if (d[i] < 0.0f) *lo[i] += d[i]; else *hi[i] += d[i]; }
+    return fat;
+}
+
+Broadphase::Broadphase() {
+    for (uint32_t& m : groupMasks) m = ~0u;
+}
+
+void Broadphase::queueMove(uint32_t h) {
+    if (proxies[h].moved) return;
+    proxies[h].moved = true;
+    moveBuffer.push_back(h);
+}
+
+uint32_t Broadphase::Add(const Aabb& box, bool isStatic, uint32_t userData, uint8_t group) {
+    uint32_t h;
+    if (freeHandle != kNoProxy) { h = freeHandle; freeHandle = proxies[h].userData; }
+    else { h = (uint32_t)proxies.size(); proxies.push_back({ AabbTree::kNull, 0, false, false, 0 }); }
+
+    Proxy& p = proxies[h];
+    p.userData = userData;
+    p.isStatic = isStatic;
+    p.group = group < kMaxGroups ? group : 0;
+    p.leaf = tree(h).CreateProxy(Fatten(box, { 0, 0, 0 }), h);
+    queueMove(h);
+    ++stats.proxies;
+    stats.staticProxies += isStatic;
+    return h;
+}
+
+// a removed handle may still sit in moveBuffer; UpdatePairs skips it (or, if
+// the handle was reused meanwhile, queries it once as the new proxy)
+void Broadphase::Remove(uint32_t h) {
+    Proxy& p = proxies[h];
+    tree(h).DestroyProxy(p.leaf);
+    --stats.proxies;
+    stats.staticProxies -= p.isStatic;
+    p.leaf = AabbTree::kNull;
+    p.userData = freeHandle;
+    freeHandle = h;
+}
+
+void Broadphase::Move(uint32_t h, const Aabb& box, Vector3 displacement) {
+    Proxy& p = proxies[h];
+    AabbTree& t = tree(h);
+    const Aabb& current = t.FatAabb(p.leaf);
+    const Aabb fat = Fatten(box, displacement);
+    if (AabbContains(current, box)) {
+        // still covered; keep the leaf unless its fat box has become much larger than needed
+        const float m = 4.0f * kMargin;
+        const Aabb huge = { { fat.min.x - m, fat.min.y - m, fat.min.z - m }, { fat.max.x + m, fat.max.y + m, fat.max.z + m } };
+        if (AabbContains(huge, current)) return;
+    }
+    t.EnlargeProxy(p.leaf, fat);
+    queueMove(h);
+}
+
+void Broadphase::SetStatic(uint32_t h, bool isStatic) {
+    Proxy& p = proxies[h];
+    if (p.isStatic == isStatic) return;
+    const Aabb fat = tree(h).FatAabb(p.leaf);
+    tree(h).DestroyProxy(p.leaf);
+    p.isStatic = isStatic;
+    p.leaf = tree(h).CreateProxy(fat, h);
+    stats.staticProxies += isStatic ? 1 : -1;
+    queueMove(h);
+}
+
+// pairs the old group filtered out are found again by the re-query; pairs
+// the new one filters are left to the caller (see Collides)
+void Broadphase::SetGroup(uint32_t h, uint8_t group) {
+    Proxy& p = proxies[h];
+    if (group >= kMaxGroups) group = 0;
+    if (p.group == group) return;
+    p.group = group;
+    queueMove(h);
+}
+
+void Broadphase::SetGroupMasks(const uint32_t* masks) {
+    bool same = true;
+    for (uint32_t g = 0; g < kMaxGroups; ++g) same &= groupMasks[g] == masks[g];
+    if (same) return;
+    for (uint32_t g = 0; g < kMaxGroups; ++g) groupMasks[g] = masks[g];
+    for (uint32_t h = 0; h < (uint32_t)proxies.size(); ++h)
+        if (proxies[h].leaf != AabbTree::kNull) queueMove(h);
+}
+
+void Broadphase::Clear() {
+    dynamicTree.Clear();
+    staticTree.Clear();
+    proxies.clear();
+    moveBuffer.clear();
+    freeHandle = kNoProxy;
+    stats = Stats{};
+}
+
+bool Broadphase::TestOverlap(uint32_t a, uint32_t b) const {
+    return AabbOverlaps(FatAabb(a), FatAabb(b));
+}
+
+// Partial rebuilds keep whole subtrees, so depth can creep up over many steps;
+// past a few times the balanced depth the tree is rebuilt from its leaves.
+static void RebuildTree(AabbTree& t) {
+    int32_t balanced = 1;
+    while (((size_t)1 << balanced) < t.LeafCount()) ++balanced;
+    t.Rebuild(t.Height() > kMaxHeightRatio * balanced);
+}
+
+void Broadphase::UpdatePairs(std::vector<BroadphasePair>& out) {
+    RebuildTree(dynamicTree);
+    RebuildTree(staticTree);
+    out.clear();
+    uint32_t filtered = 0;
+    for (uint32_t h : moveBuffer) {
+        const Proxy& q = proxies[h];
+        if (q.leaf == AabbTree::kNull) continue;
+        const Aabb fat = tree(h).FatAabb(q.leaf);
+        const uint32_t mask = groupMasks[q.group];
+        auto visit = [&](const AabbTree& t){
+            t.Query(fat, [&](int32_t leaf){
+                const uint32_t o = t.UserData(leaf);
+                // a pair of two moved proxies is reported from the higher handle only
+                if (o == h || (proxies[o].moved && o > h)) return true;
+                if (!((mask >> proxies[o].group) & 1u)) { ++filtered; return true; }
+                out.push_back({ std::min(h, o), std::max(h, o) });
+                return true;
+            });
+        };
+        visit(dynamicTree);
+        if (!q.isStatic) visit(staticTree);
+    }
+    for (uint32_t h : moveBuffer) proxies[h].moved = false;
+    std::sort(out.begin(), out.end(), [](const BroadphasePair& x, const BroadphasePair& y){
+        return x.a != y.a ? x.a < y.a : x.b < y.b;
+    });
+
+    stats.moved = (uint32_t)moveBuffer.size();
+    stats.pairs = (uint32_t)out.size();
+    stats.filtered = filtered;
+    stats.dynamicHeight = dynamicTree.Height();
+    stats.staticHeight = staticTree.Height();
+    moveBuffer.clear();
+}
+
+void Broadphase::Save(Saved& out) const {
+    out.proxies.resize(proxies.size());
+    for (size_t h = 0; h < proxies.size(); ++h) {
+        const Proxy& p = proxies[h];
+        SavedProxy& sp = out.proxies[h];
+        sp.live = p.leaf != AabbTree::kNull;
+        sp.fat = sp.live ? tree((uint32_t)h).FatAabb(p.leaf) : Aabb{};
+        sp.userData = p.userData;
+        sp.isStatic = p.isStatic;
+        sp.moved = p.moved;
+        sp.group = p.group;
+    }
+    out.moves = moveBuffer;
+    out.freeHandle = freeHandle;
+}
+
+bool Broadphase::Restore(const Saved& in) {
+    const uint32_t n = (uint32_t)in.proxies.size();
+    for (uint32_t h : in.moves) if (h >= n) return false;
+    for (uint32_t f = in.freeHandle, guard = 0; f != kNoProxy; f = in.proxies[f].userData)
+        if (f >= n || in.proxies[f].live || ++guard > n) return false;
+
+    dynamicTree.Clear();
+    staticTree.Clear();
+    proxies.resize(n);
+    stats.proxies = stats.staticProxies = 0;
+    for (uint32_t h = 0; h < n; ++h) {
+        const SavedProxy& sp = in.proxies[h];
+        Proxy& p = proxies[h];
+        p.userData = sp.userData;
+        p.isStatic = sp.isStatic != 0;
+        p.moved = sp.moved != 0;
+        p.group = sp.group < kMaxGroups ? sp.group : 0;
+        p.leaf = sp.live ? tree(h).CreateProxy(sp.fat, h) : AabbTree::kNull;
+        stats.proxies += sp.live;
+        stats.staticProxies += sp.live && sp.isStatic;
+    }
+    moveBuffer = in.moves;
+    freeHandle = in.freeHandle;
+    return true;
+}
+
+// -------- box data --------
+void BoxSoA::Resize(size_t n) {
+    for (auto* v : { &cx, &cy, &cz, &hx, &hy, &hz }) v->resize(n);
+    for (int i = 0; i < 3; ++i) { ax[i].resize(n); ay[i].resize(n); az[i].resize(n); }
+}
+
+void BoxSoA::Set(size_t i, const OrientedBox& b) {
+    cx[i] = b.center.x; cy[i] = b.center.y; cz[i] = b.center.z;
+    for (int k = 0; k < 3; ++k) { ax[k][i] = b.axis[k].x; ay[k][i] = b.axis[k].y; az[k][i] = b.axis[k].z; }
+    hx[i] = b.half.x; hy[i] = b.half.y; hz[i] = b.half.z;
+}
+
+OrientedBox BoxSoA::Get(size_t i) const {
+    OrientedBox b;
+    b.center = { cx[i], cy[i], cz[i] };
+    for (int k = 0; k < 3; ++k) b.axis[k] = { ax[k][i], ay[k][i], az[k][i] };
+    b.half = { hx[i], hy[i], hz[i] };
+    return b;
+}
+
+void BoxSoA::Move(size_t dst, size_t src) { Set(dst, Get(src)); }
+
+// -------- narrowphase --------
+namespace {
+// Deepest (least negative) separation per axis family. Axes 0-2 are A's face
+// normals, 3-5 B's, 6-14 the edge cross products A[i] x B[j] as 6 + 3i + j.
+struct SatResult {
+    float faceA, faceB, edge;
+    int   axisA, axisB, axisE;  // -1 when no valid axis of that family
+};
+
+struct ClipVertex {
+    Vector3  p;
+    uint32_t id;
+};
+
+constexpr float kParallelEps = 1e-5f;  // |A[i] x B[j]| below this: edges parallel, axis skipped
+constexpr float kAbsREps     = 1e-6f;  // keeps near-parallel face axes robust
+// a later axis family must beat the current choice by this much (separations are
+// negative while overlapping), so faces win ties and the choice does not flicker
+constexpr float kRelTol = 0.95f, kAbsTol = 0.005f;
+}
+
+static inline Vector3 Add(Vector3 a, Vector3 b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+static inline Vector3 Sub(Vector3 a, Vector3 b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+static inline Vector3 Scale(Vector3 a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+static inline float   Dot(Vector3 a, Vector3 b) { return a.x*b.x + a.y*b.y + a.z*b.z; }
+static inline Vector3 Cross(Vector3 a, Vector3 b) { return { a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x }; }
+static inline float   Comp(const Vector3& v, int i) { return i == 0 ? v.x : i == 1 ? v.y : v.z; }
+
+static inline uint32_t MixId(uint32_t a, uint32_t b) {
+    uint32_t h = a * 0x9E3779B1u ^ (b + 0x7F4A7C15u + (a << 6) + (a >> 2));
+    return h ^ (h >> 15);
+}
+
+// All 15 axes in A's frame (Gottschalk's formulation): R = A^T B, t = A^T (cB - cA).
+static SatResult SatScalar(const OrientedBox& a, const OrientedBox& b) {
+    const float ha[3] = { a.half.x, a.half.y, a.half.z }, hb[3] = { b.half.x, b.half.y, b.half.z };
+    const Vector3 t = Sub(b.center, a.center);
+    float R[3][3], AR[3][3], tA[3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            R[i][j] = Dot(a.axis[i], b.axis[j]);
+            AR[i][j] = std::fabs(R[i][j]) + kAbsREps;
+        }
+        tA[i] = Dot(t, a.axis[i]);
+    }
+
+    SatResult r{ -FLT_MAX, -FLT_MAX, -FLT_MAX, -1, -1, -1 };
+    for (int i = 0; i < 3; ++i) {
+        const float s = std::fabs(tA[i]) - (ha[i] + (hb[0]*AR[i][0] + hb[1]*AR[i][1] + hb[2]*AR[i][2]));
+        if (s > r.faceA) { r.faceA = s; r.axisA = i; }
+    }
+    for (int j = 0; j < 3; ++j) {
+        const float tb = tA[0]*R[0][j] + tA[1]*R[1][j] + tA[2]*R[2][j];
+        const float s = std::fabs(tb) - ((ha[0]*AR[0][j] + ha[1]*AR[1][j] + ha[2]*AR[2][j]) + hb[j]);
+        if (s > r.faceB) { r.faceB = s; r.axisB = 3 + j; }
+    }
+    for (int i = 0; i < 3; ++i) {
+        const int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; ++j) {
+            const int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            const float len = std::sqrt(R[i1][j]*R[i1][j] + R[i2][j]*R[i2][j]);
+            if (!(len > kParallelEps)) continue;
+            const float dist = std::fabs(tA[i2]*R[i1][j] - tA[i1]*R[i2][j]);
+            const float ra = ha[i1]*AR[i2][j] + ha[i2]*AR[i1][j];
+            const float rb = hb[j1]*AR[i][j2] + hb[j2]*AR[i][j1];
+            const float s = (dist - ra - rb) / len;
+            if (s > r.edge) { r.edge = s; r.axisE = 6 + 3*i + j; }
+        }
+    }
+    return r;
+}
+
+#ifdef ECLIPSERA_SSE2
+// SatScalar for four pairs at once, one pair per lane, same operation order.
+static void SatSimd4(const BoxSoA& bx, const uint32_t ia[4], const uint32_t ib[4], SatResult out[4]) {
+    auto G = [](const std::vector<float>& v, const uint32_t* idx){
+        return _mm_setr_ps(v[idx[0]], v[idx[1]], v[idx[2]], v[idx[3]]);
+    };
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 eps  = _mm_set1_ps(kAbsREps);
+    auto Abs = [&](__m128 x){ return _mm_andnot_ps(sign, x); };
+    auto Dot3 = [](const __m128* u, const __m128* v){
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(u[0], v[0]), _mm_mul_ps(u[1], v[1])), _mm_mul_ps(u[2], v[2]));
+    };
+    // lanes where s beats best take s and axis id
+    auto Track = [](__m128& best, __m128& axis, __m128 s, float id){
+        const __m128 win = _mm_cmpgt_ps(s, best);
+        best = _mm_or_ps(_mm_and_ps(win, s), _mm_andnot_ps(win, best));
+        axis = _mm_or_ps(_mm_and_ps(win, _mm_set1_ps(id)), _mm_andnot_ps(win, axis));
+    };
+
+    __m128 ua[3][3], ub[3][3];
+    for (int i = 0; i < 3; ++i) {
+        ua[i][0] = G(bx.ax[i], ia); ua[i][1] = G(bx.ay[i], ia); ua[i][2] = G(bx.az[i], ia);
+        ub[i][0] = G(bx.ax[i], ib); ub[i][1] = G(bx.ay[i], ib); ub[i][2] = G(bx.az[i], ib);
+    }
+    const __m128 ha[3] = { G(bx.hx, ia), G(bx.hy, ia), G(bx.hz, ia) };
+    const __m128 hb[3] = { G(bx.hx, ib), G(bx.hy, ib), G(bx.hz, ib) };
+    const __m128 t[3]  = { _mm_sub_ps(G(bx.cx, ib), G(bx.cx, ia)),
+                           _mm_sub_ps(G(bx.cy, ib), G(bx.cy, ia)),
+                           _mm_sub_ps(G(bx.cz, ib), G(bx.cz, ia)) };
+
+    __m128 R[3][3], AR[3][3], tA[3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            R[i][j] = Dot3(ua[i], ub[j]);
+            AR[i][j] = _mm_add_ps(Abs(R[i][j]), eps);
+        }
+        tA[i] = Dot3(t, ua[i]);
+    }
+
+    const __m128 lowest = _mm_set1_ps(-FLT_MAX), none = _mm_set1_ps(-1.0f);
+    __m128 faceA = lowest, faceB = lowest, edge = lowest;
+    __m128 axisA = none, axisB = none, axisE = none;
+    for (int i = 0; i < 3; ++i) {
+        const __m128 rb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(hb[0], AR[i][0]), _mm_mul_ps(hb[1], AR[i][1])), _mm_mul_ps(hb[2], AR[i][2]));
+        Track(faceA, axisA, _mm_sub_ps(Abs(tA[i]), _mm_add_ps(ha[i], rb)), (float)i);
+    }
+    for (int j = 0; j < 3; ++j) {
+        const __m128 tb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tA[0], R[0][j]), _mm_mul_ps(tA[1], R[1][j])), _mm_mul_ps(tA[2], R[2][j]));
+        const __m128 ra = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ha[0], AR[0][j]), _mm_mul_ps(ha[1], AR[1][j])), _mm_mul_ps(ha[2], AR[2][j]));
+        Track(faceB, axisB, _mm_sub_ps(Abs(tb), _mm_add_ps(ra, hb[j])), (float)(3 + j));
+    }
+    const __m128 parallel = _mm_set1_ps(kParallelEps);
+    for (int i = 0; i < 3; ++i) {
+        const int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; ++j) {
+            const int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            const __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(R[i1][j], R[i1][j]), _mm_mul_ps(R[i2][j], R[i2][j])));
+            const __m128 valid = _mm_cmpgt_ps(len, parallel);
+            const __m128 dist = Abs(_mm_sub_ps(_mm_mul_ps(tA[i2], R[i1][j]), _mm_mul_ps(tA[i1], R[i2][j])));
+            const __m128 ra = _mm_add_ps(_mm_mul_ps(ha[i1], AR[i2][j]), _mm_mul_ps(ha[i2], AR[i1][j]));
+            const __m128 rb = _mm_add_ps(_mm_mul_ps(hb[j1], AR[i][j2]), _mm_mul_ps(hb[j2], AR[i][j1]));
+            __m128 s = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(dist, ra), rb), _mm_max_ps(len, parallel));
+            s = _mm_or_ps(_mm_and_ps(valid, s), _mm_andnot_ps(valid, lowest));
+            Track(edge, axisE, s, (float)(6 + 3*i + j));
+        }
+    }
+
+    alignas(16) float fa[4], fb[4], fe[4], xa[4], xb[4], xe[4];
+    _mm_store_ps(fa, faceA); _mm_store_ps(fb, faceB); _mm_store_ps(fe, edge);
+    _mm_store_ps(xa, axisA); _mm_store_ps(xb, axisB); _mm_store_ps(xe, axisE);
+    for (int l = 0; l < 4; ++l) out[l] = { fa[l], fb[l], fe[l], (int)xa[l], (int)xb[l], (int)xe[l] };
+}
+#endif
+
+// Keep the part of 'in' behind the plane n.p = offset; new vertices get ids
+// derived from the edge they split and the plane.
+static int ClipPolygon(const ClipVertex* in, int count, Vector3 n, float offset, uint32_t plane, ClipVertex* out) {
+    int m = 0;
+    for (int k = 0; k < count; ++k) {
+        const ClipVertex& v0 = in[k];
+        const ClipVertex& v1 = in[(k + 1) % count];
+        const float d0 = Dot(n, v0.p) - offset, d1 = Dot(n, v1.p) - offset;
+        if (d0 <= 0.0f) out[m++] = v0;
+        if ((d0 <= 0.0f) != (d1 <= 0.0f)) {
+            const float t = d0 / (d0 - d1);
+            out[m++] = { Add(v0.p, Scale(Sub(v1.p, v0.p), t)), MixId(MixId(v0.id, v1.id), plane) };
+        }
+    }
+    return m;
+}
+
+// Closest points of segments p1-q1 and p2-q2 (Ericson, Real-Time Collision Detection 5.1.9).
+static void ClosestSegmentPoints(Vector3 p1, Vector3 q1, Vector3 p2, Vector3 q2, Vector3& c1, Vector3& c2) {
+    const Vector3 d1 = Sub(q1, p1), d2 = Sub(q2, p2), r = Sub(p1, p2);
+    const float a = Dot(d1, d1), e = Dot(d2, d2), f = Dot(d2, r);
+    const float c = Dot(d1, r), b = Dot(d1, d2);
+    const float denom = a*e - b*b;
+    float s = denom > 1e-9f ? std::clamp((b*f - c*e) / denom, 0.0f, 1.0f) : 0.0f;
+    float t = (b*s + f) / e;
+    if (t < 0.0f)      { t = 0.0f; s = std::clamp(-c / a, 0.0f, 1.0f); }
+    else if (t > 1.0f) { t = 1.0f; s = std::clamp((b - c) / a, 0.0f, 1.0f); }
+    c1 = Add(p1, Scale(d1, s));
+    c2 = Add(p2, Scale(d2, t));
+}
+
+static void FaceContact(const OrientedBox& a, const OrientedBox& b, int axis, ContactManifold& m) {
+    const bool refIsA = axis < 3;
+    const OrientedBox& ref = refIsA ? a : b;
+    const OrientedBox& inc = refIsA ? b : a;
+    const int i = refIsA ? axis : axis - 3;
+    const float hr[3] = { ref.half.x, ref.half.y, ref.half.z }, hi[3] = { inc.half.x, inc.half.y, inc.half.z };
+
+    // reference normal, pointing from the reference box toward the incident one
+    const float side = Dot(Sub(inc.center, ref.center), ref.axis[i]) < 0.0f ? -1.0f : 1.0f;
+    const Vector3 n = Scale(ref.axis[i], side);
+    m.normal = refIsA ? n : Scale(n, -1.0f);
+
+    // incident face: the one facing most against n
+    int k = 0;
+    float best = -1.0f;
+    for (int q = 0; q < 3; ++q) {
+        const float d = std::fabs(Dot(inc.axis[q], n));
+        if (d > best) { best = d; k = q; }
+    }
+    const float ks = Dot(inc.axis[k], n) > 0.0f ? -1.0f : 1.0f;
+    const int k1 = (k + 1) % 3, k2 = (k + 2) % 3;
+    const Vector3 fc = Add(inc.center, Scale(inc.axis[k], ks * hi[k]));
+    const Vector3 u1 = Scale(inc.axis[k1], hi[k1]), u2 = Scale(inc.axis[k2], hi[k2]);
+
+    ClipVertex poly[2][16];
+    poly[0][0] = { Sub(Sub(fc, u1), u2), 0 };
+    poly[0][1] = { Sub(Add(fc, u1), u2), 1 };
+    poly[0][2] = { Add(Add(fc, u1), u2), 2 };
+    poly[0][3] = { Add(Sub(fc, u1), u2), 3 };
+    int count = 4, cur = 0;
+
+    // clip against the four side planes of the reference face
+    const int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+    for (uint32_t c = 0; c < 4 && count > 0; ++c) {
+        const int s = c < 2 ? i1 : i2;
+        const Vector3 pn = Scale(ref.axis[s], (c & 1) ? -1.0f : 1.0f);
+        count = ClipPolygon(poly[cur], count, pn, Dot(pn, ref.center) + hr[s], c + 10, poly[cur ^ 1]);
+        cur ^= 1;
+    }
+
+    const uint32_t refFace = (refIsA ? 0u : 6u) + (uint32_t)i * 2 + (side < 0.0f);
+    const uint32_t incFace = (uint32_t)k * 2 + (ks < 0.0f);
+    const float planeD = Dot(n, ref.center) + hr[i];
+    ContactPoint pts[16];
+    int n0 = 0;
+    for (int q = 0; q < count; ++q) {
+        const float sep = Dot(n, poly[cur][q].p) - planeD;
+        if (sep > kSpeculativeDistance) continue;
+        ContactPoint& cp = pts[n0++];
+        cp = ContactPoint{};
+        cp.position = Sub(poly[cur][q].p, Scale(n, 0.5f * sep));
+        cp.separation = sep;
+        cp.id = MixId(MixId(poly[cur][q].id, refFace), incFace);
+    }
+
+    if (n0 <= ContactManifold::kMaxPoints) {
+        for (int q = 0; q < n0; ++q) m.points[q] = pts[q];
+        m.count = n0;
+        return;
+    }
+
+    // keep four: the deepest, the farthest from it, and the two that span the
+    // most area on either side of the line between them
+    int keep[4] = { 0, -1, -1, -1 };
+    for (int q = 1; q < n0; ++q) if (pts[q].separation < pts[keep[0]].separation) keep[0] = q;
+    float far = -1.0f;
+    for (int q = 0; q < n0; ++q) {
+        const Vector3 d = Sub(pts[q].position, pts[keep[0]].position);
+        if (Dot(d, d) > far) { far = Dot(d, d); keep[1] = q; }
+    }
+    const Vector3 e = Sub(pts[keep[1]].position, pts[keep[0]].position);
+    float most = 0.0f, least = 0.0f;
+    for (int q = 0; q < n0; ++q) {
+        if (q == keep[0] || q == keep[1]) continue;
+        const float area = Dot(Cross(e, Sub(pts[q].position, pts[keep[0]].position)), n);
+        if (keep[2] < 0 || area > most)  { most = area; keep[2] = q; }
+    }
+    for (int q = 0; q < n0; ++q) {
+        if (q == keep[0] || q == keep[1] || q == keep[2]) continue;
+        const float area = Dot(Cross(e, Sub(pts[q].position, pts[keep[0]].position)), n);
+        if (keep[3] < 0 || area < least) { least = area; keep[3] = q; }
+    }
+    m.count = 0;
+    for (int q : keep) if (q >= 0) m.points[m.count++] = pts[q];
+}
+
+static void EdgeContact(const OrientedBox& a, const OrientedBox& b, int axis, ContactManifold& m) {
+    const int i = (axis - 6) / 3, j = (axis - 6) % 3;
+    Vector3 n = Cross(a.axis[i], b.axis[j]);
+    n = Scale(n, 1.0f / std::sqrt(Dot(n, n)));
+    if (Dot(n, Sub(b.center, a.center)) < 0.0f) n = Scale(n, -1.0f);
+    m.normal = n;
+
+    // the edge of A furthest along n and the edge of B furthest against it
+    Vector3 pa = a.center, pb = b.center;
+    uint32_t signs = 0;
+    for (int q = 0; q < 3; ++q) {
+        if (q != i) {
+            const bool pos = Dot(a.axis[q], n) > 0.0f;
+            pa = Add(pa, Scale(a.axis[q], (pos ? 1.0f : -1.0f) * Comp(a.half, q)));
+            signs |= (uint32_t)pos << q;
+        }
+        if (q != j) {
+            const bool pos = Dot(b.axis[q], n) < 0.0f;
+            pb = Add(pb, Scale(b.axis[q], (pos ? 1.0f : -1.0f) * Comp(b.half, q)));
+            signs |= (uint32_t)pos << (q + 3);
+        }
+    }
+    const Vector3 da = Scale(a.axis[i], Comp(a.half, i)), db = Scale(b.axis[j], Comp(b.half, j));
+    Vector3 ca, cb;
+    ClosestSegmentPoints(Sub(pa, da), Add(pa, da), Sub(pb, db), Add(pb, db), ca, cb);
+
+    ContactPoint& cp = m.points[0];
+    cp = ContactPoint{};
+    cp.position = Scale(Add(ca, cb), 0.5f);
+    cp.separation = Dot(Sub(cb, ca), n);
+    cp.id = MixId(0xE000u + (uint32_t)axis, signs);
+    m.count = 1;
+}
+
+static bool FinishPair(const OrientedBox& a, const OrientedBox& b, const SatResult& r, ContactManifold& m) {
+    m.count = 0;
+    m.normal = { 0.0f, 0.0f, 0.0f };
+    if (std::max(r.faceA, std::max(r.faceB, r.edge)) > kSpeculativeDistance) return false;
+
+    int axis = r.axisA;
+    float sep = r.faceA;
+    if (r.faceB > kRelTol * sep + kAbsTol) { axis = r.axisB; sep = r.faceB; }
+    if (r.axisE >= 0 && r.edge > kRelTol * sep + kAbsTol) axis = r.axisE;
+
+    if (axis < 6) FaceContact(a, b, axis, m);
+    else EdgeContact(a, b, axis, m);
+    return m.count > 0;
+}
+
+bool CollideBoxes(const OrientedBox& a, const OrientedBox& b, ContactManifold& out) {
+    return FinishPair(a, b, SatScalar(a, b), out);
+}
+
+bool BoxesOverlap(const OrientedBox& a, const OrientedBox& b) {
+    const SatResult r = SatScalar(a, b);
+    return r.faceA <= 0.0f && r.faceB <= 0.0f && r.edge <= 0.0f;
+}
+
+// Distance from the centre to the box's closest point, axis by axis.
+bool SphereOverlapsBox(Vector3 center, float radius, const OrientedBox& b) {
+    const Vector3 d = Sub(center, b.center);
+    const float h[3] = { b.half.x, b.half.y, b.half.z };
+    float dist2 = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        const float out = std::fabs(Dot(d, b.axis[i])) - h[i];
+        if (out > 0.0f) dist2 += out * out;
+    }
+    return dist2 <= radius * radius;
+}
+
+void CollideBoxPairs(const BoxSoA& boxes, const BroadphasePair* pairs, size_t count,
+                     ContactManifold* out, NarrowphasePath path) {
+    size_t i = 0;
+#ifdef ECLIPSERA_SSE2
+    if (path == NarrowphasePath::Simd) {
+        for (; i + 4 <= count; i += 4) {
+            uint32_t ia[4], ib[4];
+            for (int l = 0; l < 4; ++l) { ia[l] = pairs[i + l].a; ib[l] = pairs[i + l].b; }
+            SatResult r[4];
+            SatSimd4(boxes, ia, ib, r);
+            for (int l = 0; l < 4; ++l) {
+                ContactManifold& m = out[i + l];
+                if (std::max(r[l].faceA, std::max(r[l].faceB, r[l].edge)) > kSpeculativeDistance) {
+                    m.count = 0;
+                    m.normal = { 0.0f, 0.0f, 0.0f };
+                    continue;
+                }
+                FinishPair(boxes.Get(ia[l]), boxes.Get(ib[l]), r[l], m);
+            }
+        }
+    }
+#else
+    (void)path;
+#endif
+    for (; i < count; ++i) {
+        const OrientedBox a = boxes.Get(pairs[i].a), b = boxes.Get(pairs[i].b);
+        FinishPair(a, b, SatScalar(a, b), out[i]);
+    }
+}
+
+void MatchContacts(const ContactManifold& old, ContactManifold& fresh) {
+    // Faces that line up exactly (a stack of equal boxes) put incident vertices
+    // right on the clip planes, so a point can alternate between a kept vertex
+    // and a clipped one from step to step; those are matched by position.
+    constexpr float kMatchDistance2 = 0.05f * 0.05f;
+    for (int q = 0; q < fresh.count; ++q) {
+        ContactPoint& p = fresh.points[q];
+        p.normalImpulse = p.tangentImpulse[0] = p.tangentImpulse[1] = 0.0f;
+        int match = -1;
+        float best = kMatchDistance2;
+        for (int o = 0; o < old.count; ++o) {
+            if (old.points[o].id == p.id) { match = o; break; }
+            const Vector3 d = Sub(old.points[o].position, p.position);
+            if (Dot(d, d) < best) { best = Dot(d, d); match = o; }
+        }
+        if (match < 0) continue;
+        p.normalImpulse = old.points[match].normalImpulse;
+        p.tangentImpulse[0] = old.points[match].tangentImpulse[0];
+        p.tangentImpulse[1] = old.points[match].tangentImpulse[1];
+    }
+}
+
+// -------- rays --------
+// Below this |axis . direction| the ray counts as parallel to the slab; the
+// clamped divisor keeps the slab test finite on both paths.
+static constexpr float kRayParallelEps = 1e-20f;
+
+static RayBoxHit RayBoxScalar(const OrientedBox& b, const RaySegment& r, float maxT) {
+    const Vector3 d = Sub(b.center, r.origin);
+    float tEnter = -FLT_MAX, tExit = FLT_MAX;
+    int axis = 0;
+    float sign = 1.0f;
+    for (int i = 0; i < 3; ++i) {
+        const float e = Dot(b.axis[i], d);
+        float f = Dot(b.axis[i], r.direction);
+        f = f >= 0.0f ? std::max(f, kRayParallelEps) : std::min(f, -kRayParallelEps);
+        const float h = Comp(b.half, i);
+        const float ta = (e - h) / f, tb = (e + h) / f;
+        const float tn = ta < tb ? ta : tb, tf = ta < tb ? tb : ta;
+        if (tn > tEnter) { tEnter = tn; axis = i; sign = f > 0.0f ? -1.0f : 1.0f; }
+        if (tf < tExit) tExit = tf;
+    }
+    if (!(tEnter <= tExit && tEnter >= 0.0f && tEnter <= maxT)) return { FLT_MAX, { 0.0f, 0.0f, 0.0f } };
+    return { tEnter, Scale(b.axis[axis], sign) };
+}
+
+#ifdef ECLIPSERA_SSE2
+// RayBoxScalar for four boxes at once, one box per lane, same operation order.
+static void RayBoxSimd4(const BoxSoA& bx, const RaySegment& r, float maxT, const uint32_t idx[4], RayBoxHit out[4]) {
+    auto G = [&](const std::vector<float>& v){
+        return _mm_setr_ps(v[idx[0]], v[idx[1]], v[idx[2]], v[idx[3]]);
+    };
+    auto Blend = [](__m128 mask, __m128 a, __m128 b){ return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); };
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 eps = _mm_set1_ps(kRayParallelEps), negEps = _mm_set1_ps(-kRayParallelEps);
+    const __m128 dx = _mm_sub_ps(G(bx.cx), _mm_set1_ps(r.origin.x));
+    const __m128 dy = _mm_sub_ps(G(bx.cy), _mm_set1_ps(r.origin.y));
+    const __m128 dz = _mm_sub_ps(G(bx.cz), _mm_set1_ps(r.origin.z));
+    const __m128 rx = _mm_set1_ps(r.direction.x), ry = _mm_set1_ps(r.direction.y), rz = _mm_set1_ps(r.direction.z);
+    const std::vector<float>* half[3] = { &bx.hx, &bx.hy, &bx.hz };
+
+    __m128 tEnter = _mm_set1_ps(-FLT_MAX), tExit = _mm_set1_ps(FLT_MAX);
+    __m128 axis = zero, sign = _mm_set1_ps(1.0f);
+    for (int i = 0; i < 3; ++i) {
+        const __m128 ax = G(bx.ax[i]), ay = G(bx.ay[i]), az = G(bx.az[i]);
+        const __m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, dx), _mm_mul_ps(ay, dy)), _mm_mul_ps(az, dz));
+        __m128 f = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, rx), _mm_mul_ps(ay, ry)), _mm_mul_ps(az, rz));
+        f = Blend(_mm_cmpge_ps(f, zero), _mm_max_ps(f, eps), _mm_min_ps(f, negEps));
+        const __m128 h = G(*half[i]);
+        const __m128 ta = _mm_div_ps(_mm_sub_ps(e, h), f), tb = _mm_div_ps(_mm_add_ps(e, h), f);
+        const __m128 less = _mm_cmplt_ps(ta, tb);
+        const __m128 tn = Blend(less, ta, tb), tf = Blend(less, tb, ta);
+        const __m128 win = _mm_cmpgt_ps(tn, tEnter);
+        tEnter = Blend(win, tn, tEnter);
+        axis = Blend(win, _mm_set1_ps((float)i), axis);
+        sign = Blend(win, Blend(_mm_cmpgt_ps(f, zero), _mm_set1_ps(-1.0f), _mm_set1_ps(1.0f)), sign);
+        tExit = Blend(_mm_cmplt_ps(tf, tExit), tf, tExit);
+    }
+    const __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(tEnter, tExit), _mm_cmpge_ps(tEnter, zero)),
+                                  _mm_cmple_ps(tEnter, _mm_set1_ps(maxT)));
+
+    alignas(16) float te[4], xs[4], sg[4], ht[4];
+    _mm_store_ps(te, tEnter); _mm_store_ps(xs, axis); _mm_store_ps(sg, sign); _mm_store_ps(ht, hit);
+    for (int l = 0; l < 4; ++l) {
+        uint32_t bits;
+        std::memcpy(&bits, &ht[l], sizeof bits);
+        if (!bits) { out[l] = { FLT_MAX, { 0.0f, 0.0f, 0.0f } }; continue; }
+        const int a = (int)xs[l];
+        const uint32_t b = idx[l];
+        out[l] = { te[l], { bx.ax[a][b] * sg[l], bx.ay[a][b] * sg[l], bx.az[a][b] * sg[l] } };
+    }
+}
+#endif
+
+void RayBoxes(const BoxSoA& boxes, const RaySegment& ray, float maxT, const uint32_t* slots, size_t count,
+              RayBoxHit* out, NarrowphasePath path) {
+    size_t i = 0;
+#ifdef ECLIPSERA_SSE2
+    if (path == NarrowphasePath::Simd) {
+        for (; i < count; i += 4) {
+            // a short last group repeats its final box
+            uint32_t idx[4];
+            for (size_t l = 0; l < 4; ++l) idx[l] = slots[std::min(i + l, count - 1)];
+            RayBoxHit r[4];
+            RayBoxSimd4(boxes, ray, maxT, idx, r);
+            for (size_t l = 0; l < 4 && i + l < count; ++l) out[i + l] = r[l];
+        }
+        return;
+    }
+#else
+    (void)path;
+#endif
+    for (; i < count; ++i) out[i] = RayBoxScalar(boxes.Get(slots[i]), ray, maxT);
+}
@@ -0,0 +1,378 @@
+#pragma once
+#include <raylib.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// SSE2 is baseline on x64; other targets take the scalar path.
+#if !defined(ECLIPSERA_SSE2) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define ECLIPSERA_SSE2 1
+#endif
+
+// -------- bounds --------
+struct Aabb {
+    Vector3 min, max;
+};
+
+inline bool AabbOverlaps(const Aabb& a, const Aabb& b) {
+    return a.min.x <= b.max.x && a.max.x >= b.min.x
+        && a.min.y <= b.max.y && a.max.y >= b.min.y
+        && a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+inline bool AabbContains(const Aabb& outer, const Aabb& inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z
+        && outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+inline Aabb AabbUnion(const Aabb& a, const Aabb& b) {
+    return { { a.min.x < b.min.x ? a.min.x : b.min.x, a.min.y < b.min.y ? a.min.y : b.min.y, a.min.z < b.min.z ? a.min.z : b.min.z },
+             { a.max.x > b.max.x ? a.max.x : b.max.x, a.max.y > b.max.y ? a.max.y : b.max.y, a.max.z > b.max.z ? a.max.z : b.max.z } };
+}
+
+// Half the surface area; the insertion cost metric.
+inline float AabbArea(const Aabb& a) {
+    const float x = a.max.x - a.min.x, y = a.max.y - a.min.y, z = a.max.z - a.min.z;
+    return x*y + y*z + z*x;
+}
+
+// -------- rays --------
+// The segment origin + t * direction, 0 <= t <= maxT. invDirection holds
+// 1 / direction per component (infinite along axes the ray does not move on).
+struct RaySegment {
+    Vector3 origin, direction, invDirection;
+    float   maxT;
+};
+
+inline RaySegment MakeRay(Vector3 origin, Vector3 direction, float maxT = 1.0f) {
+    return { origin, direction, { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z }, maxT };
+}
+
+// Slab test; tEnter is where the ray enters the box (0 if it starts inside).
+// NaN from 0 * inf is dropped by the comparisons.
+inline bool RayAabb(const RaySegment& r, const Aabb& b, float maxT, float& tEnter) {
+    float t0 = 0.0f, t1 = maxT;
+    const float o[3]  = { r.origin.x, r.origin.y, r.origin.z };
+    const float iv[3] = { r.invDirection.x, r.invDirection.y, r.invDirection.z };
+    const float lo[3] = { b.min.x, b.min.y, b.min.z }, hi[3] = { b.max.x, b.max.y, b.max.z };
+    for (int i = 0; i < 3; ++i) {
+        float ta = (lo[i] - o[i]) * iv[i], tb = (hi[i] - o[i]) * iv[i];
+        if (ta > tb) { const float t = ta; ta = tb; tb = t; }
+        if (ta > t0) t0 = ta;
+        if (tb < t1) t1 = tb;
+    }
+    tEnter = t0;
+    return t0 <= t1;
+}
+
+// -------- dynamic AABB tree --------
+// Bounding volume hierarchy over fat AABBs. Nodes live in one array and are
+// recycled through a free list; leaves are inserted where they grow the tree's
+// area least and rotated AVL-style on the way back up, so the tree stays
+// balanced under any insertion order. Moving leaves only enlarge their
+// ancestors in place; Rebuild() then rebuilds just the enlarged part of the
+// tree with a binned surface-area split, which keeps query cost from drifting
+// as bodies wander. Leaf ids are stable until DestroyProxy.
+class AabbTree {
+public:
+    static constexpr int32_t kNull = -1;
+
+    int32_t CreateProxy(const Aabb& fat, uint32_t userData);
+    void    DestroyProxy(int32_t id);
+    // Replace a leaf's fat box: the leaf is removed and reinserted; ancestors are
+    // refit on the way up. Untouched subtrees keep their shape.
+    void    MoveProxy(int32_t id, const Aabb& fat);
+    // Replace a leaf's fat box and grow its ancestors to cover it, marking them
+    // for the next Rebuild. O(depth), no restructuring.
+    void    EnlargeProxy(int32_t id, const Aabb& fat);
+    // Rebuild the nodes marked by EnlargeProxy (everything when 'full'); subtrees
+    // that were not enlarged are kept whole and placed as units.
+    void    Rebuild(bool full);
+
+    const Aabb& FatAabb(int32_t id) const { return nodes[id].box; }
+    uint32_t    UserData(int32_t id) const { return nodes[id].userData; }
+    void        SetUserData(int32_t id, uint32_t userData) { nodes[id].userData = userData; }
+
+    // Calls fn(leafId) for every leaf whose fat box overlaps 'box'; fn returns
+    // false to stop. Uses a scratch stack owned by the tree: one query at a time.
+    template <class Fn>
+    void Query(const Aabb& box, Fn&& fn) const {
+        if (root == kNull) return;
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty()) {
+            const int32_t id = stack.back();
+            stack.pop_back();
+            const Node& n = nodes[id];
+            if (!AabbOverlaps(n.box, box)) continue;
+            if (n.child1 == kNull) { if (!fn(id)) return; continue; }
+            stack.push_back(n.child1);
+            stack.push_back(n.child2);
+        }
+    }
+
+    // Calls fn(leafId, maxT) for the leaves whose fat box the ray crosses before
+    // maxT, nearer subtrees first; fn returns the new maxT (the nearest hit so
+    // far), which prunes what is left. Returns the final maxT. Scratch is per
+    // thread, so rays may be cast from several threads at once.
+    template <class Fn>
+    float RayQuery(const RaySegment& ray, float maxT, Fn&& fn) const {
+        struct Entry { int32_t id; float t; };
+        static thread_local std::vector<Entry> rayStack;
+        float t;
+        if (root == kNull || !RayAabb(ray, nodes[root].box, maxT, t)) return maxT;
+        rayStack.clear();
+        rayStack.push_back({ root, t });
+        while (!rayStack.empty()) {
+            const Entry e = rayStack.back();
+            rayStack.pop_back();
+            if (e.t > maxT) continue;
+            const Node& n = nodes[e.id];
+            if (n.child1 == kNull) { maxT = fn(e.id, maxT); continue; }
+            float t1, t2;
+            const bool h1 = RayAabb(ray, nodes[n.child1].box, maxT, t1);
+            const bool h2 = RayAabb(ray, nodes[n.child2].box, maxT, t2);
+            if (h1 && h2) {
+                if (t1 <= t2) { rayStack.push_back({ n.child2, t2 }); rayStack.push_back({ n.child1, t1 }); }
+                else          { rayStack.push_back({ n.child1, t1 }); rayStack.push_back({ n.child2, t2 }); }
+            }
+            else if (h1) rayStack.push_back({ n.child1, t1 });
+            else if (h2) rayStack.push_back({ n.child2, t2 });
+        }
+        return maxT;
+    }
+
+    int32_t Height() const { return root == kNull ? 0 : nodes[root].height; }
+    size_t  LeafCount() const { return leaves; }
+    void    Clear();
+
+private:
+    struct Node {
+        Aabb     box;
+        int32_t  parent;   // next free node while on the free list
+        int32_t  child1, child2;
+        int32_t  height;   // leaf 0, free -1
+        uint32_t userData;
+        bool     enlarged;
+    };
+
+    int32_t allocNode();
+    void    freeNode(int32_t id);
+    void    insertLeaf(int32_t leaf);
+    void    removeLeaf(int32_t leaf);
+    int32_t balance(int32_t a);
+    void    refitUp(int32_t id);
+    int32_t build(int32_t* items, size_t count, int32_t parent);
+
+    std::vector<Node> nodes;
+    int32_t root{kNull};
+    int32_t freeList{kNull};
+    size_t  leaves{0};
+    mutable std::vector<int32_t> stack;
+    std::vector<int32_t> rebuildItems;
+};
+
+// -------- broadphase --------
+// Candidate pair of broadphase handles, a < b.
+struct BroadphasePair {
+    uint32_t a, b;
+};
+
+// Two AABB trees: one for static (anchored) proxies, one for everything that
+// can move. Proxies are stored fattened by kMargin plus a stretch along their
+// last displacement, so a body that moves a little each step keeps its leaf
+// and costs nothing; one that leaves its fat box enlarges it in place.
+// UpdatePairs first rebuilds the enlarged parts of both trees, then queries
+// only the proxies that left their fat box (or were added) since the previous
+// call; static-static pairs are never reported. Pairs reported once stay candidates while TestOverlap holds, so
+// callers keep them until then.
+// Every proxy belongs to one of kMaxGroups collision groups; group g collides
+// with the groups set in its mask. Pairs of groups that do not collide are
+// dropped as they are found, before they reach the narrowphase.
+class Broadphase {
+public:
+    static constexpr uint32_t kNoProxy            = 0xFFFFFFFFu;
+    static constexpr float    kMargin             = 0.1f;  // studs added on every side
+    static constexpr float    kDisplacementStretch = 2.0f; // steps of motion the fat box anticipates
+    static constexpr uint32_t kMaxGroups          = 32;
+
+    struct Stats {
+        uint32_t proxies{0}, staticProxies{0};
+        uint32_t moved{0};        // proxies re-queried by the last UpdatePairs
+        uint32_t pairs{0};        // pairs it reported
+        uint32_t filtered{0};     // overlapping pairs it dropped by collision group
+        int32_t  dynamicHeight{0}, staticHeight{0};
+    };
+
+    Broadphase();
+
+    uint32_t Add(const Aabb& box, bool isStatic, uint32_t userData, uint8_t group = 0);
+    void     Remove(uint32_t handle);
+    // 'displacement' is the motion since the last Move, used to stretch the fat box.
+    void     Move(uint32_t handle, const Aabb& box, Vector3 displacement);
+    void     SetStatic(uint32_t handle, bool isStatic);
+    void     SetGroup(uint32_t handle, uint8_t group);
+    // masks[g] bit h: groups g and h collide. Every proxy is queried again on
+    // the next UpdatePairs. Clear keeps the masks.
+    void     SetGroupMasks(const uint32_t* masks);
+    void     Clear();
+
+    // Clear 'out' and fill it with the pairs whose fat boxes overlap and that
+    // involve a proxy added or moved out of its fat box since the last call,
+    // sorted by (a, b) so the order does not depend on the trees' shape.
+    void UpdatePairs(std::vector<BroadphasePair>& out);
+    bool TestOverlap(uint32_t a, uint32_t b) const;
+    bool Collides(uint32_t a, uint32_t b) const {
+        return (groupMasks[proxies[a].group] >> proxies[b].group) & 1u;
+    }
+
+    // Calls fn(handle) for every proxy whose fat box overlaps 'box'; fn returns false to stop.
+    template <class Fn>
+    void Query(const Aabb& box, Fn&& fn) const {
+        bool go = true;
+        auto visit = [&](const AabbTree& t){
+            t.Query(box, [&](int32_t leaf){ go = fn(t.UserData(leaf)); return go; });
+        };
+        visit(dynamicTree);
+        if (go) visit(staticTree);
+    }
+
+    // Ray query over both trees (see AabbTree::RayQuery); fn(handle, maxT).
+    template <class Fn>
+    float RayQuery(const RaySegment& ray, float maxT, Fn&& fn) const {
+        auto visit = [&](const AabbTree& t){
+            maxT = t.RayQuery(ray, maxT, [&](int32_t leaf, float m){ return fn(t.UserData(leaf), m); });
+        };
+        visit(dynamicTree);
+        visit(staticTree);
+        return maxT;
+    }
+
+    uint32_t UserData(uint32_t handle) const { return proxies[handle].userData; }
+    void SetUserData(uint32_t handle, uint32_t userData) { proxies[handle].userData = userData; }
+    const Aabb& FatAabb(uint32_t handle) const { return tree(handle).FatAabb(proxies[handle].leaf); }
+    bool IsStatic(uint32_t handle) const { return proxies[handle].isStatic; }
+    const Stats& GetStats() const { return stats; }
+
+    // Snapshot support. Handles keep their numbers and fat boxes; Restore
+    // rebuilds the trees from them, so queries and UpdatePairs find the same
+    // proxies although the trees' shapes may differ. Group masks are kept.
+    struct SavedProxy {
+        Aabb     fat;
+        uint32_t userData;  // next free handle while free
+        uint8_t  live, isStatic, moved, group;
+    };
+    struct Saved {
+        std::vector<SavedProxy> proxies;  // by handle
+        std::vector<uint32_t>   moves;
+        uint32_t                freeHandle{kNoProxy};
+    };
+    void Save(Saved& out) const;
+    // False (and nothing changed) if 'in' is not self-consistent.
+    bool Restore(const Saved& in);
+
+private:
+    struct Proxy {
+        int32_t  leaf;      // in the static or dynamic tree; AabbTree::kNull while free
+        uint32_t userData;  // next free handle while free
+        bool     isStatic;
+        bool     moved;     // queued in moveBuffer
+        uint8_t  group;
+    };
+
+    const AabbTree& tree(uint32_t h) const { return proxies[h].isStatic ? staticTree : dynamicTree; }
+    AabbTree&       tree(uint32_t h)       { return proxies[h].isStatic ? staticTree : dynamicTree; }
+    void queueMove(uint32_t h);
+
+    AabbTree dynamicTree, staticTree;  // leaf user data is the handle
+    std::vector<Proxy>    proxies;
+    std::vector<uint32_t> moveBuffer;
+    uint32_t freeHandle{kNoProxy};
+    uint32_t groupMasks[kMaxGroups];  // every group collides with every group until SetGroupMasks
+    Stats    stats;
+};
+
+// -------- narrowphase --------
+// Part geometry: centre, unit axes (the CFrame's rotation columns) and half size.
+struct OrientedBox {
+    Vector3 center;
+    Vector3 axis[3];
+    Vector3 half;
+};
+
+// Boxes by body slot, one array per component, so a batch of pairs can be
+// loaded lane by lane.
+struct BoxSoA {
+    std::vector<float> cx, cy, cz;
+    std::vector<float> ax[3], ay[3], az[3];  // axis i = (ax[i], ay[i], az[i])
+    std::vector<float> hx, hy, hz;
+
+    size_t Size() const { return cx.size(); }
+    void Resize(size_t n);
+    void Set(size_t i, const OrientedBox& b);
+    OrientedBox Get(size_t i) const;
+    void Move(size_t dst, size_t src);
+};
+
+// Feature ids name the pair of box features that produced a point, so the
+// same contact is recognised from one step to the next.
+struct ContactPoint {
+    Vector3  position;        // world, midway between the surfaces
+    float    separation;      // negative when penetrating
+    uint32_t id;
+    float    normalImpulse;   // accumulated by the solver, carried over for warm starting
+    float    tangentImpulse[2];
+};
+
+struct ContactManifold {
+    static constexpr int kMaxPoints = 4;
+    Vector3      normal;      // unit, from box A toward box B
+    int          count;       // 0 when the boxes are apart
+    ContactPoint points[kMaxPoints];
+};
+
+// Cached pair of colliding proxies. It lives while their fat boxes overlap, so
+// the manifold (and the impulses the solver stores in it) carries over between
+// steps; 'manifold.count' is 0 while the boxes are near but not touching.
+struct Contact {
+    uint32_t        proxyA, proxyB;  // broadphase handles, proxyA < proxyB
+    ContactManifold manifold;        // normal points from A's body to B's
+};
+
+enum class NarrowphasePath : uint8_t { Scalar, Simd };
+
+// Where a ray enters a box: t along the ray and the face's outward normal.
+struct RayBoxHit {
+    float   t;       // FLT_MAX on a miss
+    Vector3 normal;
+};
+
+// Ray against box i of 'boxes', for 'count' slots; rays starting inside a box
+// miss it. The Simd path tests four boxes per SSE lane group with the same
+// operations as the scalar one.
+void RayBoxes(const BoxSoA& boxes, const RaySegment& ray, float maxT, const uint32_t* slots, size_t count,
+              RayBoxHit* out, NarrowphasePath path);
+
+// Boxes closer than this still produce (speculative) contact points.
+constexpr float kSpeculativeDistance = 0.04f;
+
+// Separating-axis test over the 15 candidate axes and, if the boxes are within
+// kSpeculativeDistance, a manifold of up to four points: face contacts clip the
+// incident face against the reference face, edge contacts use the closest
+// points of the two edges. Returns false (count 0) when separated.
+bool CollideBoxes(const OrientedBox& a, const OrientedBox& b, ContactManifold& out);
+
+// Exact overlap tests for spatial queries; touching counts as overlapping.
+bool BoxesOverlap(const OrientedBox& a, const OrientedBox& b);
+bool SphereOverlapsBox(Vector3 center, float radius, const OrientedBox& b);
+
+// Collide 'count' body pairs (slots into 'boxes'): the separating-axis tests
+// run four pairs per SSE lane group on the Simd path, then manifolds are
+// built for the pairs that touch. Feature ids are assigned but impulses are
+// zero; see MatchContacts.
+void CollideBoxPairs(const BoxSoA& boxes, const BroadphasePair* pairs, size_t count,
+                     ContactManifold* out, NarrowphasePath path);
+
+// Copy accumulated impulses from 'old' into points of 'fresh' with the same id,
+// or failing that, into the nearest point within a small distance.
+void MatchContacts(const ContactManifold& old, ContactManifold& fresh);
@@ -0,0 +1,25 @@
+#include "subsystems/physics/PhysicsSync.h"
+#include "subsystems/physics/PhysicsWorld.h"
+#include "bootstrap/instances/BasePart.h"
+#include "bootstrap/ScriptingAPI.h"
+#include "bootstrap/signals/Signal.h"
+#include "lua.h"
+
+uint32_t DispatchTouchEvents(lua_State* L) {
+    const auto& events = PhysicsWorld::Get().TouchEvents();
+    if (!L || events.empty()) return 0;
+    uint32_t fired = 0;
+    auto fire = [&](BasePart* self, BasePart* other, bool began){
+        const auto& sig = began ? self->Touch.touched : self->Touch.ended;
+        if (!sig || sig->IsClosed() || !sig->HasListeners()) return;
+        Lua_PushInstance(L, other->shared_from_this());
+        sig->Fire(L, lua_gettop(L), 1);
+        lua_pop(L, 1);
+        ++fired;
+    };
+    for (const PhysicsWorld::TouchEvent& e : events) {
+        fire(e.a, e.b, e.began);
+        fire(e.b, e.a, e.began);
+    }
+    return fired;
+}
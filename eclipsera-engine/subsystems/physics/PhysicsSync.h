@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+struct lua_State;
+
+// Delivers the last physics step's touch transitions to Lua: every event
+// fires Touched or TouchEnded on both parts, with the other part as the
+// argument. Runs once per step, after PhysicsWorld::Step and before
+// PostSimulation; parts nobody listens to cost one pointer test. Returns the
+// number of signals fired.
+uint32_t DispatchTouchEvents(lua_State* L);
@@ -0,0 +1,1167 @@
+#include "subsystems/physics/PhysicsWorld.h"
+#include "bootstrap/Assemblies.h"
+#include "bootstrap/instances/BasePart.h"
+#include "bootstrap/instances/Part.h"
+#include "bootstrap/instances/Workspace.h"
+#include "core/runtime/TaskScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+static double NowSeconds() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// World AABB of the part's oriented box: |R| * size/2 around the position.
+static Aabb PartBounds(const BasePart& p) {
+    const float* R = p.CF.R;
+    const ::Vector3 h = { 0.5f * p.Size.x, 0.5f * p.Size.y, 0.5f * p.Size.z };
+    const Vector3 e = {
+        std::fabs(R[0])*h.x + std::fabs(R[1])*h.y + std::fabs(R[2])*h.z,
+        std::fabs(R[3])*h.x + std::fabs(R[4])*h.y + std::fabs(R[5])*h.z,
+        std::fabs(R[6])*h.x + std::fabs(R[7])*h.y + std::fabs(R[8])*h.z };
+    const Vector3 c = { p.CF.p.x, p.CF.p.y, p.CF.p.z };
+    return { { c.x - e.x, c.y - e.y, c.z - e.z }, { c.x + e.x, c.y + e.y, c.z + e.z } };
+}
+
+static OrientedBox CFrameBox(const CFrame& cf, ::Vector3 size) {
+    const float* R = cf.R;
+    OrientedBox b;
+    b.center  = { cf.p.x, cf.p.y, cf.p.z };
+    b.axis[0] = { R[0], R[3], R[6] };
+    b.axis[1] = { R[1], R[4], R[7] };
+    b.axis[2] = { R[2], R[5], R[8] };
+    b.half    = { 0.5f * size.x, 0.5f * size.y, 0.5f * size.z };
+    return b;
+}
+
+static OrientedBox PartBox(const BasePart& p) { return CFrameBox(p.CF, p.Size); }
+
+static Aabb BoxBounds(const OrientedBox& b) {
+    const Vector3 e = {
+        std::fabs(b.axis[0].x)*b.half.x + std::fabs(b.axis[1].x)*b.half.y + std::fabs(b.axis[2].x)*b.half.z,
+        std::fabs(b.axis[0].y)*b.half.x + std::fabs(b.axis[1].y)*b.half.y + std::fabs(b.axis[2].y)*b.half.z,
+        std::fabs(b.axis[0].z)*b.half.x + std::fabs(b.axis[1].z)*b.half.y + std::fabs(b.axis[2].z)*b.half.z };
+    return { { b.center.x - e.x, b.center.y - e.y, b.center.z - e.z },
+             { b.center.x + e.x, b.center.y + e.y, b.center.z + e.z } };
+}
+
+// True when the part's CFrame is exactly the pose this world last wrote for
+// the body; anything else was set by a script and teleports the body.
+static bool MatchesPose(const BasePart& p, const RigidBodyStates& s, uint32_t slot) {
+    const Vector3 x = s.position[slot];
+    if (p.CF.p.x != x.x || p.CF.p.y != x.y || p.CF.p.z != x.z) return false;
+    float R[9];
+    RotationFromQuaternion(s.orientation[slot], R);
+    for (int i = 0; i < 9; ++i) if (p.CF.R[i] != R[i]) return false;
+    return true;
+}
+
+static CFrame PoseCFrame(Vector3 x, Quaternion q) {
+    CFrame cf;
+    RotationFromQuaternion(q, cf.R);
+    cf.p = { x.x, x.y, x.z };
+    return cf;
+}
+
+static bool SameCFrame(const CFrame& a, const CFrame& b) {
+    if (a.p.x != b.p.x || a.p.y != b.p.y || a.p.z != b.p.z) return false;
+    for (int i = 0; i < 9; ++i) if (a.R[i] != b.R[i]) return false;
+    return true;
+}
+
+static Aabb QueryFatBox(const Aabb& box) {
+    const float m = Broadphase::kMargin;
+    return { { box.min.x - m, box.min.y - m, box.min.z - m }, { box.max.x + m, box.max.y + m, box.max.z + m } };
+}
+
+static uint64_t PairKey(uint32_t a, uint32_t b) { return ((uint64_t)a << 32) | b; }
+
+static bool IsUnder(const Instance* inst, const Workspace* ws) {
+    for (auto p = inst->Parent.lock(); p; p = p->Parent.lock())
+        if (p.get() == ws) return true;
+    return false;
+}
+
+PhysicsWorld& PhysicsWorld::Get() {
+    static PhysicsWorld* w = new PhysicsWorld(); // leaked: parts may outlive static destruction order
+    return *w;
+}
+
+int32_t PhysicsWorld::find(const BasePart* p) const {
+    const uint32_t s = p->PhysicsSlot;
+    return (s < bodies.size() && bodies[s].part == p) ? (int32_t)s : -1;
+}
+
+// -------- bodies --------
+void PhysicsWorld::add(BasePart* p) {
+    const uint32_t slot = (uint32_t)bodies.size();
+    p->PhysicsSlot = slot;
+    PhysicsBody b{};
+    b.part  = p;
+    b.proxy = Broadphase::kNoProxy;
+    b.queryLeaf = AabbTree::kNull;
+    b.body  = slot;
+    b.weld  = kNoWeld;
+    bodies.push_back(b);
+    boxes.Resize(bodies.size());
+    states.Resize(bodies.size());
+    awakePos.resize(bodies.size());
+    PoseFromCFrame(p->CF, states.position[slot], states.orientation[slot]);
+    refresh(slot, Change_Transform | Change_Shape | Change_Physics);
+    if (Assemblies::Get().AssemblyOf(p) != Assemblies::kNone) assembliesDirty = true;
+}
+
+void PhysicsWorld::remove(int32_t slot) {
+    // welds refer to slots, and the last body is about to take this one's
+    if (bodies[slot].weld != kNoWeld || bodies.back().weld != kNoWeld) dissolveAssemblies();
+    PhysicsBody& b = bodies[slot];
+    // whatever rested on the body has to notice it is gone
+    wakeBody((uint32_t)slot);
+    wakeAround(b.box);
+    sleep((uint32_t)slot);
+    if (b.proxy != Broadphase::kNoProxy) dropProxy(b.proxy);
+    if (b.queryLeaf != AabbTree::kNull) queryTree.DestroyProxy(b.queryLeaf);
+    // the part may be destroyed before TouchEnded reaches Lua
+    if (b.proxy != Broadphase::kNoProxy && !touching.empty()) touchRemoved.push_back(b.part->shared_from_this());
+    b.part->PhysicsSlot = 0xFFFFFFFFu;
+
+    const uint32_t last = (uint32_t)bodies.size() - 1;
+    if ((uint32_t)slot != last) {
+        bodies[slot] = bodies[last];
+        PhysicsBody& moved = bodies[slot];
+        moved.part->PhysicsSlot = (uint32_t)slot;
+        moved.body = (uint32_t)slot;
+        if (moved.proxy != Broadphase::kNoProxy) broadphase.SetUserData(moved.proxy, (uint32_t)slot);
+        if (moved.queryLeaf != AabbTree::kNull) queryTree.SetUserData(moved.queryLeaf, (uint32_t)slot);
+        boxes.Move((uint32_t)slot, last);
+        states.Move((uint32_t)slot, last);
+        if (states.awake[slot]) {
+            awakePos[slot] = awakePos[last];
+            awakeList[awakePos[slot]] = (uint32_t)slot;
+        }
+        if (states.sleepIsland[slot] != RigidBodyStates::kNoIsland) {
+            auto& members = sleepingIslands[states.sleepIsland[slot]];
+            *std::find(members.begin(), members.end(), last) = (uint32_t)slot;
+        }
+    }
+    bodies.pop_back();
+    boxes.Resize(bodies.size());
+    states.Resize(bodies.size());
+    awakePos.resize(bodies.size());
+    ++stats.bodiesUpdated;
+}
+
+void PhysicsWorld::refresh(uint32_t slot, uint32_t groups) {
+    PhysicsBody& b = bodies[slot];
+    const BasePart* p = b.part;
+    if (groups & (Change_Transform | Change_Shape)) {
+        const Aabb box = PartBounds(*p);
+        if (b.proxy != Broadphase::kNoProxy) {
+            const Vector3 d = { 0.5f * (box.min.x + box.max.x - b.box.min.x - b.box.max.x),
+                                0.5f * (box.min.y + box.max.y - b.box.min.y - b.box.max.y),
+                                0.5f * (box.min.z + box.max.z - b.box.min.z - b.box.max.z) };
+            broadphase.Move(b.proxy, box, d);
+        }
+        b.box = box;
+        if (b.queryLeaf != AabbTree::kNull && !AabbContains(queryTree.FatAabb(b.queryLeaf), box))
+            queryTree.MoveProxy(b.queryLeaf, QueryFatBox(box));
+        boxes.Set(slot, PartBox(*p));
+        if (!matchesPose(slot)) {
+            if (b.weld != kNoWeld && !b.anchored) {
+                // a script moved the assembly, or this part of it: the body follows the part
+                PoseFromCFrame(p->CF * weldOffsets[b.weld].inverse(), states.position[b.body], states.orientation[b.body]);
+                wakeBody(slot);
+            } else {
+                PoseFromCFrame(p->CF, states.position[slot], states.orientation[slot]);
+                if (b.anchored) wakeAround(b.box);
+                else wakeBody(slot);
+            }
+        }
+    }
+    if (groups & Change_Physics) {
+        b.anchored = p->Anchored;
+        b.canCollide = p->CanCollide;
+        if (b.canCollide && b.proxy == Broadphase::kNoProxy) b.proxy = broadphase.Add(b.box, b.anchored, slot, p->CollisionGroupId);
+        else if (!b.canCollide && b.proxy != Broadphase::kNoProxy) { dropProxy(b.proxy); b.proxy = Broadphase::kNoProxy; }
+        else if (b.proxy != Broadphase::kNoProxy) { broadphase.SetStatic(b.proxy, b.anchored); broadphase.SetGroup(b.proxy, p->CollisionGroupId); }
+        if (b.canCollide && b.queryLeaf != AabbTree::kNull) { queryTree.DestroyProxy(b.queryLeaf); b.queryLeaf = AabbTree::kNull; }
+        else if (!b.canCollide && b.queryLeaf == AabbTree::kNull) b.queryLeaf = queryTree.CreateProxy(QueryFatBox(b.box), slot);
+    }
+    if (groups & (Change_Shape | Change_Physics)) {
+        // mass and anchoring are the assembly's; regroup after this batch of records
+        if (b.weld != kNoWeld) assembliesDirty = true;
+        states.friction[slot] = p->Friction;
+        states.elasticity[slot] = p->Elasticity;
+        if (b.anchored) {
+            anchor(slot);
+        } else {
+            const MassProperties mp = BoxMassProperties(p->Size, p->Density);
+            states.invMass[slot] = mp.invMass;
+            states.invInertiaLocal[slot] = mp.invInertia;
+            wakeBody(slot);
+        }
+    }
+    ++stats.bodiesUpdated;
+}
+
+// Anchored bodies never move: no mass, no velocity, never awake.
+void PhysicsWorld::anchor(uint32_t slot) {
+    wakeBody(slot);
+    sleep(slot);
+    states.invMass[slot] = 0.0f;
+    states.invInertiaLocal[slot] = { 0.0f, 0.0f, 0.0f };
+    states.invInertiaWorld[slot] = Mat3{};
+    wakeAround(bodies[slot].box);
+}
+
+void PhysicsWorld::SetCollisionGroupMasks(const uint32_t* masks) {
+    broadphase.SetGroupMasks(masks);
+    // bodies asleep on something they no longer collide with have to fall
+    for (uint32_t slot = 0; slot < (uint32_t)bodies.size(); ++slot)
+        if (!bodies[slot].anchored) wakeBody(slot);
+}
+
+void PhysicsWorld::Reset() {
+    for (PhysicsBody& b : bodies) b.part->PhysicsSlot = 0xFFFFFFFFu;
+    bodies.clear();
+    states.Resize(0);
+    boxes.Resize(0);
+    broadphase.Clear();
+    queryTree.Clear();
+    newPairs.clear();
+    contacts.clear();
+    contactIndex.clear();
+    droppedProxies.clear();
+    proxyDropped.clear();
+    awakeList.clear();
+    awakePos.clear();
+    moved.clear();
+    touching.clear();
+    touchingPrev.clear();
+    touchEvents.clear();
+    touchRemoved.clear();
+    touchKept.clear();
+    sleepingIslands.clear();
+    freeIslands.clear();
+    weldSlots.clear();
+    weldOffsets.clear();
+    weldGroup.clear();
+    weldStart.clear();
+    assembliesDirty = true;
+    workspace.reset();
+    if (cursor != ChangeJournal::kNoCursor) {
+        ChangeJournal::Get().Unsubscribe(cursor);
+        cursor = ChangeJournal::kNoCursor;
+    }
+}
+
+// Handles are recycled, so contacts naming a removed proxy are purged before
+// the next UpdatePairs can hand its handle to another body.
+void PhysicsWorld::dropProxy(uint32_t proxy) {
+    broadphase.Remove(proxy);
+    if (contacts.empty()) return;
+    if (proxy >= proxyDropped.size()) proxyDropped.resize(proxy + 1, 0);
+    if (!proxyDropped[proxy]) { proxyDropped[proxy] = 1; droppedProxies.push_back(proxy); }
+}
+
+void PhysicsWorld::sync(const std::shared_ptr<Workspace>& ws) {
+    auto& journal = ChangeJournal::Get();
+    if (cursor == ChangeJournal::kNoCursor || workspace.lock() != ws) {
+        Reset();
+        cursor = journal.Subscribe();
+        workspace = ws;
+        bodies.reserve(ws->parts.size());
+        for (auto& p : ws->parts) if (p && p->Alive) add(p.get());
+    } else {
+        journal.Read(cursor, [&](const ChangeJournal::Record& r){
+            if (r.inst->Class != InstanceClass::Part) return;
+            auto* p = static_cast<BasePart*>(r.inst.get());
+            int32_t slot = find(p);
+
+            if (r.groups & (Change_Hierarchy | Change_Removed)) {
+                const bool inWorld = p->Alive && IsUnder(p, ws.get());
+                if (!inWorld) { if (slot >= 0) remove(slot); return; }
+                if (slot < 0) { add(p); return; }
+            }
+            if (slot >= 0 && (r.groups & (Change_Transform | Change_Shape | Change_Physics)))
+                refresh((uint32_t)slot, r.groups);
+        });
+    }
+    updateAssemblies();
+}
+
+// -------- sleeping --------
+void PhysicsWorld::wake(uint32_t slot) {
+    if (states.awake[slot] || states.invMass[slot] == 0.0f) return;
+    states.awake[slot] = 1;
+    states.sleepTime[slot] = 0.0f;
+    awakePos[slot] = (uint32_t)awakeList.size();
+    awakeList.push_back(slot);
+}
+
+void PhysicsWorld::sleep(uint32_t slot) {
+    states.linearVelocity[slot] = { 0.0f, 0.0f, 0.0f };
+    states.angularVelocity[slot] = { 0.0f, 0.0f, 0.0f };
+    if (!states.awake[slot]) return;
+    states.awake[slot] = 0;
+    const uint32_t pos = awakePos[slot], lastSlot = awakeList.back();
+    awakeList[pos] = lastSlot;
+    awakePos[lastSlot] = pos;
+    awakeList.pop_back();
+}
+
+void PhysicsWorld::wakeIsland(uint32_t island) {
+    std::vector<uint32_t> members;
+    members.swap(sleepingIslands[island]);
+    freeIslands.push_back(island);
+    for (uint32_t slot : members) {
+        states.sleepIsland[slot] = RigidBodyStates::kNoIsland;
+        wake(slot);
+    }
+    members.clear();
+    sleepingIslands[island].swap(members);  // keep the capacity for reuse
+}
+
+void PhysicsWorld::wakeBody(uint32_t slot) {
+    slot = bodies[slot].body;
+    const uint32_t island = states.sleepIsland[slot];
+    if (island != RigidBodyStates::kNoIsland) wakeIsland(island);
+    else wake(slot);
+}
+
+void PhysicsWorld::wakeAround(const Aabb& box) {
+    broadphase.Query(box, [&](uint32_t handle){
+        const uint32_t island = states.sleepIsland[bodies[broadphase.UserData(handle)].body];
+        if (island != RigidBodyStates::kNoIsland) wakeIsland(island);
+        return true;
+    });
+}
+
+void PhysicsWorld::sleepIsland(const uint32_t* slots, size_t count) {
+    uint32_t island;
+    if (!freeIslands.empty()) { island = freeIslands.back(); freeIslands.pop_back(); }
+    else { island = (uint32_t)sleepingIslands.size(); sleepingIslands.emplace_back(); }
+    sleepingIslands[island].assign(slots, slots + count);
+    for (size_t k = 0; k < count; ++k) {
+        states.sleepIsland[slots[k]] = island;
+        sleep(slots[k]);
+    }
+}
+
+// -------- assemblies --------
+CFrame PhysicsWorld::partPose(uint32_t slot) const {
+    const PhysicsBody& b = bodies[slot];
+    const CFrame frame = PoseCFrame(states.position[b.body], states.orientation[b.body]);
+    return (b.weld == kNoWeld || b.anchored) ? frame : frame * weldOffsets[b.weld];
+}
+
+// True when the part's CFrame is exactly the pose this world last wrote for
+// it; anything else was set by a script and teleports the body.
+bool PhysicsWorld::matchesPose(uint32_t slot) const {
+    const PhysicsBody& b = bodies[slot];
+    if (b.weld == kNoWeld || b.anchored) return MatchesPose(*b.part, states, slot);
+    return SameCFrame(b.part->CF, partPose(slot));
+}
+
+// Regroup when the welds changed or a welded part was added, removed or had
+// its mass or anchoring edited.
+void PhysicsWorld::updateAssemblies() {
+    auto& assemblies = Assemblies::Get();
+    const uint64_t version = assemblies.Version();
+    if (!assembliesDirty && version == assemblyVersion) return;
+    dissolveAssemblies();
+
+    std::vector<uint32_t> slots;
+    BasePart* const* parts = assemblies.Parts();
+    for (uint32_t a = 0; a < assemblies.Count(); ++a) {
+        slots.clear();
+        bool anchored = false;
+        for (uint32_t i = assemblies.Begin(a); i < assemblies.End(a); ++i) {
+            const int32_t slot = find(parts[i]);
+            if (slot < 0) continue;  // not in the workspace
+            slots.push_back((uint32_t)slot);
+            anchored = anchored || parts[i]->Anchored;
+        }
+        if (slots.size() > 1) mergeAssembly(slots, anchored);
+    }
+    assemblyVersion = version;
+    assembliesDirty = false;
+}
+
+// Every welded part back to a body of its own, moving as it did in the assembly.
+void PhysicsWorld::dissolveAssemblies() {
+    assembliesDirty = true;
+    if (weldSlots.empty()) return;
+    for (size_t g = 0; g + 1 < weldStart.size(); ++g) {
+        const uint32_t body = bodies[weldSlots[weldStart[g]]].body;
+        if (bodies[body].anchored) continue;
+        wakeBody(body);
+        const Vector3 x = states.position[body], v = states.linearVelocity[body], w = states.angularVelocity[body];
+        for (uint32_t k = weldStart[g]; k < weldStart[g + 1]; ++k) {
+            const uint32_t slot = weldSlots[k];
+            PoseFromCFrame(bodies[slot].part->CF, states.position[slot], states.orientation[slot]);
+            const Vector3 r = { states.position[slot].x - x.x, states.position[slot].y - x.y, states.position[slot].z - x.z };
+            states.linearVelocity[slot] = { v.x + w.y*r.z - w.z*r.y, v.y + w.z*r.x - w.x*r.z, v.z + w.x*r.y - w.y*r.x };
+            states.angularVelocity[slot] = w;
+        }
+    }
+    for (uint32_t slot : weldSlots) {
+        bodies[slot].body = slot;
+        bodies[slot].weld = kNoWeld;
+    }
+    // each part's own mass, anchoring and proxy kind
+    for (uint32_t slot : weldSlots) refresh(slot, Change_Physics);
+    weldSlots.clear();
+    weldOffsets.clear();
+    weldGroup.clear();
+    weldStart.clear();
+}
+
+// One body for 'slots', at their centre of mass with the first part's
+// orientation. The inertia tensor is summed about that frame; like a single
+// box, the body keeps only its diagonal. Momentum carries over.
+void PhysicsWorld::mergeAssembly(const std::vector<uint32_t>& slots, bool anchored) {
+    if (weldStart.empty()) weldStart.push_back(0);
+    const uint32_t group = (uint32_t)weldStart.size() - 1;
+    for (uint32_t slot : slots) {
+        bodies[slot].weld = (uint32_t)weldSlots.size();
+        weldSlots.push_back(slot);
+        weldGroup.push_back(group);
+        weldOffsets.push_back(CFrame());
+    }
+    weldStart.push_back((uint32_t)weldSlots.size());
+
+    if (anchored) {
+        for (uint32_t slot : slots) {
+            PhysicsBody& b = bodies[slot];
+            if (b.anchored) continue;
+            b.anchored = true;
+            if (b.proxy != Broadphase::kNoProxy) broadphase.SetStatic(b.proxy, true);
+            anchor(slot);
+        }
+        return;
+    }
+
+    float mass = 0.0f;
+    Vector3 com{ 0.0f, 0.0f, 0.0f }, v{ 0.0f, 0.0f, 0.0f }, w{ 0.0f, 0.0f, 0.0f };
+    std::vector<float> masses(slots.size());
+    for (size_t k = 0; k < slots.size(); ++k) {
+        const uint32_t slot = slots[k];
+        wakeBody(slot);
+        const BasePart* p = bodies[slot].part;
+        const float m = std::max(p->Density * p->Size.x * p->Size.y * p->Size.z, 1e-6f);
+        const Vector3 lv = states.linearVelocity[slot], av = states.angularVelocity[slot];
+        masses[k] = m;
+        mass += m;
+        com = { com.x + m * p->CF.p.x, com.y + m * p->CF.p.y, com.z + m * p->CF.p.z };
+        v = { v.x + m * lv.x, v.y + m * lv.y, v.z + m * lv.z };
+        w = { w.x + m * av.x, w.y + m * av.y, w.z + m * av.z };
+    }
+    com = { com.x / mass, com.y / mass, com.z / mass };
+    v = { v.x / mass, v.y / mass, v.z / mass };
+    w = { w.x / mass, w.y / mass, w.z / mass };
+
+    const uint32_t root = slots[0];
+    CFrame frame = bodies[root].part->CF;
+    frame.p = { com.x, com.y, com.z };
+    const CFrame toBody = frame.inverse();
+
+    // I = sum of Rrel diag(I_part) Rrel^T + m (|d|^2 E - d d^T), in body axes
+    float I[9] = {};
+    for (size_t k = 0; k < slots.size(); ++k) {
+        const BasePart* p = bodies[slots[k]].part;
+        const CFrame local = toBody * p->CF;
+        const float m = masses[k];
+        const float xx = p->Size.x * p->Size.x, yy = p->Size.y * p->Size.y, zz = p->Size.z * p->Size.z;
+        const float d[3] = { m * (yy + zz) / 12.0f, m * (xx + zz) / 12.0f, m * (xx + yy) / 12.0f };
+        const float* R = local.R;
+        const float o[3] = { local.p.x, local.p.y, local.p.z };
+        const float oo = o[0]*o[0] + o[1]*o[1] + o[2]*o[2];
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                I[r*3 + c] += R[r*3]*d[0]*R[c*3] + R[r*3 + 1]*d[1]*R[c*3 + 1] + R[r*3 + 2]*d[2]*R[c*3 + 2]
+                            + m * ((r == c ? oo : 0.0f) - o[r]*o[c]);
+    }
+
+    for (size_t k = 0; k < slots.size(); ++k) {
+        const uint32_t slot = slots[k];
+        bodies[slot].body = root;
+        weldOffsets[bodies[slot].weld] = toBody * bodies[slot].part->CF;
+        if (slot == root) continue;
+        sleep(slot);
+        states.invMass[slot] = 0.0f;
+        states.invInertiaLocal[slot] = { 0.0f, 0.0f, 0.0f };
+        states.invInertiaWorld[slot] = Mat3{};
+    }
+    PoseFromCFrame(frame, states.position[root], states.orientation[root]);
+    states.invMass[root] = 1.0f / mass;
+    states.invInertiaLocal[root] = { I[0] > 0.0f ? 1.0f / I[0] : 0.0f, I[4] > 0.0f ? 1.0f / I[4] : 0.0f,
+                                     I[8] > 0.0f ? 1.0f / I[8] : 0.0f };
+    states.linearVelocity[root] = v;
+    states.angularVelocity[root] = w;
+    states.sleepTime[root] = 0.0f;
+}
+
+// -------- contacts --------
+void PhysicsWorld::updateContacts() {
+    auto dropped = [&](uint32_t h){ return h < proxyDropped.size() && proxyDropped[h]; };
+    auto bodyOf = [&](uint32_t h){ return bodies[broadphase.UserData(h)].body; };
+    for (size_t i = 0; i < contacts.size();) {
+        const Contact& c = contacts[i];
+        // parts welded into one body do not collide with each other
+        bool keep = !dropped(c.proxyA) && !dropped(c.proxyB)
+            && !(broadphase.IsStatic(c.proxyA) && broadphase.IsStatic(c.proxyB))
+            && broadphase.Collides(c.proxyA, c.proxyB)
+            && bodyOf(c.proxyA) != bodyOf(c.proxyB);
+        // neither body moved unless one is awake
+        if (keep && (states.awake[bodyOf(c.proxyA)] || states.awake[bodyOf(c.proxyB)]))
+            keep = broadphase.TestOverlap(c.proxyA, c.proxyB);
+        if (keep) { ++i; continue; }
+        contactIndex.erase(PairKey(c.proxyA, c.proxyB));
+        if (i + 1 != contacts.size()) {
+            contacts[i] = contacts.back();
+            contactIndex[PairKey(contacts[i].proxyA, contacts[i].proxyB)] = (uint32_t)i;
+        }
+        contacts.pop_back();
+    }
+    for (uint32_t h : droppedProxies) proxyDropped[h] = 0;
+    droppedProxies.clear();
+
+    for (const BroadphasePair& p : newPairs) {
+        if (bodyOf(p.a) == bodyOf(p.b)) continue;
+        auto [it, inserted] = contactIndex.try_emplace(PairKey(p.a, p.b), (uint32_t)contacts.size());
+        if (!inserted) continue;
+        Contact c{};
+        c.proxyA = p.a;
+        c.proxyB = p.b;
+        contacts.push_back(c);
+    }
+
+    // only pairs with an awake body can have changed
+    const size_t n = contacts.size();
+    slotPairs.resize(n);
+    bodyPairs.resize(n);
+    activePairs.clear();
+    activeIds.clear();
+    for (size_t i = 0; i < n; ++i) {
+        const BroadphasePair sp = { broadphase.UserData(contacts[i].proxyA), broadphase.UserData(contacts[i].proxyB) };
+        const BroadphasePair bp = { bodies[sp.a].body, bodies[sp.b].body };
+        slotPairs[i] = sp;
+        bodyPairs[i] = bp;
+        if (states.awake[bp.a] || states.awake[bp.b]) { activePairs.push_back(sp); activeIds.push_back((uint32_t)i); }
+    }
+
+    const size_t active = activeIds.size();
+    manifolds.resize(active);
+    constexpr size_t kNarrowphaseGrain = 256;
+    TaskScheduler::Get().ParallelFor(active, kNarrowphaseGrain, [&](size_t b, size_t e){
+        CollideBoxPairs(boxes, activePairs.data() + b, e - b, manifolds.data() + b, NarrowphasePath::Simd);
+        for (size_t k = b; k < e; ++k) {
+            ContactManifold& old = contacts[activeIds[k]].manifold;
+            MatchContacts(old, manifolds[k]);
+            old = manifolds[k];
+        }
+    });
+
+    stats.contacts = (uint32_t)active;
+    stats.touching = stats.points = 0;
+    for (uint32_t id : activeIds) {
+        stats.touching += contacts[id].manifold.count > 0;
+        stats.points += (uint32_t)contacts[id].manifold.count;
+    }
+}
+
+// A pair starts touching once its boxes overlap and stops when it has no
+// contact points left, which are kept out to kSpeculativeDistance; the gap
+// keeps resting contacts from flickering. Only the diff against the previous
+// step's sorted set produces events.
+void PhysicsWorld::updateTouches() {
+    touchKept.clear();
+    touchEvents.clear();
+    touchingPrev.swap(touching);
+    touching.clear();
+
+    auto wasTouching = [&](uint64_t key, const BasePart* a, const BasePart* b){
+        auto it = std::lower_bound(touchingPrev.begin(), touchingPrev.end(), key,
+                                   [](const Touch& t, uint64_t k){ return t.key < k; });
+        return it != touchingPrev.end() && it->key == key && it->a == a && it->b == b;
+    };
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        const Contact& c = contacts[i];
+        const ContactManifold& m = c.manifold;
+        if (m.count == 0) continue;
+        BasePart* a = bodies[slotPairs[i].a].part;
+        BasePart* b = bodies[slotPairs[i].b].part;
+        if (!a->CanTouch || !b->CanTouch) continue;
+        const uint64_t key = PairKey(c.proxyA, c.proxyB);
+        float minSeparation = m.points[0].separation;
+        for (int k = 1; k < m.count; ++k) minSeparation = std::min(minSeparation, m.points[k].separation);
+        if (minSeparation <= 0.0f || wasTouching(key, a, b)) touching.push_back({ key, a, b });
+    }
+    std::sort(touching.begin(), touching.end(), [](const Touch& x, const Touch& y){ return x.key < y.key; });
+
+    // merge: keys only in the new set began, keys only in the old one ended;
+    // a recycled handle shows up as the same key with other parts
+    size_t i = 0, j = 0;
+    while (i < touchingPrev.size() || j < touching.size()) {
+        const Touch* o = i < touchingPrev.size() ? &touchingPrev[i] : nullptr;
+        const Touch* n = j < touching.size() ? &touching[j] : nullptr;
+        if (o && n && o->key == n->key) {
+            if (o->a != n->a || o->b != n->b) {
+                touchEvents.push_back({ o->a, o->b, false });
+                touchEvents.push_back({ n->a, n->b, true });
+            }
+            ++i; ++j;
+        } else if (o && (!n || o->key < n->key)) {
+            touchEvents.push_back({ o->a, o->b, false });
+            ++i;
+        } else {
+            touchEvents.push_back({ n->a, n->b, true });
+            ++j;
+        }
+    }
+    touchKept.swap(touchRemoved);
+}
+
+// -------- simulation --------
+void PhysicsWorld::solve(float dt) {
+    // an awake body touching a sleeping one wakes its whole island
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        if (contacts[i].manifold.count == 0) continue;
+        const uint32_t a = bodyPairs[i].a, b = bodyPairs[i].b;
+        if (states.awake[a] == states.awake[b]) continue;
+        const uint32_t sleeper = states.awake[a] ? b : a;
+        if (states.sleepIsland[sleeper] != RigidBodyStates::kNoIsland) wakeIsland(states.sleepIsland[sleeper]);
+    }
+
+    // poses before the step, for render interpolation
+    moved.assign(awakeList.begin(), awakeList.end());
+    movedFrom.resize(moved.size());
+    movedFromRot.resize(moved.size());
+    for (size_t k = 0; k < moved.size(); ++k) {
+        movedFrom[k] = states.position[moved[k]];
+        movedFromRot[k] = states.orientation[moved[k]];
+    }
+
+    islands.Build(states, awakeList.data(), awakeList.size(), contacts.data(), bodyPairs.data(), contacts.size());
+    const size_t n = islands.Count();
+    islandSleep.resize(n);
+
+    const Vector3 gravity = { 0.0f, -kGravity, 0.0f };
+    const size_t grain = std::max<size_t>(1, n / (8 * ((size_t)TaskScheduler::Get().WorkerCount() + 1)));
+    TaskScheduler::Get().ParallelFor(n, grain, [&](size_t b, size_t e){
+        for (size_t i = b; i < e; ++i)
+            islandSleep[i] = StepIsland(states, islands.Bodies(i), islands.BodyCount(i),
+                                        contacts.data(), bodyPairs.data(), islands.Contacts(i), islands.ContactCount(i),
+                                        gravity, dt, settings);
+    });
+    stats.islands = (uint32_t)n;
+}
+
+// Copy solved poses to the parts. The journal records this produces come back
+// through sync() next step, where MatchesPose tells them from script edits.
+void PhysicsWorld::writePoses() {
+    for (uint32_t slot : awakeList) {
+        const PhysicsBody& b = bodies[slot];
+        if (b.weld == kNoWeld) {
+            BasePart* p = b.part;
+            const Vector3 x = states.position[slot];
+            RotationFromQuaternion(states.orientation[slot], p->CF.R);
+            p->CF.p = { x.x, x.y, x.z };
+            p->PropertyChanged(kTransformProps);
+            continue;
+        }
+        // the same arithmetic as partPose, so matchesPose recognises these
+        const CFrame frame = PoseCFrame(states.position[slot], states.orientation[slot]);
+        const uint32_t g = weldGroup[b.weld];
+        for (uint32_t k = weldStart[g]; k < weldStart[g + 1]; ++k) {
+            BasePart* p = bodies[weldSlots[k]].part;
+            p->CF = frame * weldOffsets[k];
+            p->PropertyChanged(kTransformProps);
+        }
+    }
+    for (size_t i = 0; i < islands.Count(); ++i)
+        if (islandSleep[i] >= kTimeToSleep) sleepIsland(islands.Bodies(i), islands.BodyCount(i));
+}
+
+// -------- queries --------
+bool QueryFilter::Accepts(const BasePart& p) const {
+    if (respectCanCollide && !p.CanCollide) return false;
+    if (instances.empty()) return !include;
+    auto listed = [&](const Instance* i){ return std::binary_search(instances.begin(), instances.end(), i); };
+    bool found = listed(&p);
+    for (auto a = p.Parent.lock(); a && !found; a = a->Parent.lock()) found = listed(a.get());
+    return found == include;
+}
+
+// Candidates come from the broadphase trees and the query-only tree and are
+// tested four at a time; each batch shortens the ray for the trees' pruning.
+bool PhysicsWorld::castRay(const RaySegment& ray, const QueryFilter* filter, RayHit& hit) const {
+    uint32_t batch[4];
+    size_t batched = 0;
+    float best = ray.maxT;
+    uint32_t bestSlot = 0;
+    Vector3 bestNormal{ 0.0f, 0.0f, 0.0f };
+    bool found = false;
+
+    auto flush = [&]{
+        RayBoxHit r[4];
+        RayBoxes(boxes, ray, best, batch, batched, r, NarrowphasePath::Simd);
+        for (size_t l = 0; l < batched; ++l) {
+            if (r[l].t > best) continue;  // misses are FLT_MAX
+            best = r[l].t;
+            bestSlot = batch[l];
+            bestNormal = r[l].normal;
+            found = true;
+        }
+        batched = 0;
+    };
+    auto visit = [&](uint32_t slot){
+        if (filter && !filter->Accepts(*bodies[slot].part)) return best;
+        batch[batched++] = slot;
+        if (batched == 4) flush();
+        return best;
+    };
+    float maxT = broadphase.RayQuery(ray, ray.maxT, [&](uint32_t handle, float){ return visit(broadphase.UserData(handle)); });
+    queryTree.RayQuery(ray, maxT, [&](int32_t leaf, float){ return visit(queryTree.UserData(leaf)); });
+    if (batched) flush();
+
+    hit.part = nullptr;
+    if (!found) return false;
+    hit.part = bodies[bestSlot].part;
+    hit.position = { ray.origin.x + ray.direction.x * best,
+                     ray.origin.y + ray.direction.y * best,
+                     ray.origin.z + ray.direction.z * best };
+    hit.normal = bestNormal;
+    hit.distance = best * std::sqrt(ray.direction.x*ray.direction.x + ray.direction.y*ray.direction.y
+                                    + ray.direction.z*ray.direction.z);
+    return true;
+}
+
+bool PhysicsWorld::Raycast(const std::shared_ptr<Workspace>& ws, Vector3 origin, Vector3 direction,
+                           const QueryFilter* filter, RayHit& hit) {
+    hit.part = nullptr;
+    if (!ws) return false;
+    sync(ws);
+    return castRay(MakeRay(origin, direction), filter, hit);
+}
+
+void PhysicsWorld::RaycastMany(const std::shared_ptr<Workspace>& ws, const Vector3* origins, const Vector3* directions,
+                               size_t count, const QueryFilter* filter, RayHit* hits) {
+    if (!ws) { for (size_t i = 0; i < count; ++i) hits[i].part = nullptr; return; }
+    sync(ws);
+    constexpr size_t kRayGrain = 256;
+    TaskScheduler::Get().ParallelFor(count, kRayGrain, [&](size_t b, size_t e){
+        for (size_t i = b; i < e; ++i) castRay(MakeRay(origins[i], directions[i]), filter, hits[i]);
+    });
+}
+
+// Candidates are the leaves of all three trees whose fat box overlaps
+// 'bounds'; the body's tight box is checked before the exact test.
+template <class Test>
+void PhysicsWorld::overlap(const Aabb& bounds, const QueryFilter* filter, size_t maxParts, const BasePart* skip,
+                           Test&& test, std::vector<BasePart*>& out) const {
+    out.clear();
+    const size_t limit = maxParts ? maxParts : SIZE_MAX;
+    auto visit = [&](uint32_t slot){
+        const PhysicsBody& b = bodies[slot];
+        if (b.part == skip || !AabbOverlaps(b.box, bounds)) return true;
+        if (filter && !filter->Accepts(*b.part)) return true;
+        if (test(boxes.Get(slot))) out.push_back(b.part);
+        return out.size() < limit;
+    };
+    broadphase.Query(bounds, [&](uint32_t handle){ return visit(broadphase.UserData(handle)); });
+    if (out.size() < limit)
+        queryTree.Query(bounds, [&](int32_t leaf){ return visit(queryTree.UserData(leaf)); });
+}
+
+void PhysicsWorld::GetPartsInBox(const std::shared_ptr<Workspace>& ws, const CFrame& cframe, Vector3 size,
+                                 const QueryFilter* filter, size_t maxParts, std::vector<BasePart*>& out) {
+    out.clear();
+    if (!ws) return;
+    sync(ws);
+    const OrientedBox box = CFrameBox(cframe, size);
+    overlap(BoxBounds(box), filter, maxParts, nullptr,
+            [&](const OrientedBox& b){ return BoxesOverlap(box, b); }, out);
+}
+
+void PhysicsWorld::GetPartsInRadius(const std::shared_ptr<Workspace>& ws, Vector3 center, float radius,
+                                    const QueryFilter* filter, size_t maxParts, std::vector<BasePart*>& out) {
+    out.clear();
+    if (!ws || !(radius >= 0.0f)) return;
+    sync(ws);
+    const Aabb bounds{ { center.x - radius, center.y - radius, center.z - radius },
+                       { center.x + radius, center.y + radius, center.z + radius } };
+    overlap(bounds, filter, maxParts, nullptr,
+            [&](const OrientedBox& b){ return SphereOverlapsBox(center, radius, b); }, out);
+}
+
+void PhysicsWorld::GetPartsInPart(const std::shared_ptr<Workspace>& ws, const BasePart& part,
+                                  const QueryFilter* filter, size_t maxParts, std::vector<BasePart*>& out) {
+    out.clear();
+    if (!ws) return;
+    sync(ws);
+    const OrientedBox box = PartBox(part);
+    overlap(BoxBounds(box), filter, maxParts, &part,
+            [&](const OrientedBox& b){ return BoxesOverlap(box, b); }, out);
+}
+
+void PhysicsWorld::InterpolatedPoses(float alpha, std::vector<InterpolatedPose>& out) const {
+    out.clear();
+    out.reserve(moved.size());
+    const float t = std::clamp(alpha, 0.0f, 1.0f);
+    for (size_t k = 0; k < moved.size(); ++k) {
+        const uint32_t slot = moved[k];
+        const PhysicsBody& b = bodies[slot];
+        if (b.weld == kNoWeld && !MatchesPose(*b.part, states, slot)) continue;
+        // a body the step put to sleep is drawn where it stopped
+        const float a = states.awake[slot] ? t : 1.0f;
+        const Vector3 x0 = movedFrom[k], x1 = states.position[slot];
+        Quaternion q0 = movedFromRot[k];
+        const Quaternion q1 = states.orientation[slot];
+        if (q0.x*q1.x + q0.y*q1.y + q0.z*q1.z + q0.w*q1.w < 0.0f) q0 = { -q0.x, -q0.y, -q0.z, -q0.w };
+        Quaternion q = { q0.x + (q1.x - q0.x) * a, q0.y + (q1.y - q0.y) * a,
+                         q0.z + (q1.z - q0.z) * a, q0.w + (q1.w - q0.w) * a };
+        const float inv = 1.0f / std::sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w);
+        q = { q.x * inv, q.y * inv, q.z * inv, q.w * inv };
+
+        const Vector3 x = { x0.x + (x1.x - x0.x) * a, x0.y + (x1.y - x0.y) * a, x0.z + (x1.z - x0.z) * a };
+        if (b.weld == kNoWeld) {
+            InterpolatedPose& ip = out.emplace_back();
+            ip.part = b.part;
+            RotationFromQuaternion(q, ip.cframe.R);
+            ip.cframe.p = { x.x, x.y, x.z };
+            continue;
+        }
+        const CFrame frame = PoseCFrame(x, q);
+        const uint32_t g = weldGroup[b.weld];
+        for (uint32_t m = weldStart[g]; m < weldStart[g + 1]; ++m) {
+            if (!matchesPose(weldSlots[m])) continue;
+            InterpolatedPose& ip = out.emplace_back();
+            ip.part = bodies[weldSlots[m]].part;
+            ip.cframe = frame * weldOffsets[m];
+        }
+    }
+}
+
+void PhysicsWorld::Step(const std::shared_ptr<Workspace>& ws, double dt) {
+    stats.bodiesUpdated = 0;
+    stats.islands = 0;
+    moved.clear();  // sync may renumber slots
+    if (!ws) { if (workspace.lock() || !bodies.empty()) Reset(); return; }
+    const float h = (float)dt;  // one SimulationClock step; the clock bounds catch-up
+
+    const double t0 = NowSeconds();
+    sync(ws);
+    const double t1 = NowSeconds();
+    broadphase.UpdatePairs(newPairs);
+    const double t2 = NowSeconds();
+    updateContacts();
+    const double t3 = NowSeconds();
+    updateTouches();
+    const double t4 = NowSeconds();
+    if (h > 0.0f) solve(h);
+    const double t5 = NowSeconds();
+    if (h > 0.0f) writePoses();
+    const double t6 = NowSeconds();
+
+    stats.bodies          = (uint32_t)bodies.size();
+    stats.assemblies      = weldStart.empty() ? 0 : (uint32_t)weldStart.size() - 1;
+    stats.pairsFound      = (uint32_t)newPairs.size();
+    stats.pairsFiltered   = broadphase.GetStats().filtered;
+    stats.awakeBodies     = (uint32_t)awakeList.size();
+    stats.sleepingIslands = (uint32_t)(sleepingIslands.size() - freeIslands.size());
+    stats.syncMs          = (float)((t1 - t0 + t6 - t5) * 1000.0);
+    stats.broadphaseMs    = (float)((t2 - t1) * 1000.0);
+    stats.narrowphaseMs   = (float)((t3 - t2) * 1000.0);
+    stats.solveMs         = (float)((t5 - t4) * 1000.0);
+    stats.touchingPairs   = (uint32_t)touching.size();
+    stats.touchEvents     = (uint32_t)touchEvents.size();
+    stats.touchMs         = (float)((t4 - t3) * 1000.0);
+}
+
+// -------- snapshots --------
+namespace {
+
+constexpr uint32_t kSnapshotMagic   = 0x4E534850u;  // "PHSN"
+constexpr uint32_t kSnapshotVersion = 2;
+
+// Boxes, bounds and the query tree follow from the part's CFrame and Size,
+// so they are rebuilt on restore rather than saved.
+struct SavedBody {
+    uint64_t part;      // address
+    float    R[9];
+    Vector3  position;
+    Vector3  size;
+    uint32_t proxy;
+    uint32_t body, weld;
+    uint8_t  anchored, canCollide, group, pad;
+};
+
+struct SavedTouch {
+    uint64_t key;
+    uint32_t a, b;  // body slots
+};
+
+static_assert(std::is_trivially_copyable_v<Contact> && std::is_trivially_copyable_v<Broadphase::SavedProxy>
+              && std::is_trivially_copyable_v<Mat3> && std::is_trivially_copyable_v<SimulationClock::State>
+              && std::is_trivially_copyable_v<CFrame>,
+              "snapshot arrays are copied as bytes");
+
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::vector<uint8_t>& out) : out(out) {}
+    template <class T> void Value(const T& v) { bytes(&v, sizeof(T)); }
+    template <class T> bool Array(const std::vector<T>& v) {
+        Value((uint64_t)v.size());
+        bytes(v.data(), v.size() * sizeof(T));
+        return true;
+    }
+
+private:
+    void bytes(const void* p, size_t n) {
+        if (!n) return;
+        const size_t at = out.size();
+        out.resize(at + n);
+        std::memcpy(out.data() + at, p, n);
+    }
+    std::vector<uint8_t>& out;
+};
+
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t* data, size_t size) : p(data), end(data + size) {}
+    template <class T> bool Value(T& v) {
+        if ((size_t)(end - p) < sizeof(T)) return false;
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+    template <class T> bool Array(std::vector<T>& v) {
+        uint64_t n = 0;
+        if (!Value(n) || n > (uint64_t)(end - p) / sizeof(T)) return false;
+        v.resize((size_t)n);
+        if (n) std::memcpy(v.data(), p, (size_t)n * sizeof(T));
+        p += (size_t)n * sizeof(T);
+        return true;
+    }
+    bool AtEnd() const { return p == end; }
+
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+};
+
+} // namespace
+
+void PhysicsWorld::Snapshot(const std::shared_ptr<Workspace>& ws, std::vector<uint8_t>& out) {
+    out.clear();
+    if (ws) sync(ws);
+    out.reserve(64 + bodies.size() * (sizeof(SavedBody) + 160) + contacts.size() * sizeof(Contact));
+    SnapshotWriter w(out);
+    w.Value(kSnapshotMagic);
+    w.Value(kSnapshotVersion);
+
+    std::vector<SavedBody> saved(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        const PhysicsBody& b = bodies[i];
+        const BasePart* p = b.part;
+        SavedBody& sb = saved[i];
+        sb.part = (uint64_t)(uintptr_t)p;
+        std::memcpy(sb.R, p->CF.R, sizeof(sb.R));
+        sb.position = { p->CF.p.x, p->CF.p.y, p->CF.p.z };
+        sb.size = { p->Size.x, p->Size.y, p->Size.z };
+        sb.proxy = b.proxy;
+        sb.body = b.body;
+        sb.weld = b.weld;
+        sb.anchored = b.anchored;
+        sb.canCollide = b.canCollide;
+        sb.group = p->CollisionGroupId;
+        sb.pad = 0;
+    }
+    w.Array(saved);
+    RigidBodyStates::ForEachArray(states, [&](const auto& v){ return w.Array(v); });
+
+    Broadphase::Saved bp;
+    broadphase.Save(bp);
+    w.Array(bp.proxies);
+    w.Array(bp.moves);
+    w.Value(bp.freeHandle);
+
+    w.Array(contacts);
+    w.Array(droppedProxies);
+    w.Array(awakeList);
+    w.Value((uint64_t)sleepingIslands.size());
+    for (const auto& island : sleepingIslands) w.Array(island);
+    w.Array(freeIslands);
+    w.Array(weldSlots);
+    w.Array(weldOffsets);
+    w.Array(weldGroup);
+    w.Array(weldStart);
+
+    // pairs with a part removed since the last step have only their TouchEnded left
+    std::vector<SavedTouch> touches;
+    touches.reserve(touching.size());
+    for (const Touch& t : touching) {
+        const int32_t a = find(t.a), b = find(t.b);
+        if (a >= 0 && b >= 0) touches.push_back({ t.key, (uint32_t)a, (uint32_t)b });
+    }
+    w.Array(touches);
+    w.Value(clock.GetState());
+}
+
+bool PhysicsWorld::Restore(const std::shared_ptr<Workspace>& ws, const uint8_t* data, size_t size) {
+    if (!ws || !data) return false;
+    sync(ws);
+
+    SnapshotReader r(data, size);
+    uint32_t magic = 0, version = 0;
+    std::vector<SavedBody> saved;
+    RigidBodyStates st;
+    Broadphase::Saved bp;
+    std::vector<Contact> cs;
+    std::vector<uint32_t> dropped, awake, freeIsl, wSlots, wGroup, wStart;
+    std::vector<CFrame> wOffsets;
+    std::vector<std::vector<uint32_t>> sleeping;
+    std::vector<SavedTouch> touches;
+    SimulationClock::State cl{};
+    uint64_t islandCount = 0;
+
+    bool ok = r.Value(magic) && magic == kSnapshotMagic && r.Value(version) && version == kSnapshotVersion
+           && r.Array(saved)
+           && RigidBodyStates::ForEachArray(st, [&](auto& v){ return r.Array(v); })
+           && r.Array(bp.proxies) && r.Array(bp.moves) && r.Value(bp.freeHandle)
+           && r.Array(cs) && r.Array(dropped) && r.Array(awake)
+           && r.Value(islandCount) && islandCount <= size;
+    if (ok) {
+        sleeping.resize((size_t)islandCount);
+        for (auto& island : sleeping) ok = ok && r.Array(island);
+    }
+    ok = ok && r.Array(freeIsl) && r.Array(wSlots) && r.Array(wOffsets) && r.Array(wGroup) && r.Array(wStart)
+         && r.Array(touches) && r.Value(cl) && r.AtEnd();
+    if (!ok) return false;
+
+    // the same parts, with the same properties the saved state was derived from
+    const size_t n = saved.size();
+    if (n != bodies.size()) return false;
+    std::vector<uint64_t> have(n), want(n);
+    for (size_t i = 0; i < n; ++i) { have[i] = (uint64_t)(uintptr_t)bodies[i].part; want[i] = saved[i].part; }
+    std::sort(have.begin(), have.end());
+    std::sort(want.begin(), want.end());
+    if (have != want) return false;
+    for (const SavedBody& sb : saved) {
+        const BasePart* p = reinterpret_cast<const BasePart*>((uintptr_t)sb.part);
+        if (p->Size.x != sb.size.x || p->Size.y != sb.size.y || p->Size.z != sb.size.z) return false;
+        if (bodies[p->PhysicsSlot].anchored != (sb.anchored != 0) || p->CanCollide != (sb.canCollide != 0)) return false;
+        if (p->CollisionGroupId != sb.group) return false;
+    }
+
+    // welded into the same bodies as now: saved and current bodies must map one to one
+    const size_t welded = wSlots.size(), groups = wStart.empty() ? 0 : wStart.size() - 1;
+    if (wOffsets.size() != welded || wGroup.size() != welded || (welded && wStart.back() != welded)) return false;
+    for (size_t g = 0; g < groups; ++g) if (wStart[g] > wStart[g + 1]) return false;
+    for (size_t k = 0; k < welded; ++k) {
+        if (wSlots[k] >= n || wGroup[k] >= groups || saved[wSlots[k]].weld != k) return false;
+        if (k < wStart[wGroup[k]] || k >= wStart[wGroup[k] + 1]) return false;
+    }
+    std::vector<uint32_t> toCurrent(n, kNoWeld), toSaved(n, kNoWeld);
+    for (size_t i = 0; i < n; ++i) {
+        const SavedBody& sb = saved[i];
+        const PhysicsBody& cur = bodies[reinterpret_cast<const BasePart*>((uintptr_t)sb.part)->PhysicsSlot];
+        if (sb.body >= n || (sb.weld == kNoWeld) != (cur.weld == kNoWeld)) return false;
+        if (sb.weld != kNoWeld && (sb.weld >= welded || wSlots[sb.weld] != i)) return false;
+        if (sb.weld == kNoWeld && sb.body != i) return false;
+        if (toCurrent[sb.body] == kNoWeld && toSaved[cur.body] == kNoWeld) { toCurrent[sb.body] = cur.body; toSaved[cur.body] = sb.body; }
+        if (toCurrent[sb.body] != cur.body || toSaved[cur.body] != sb.body) return false;
+    }
+
+    // and indices that stay in range
+    bool sized = true;
+    RigidBodyStates::ForEachArray(st, [&](const auto& v){ sized = sized && v.size() == n; return sized; });
+    if (!sized) return false;
+    const size_t handles = bp.proxies.size();
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t h = saved[i].proxy;
+        if (saved[i].canCollide ? (h >= handles || !bp.proxies[h].live || bp.proxies[h].userData != i)
+                                : h != Broadphase::kNoProxy) return false;
+    }
+    for (const Contact& c : cs) if (c.proxyA >= handles || c.proxyB >= handles) return false;
+    for (uint32_t h : dropped) if (h >= handles) return false;
+    for (uint32_t s : awake) if (s >= n) return false;
+    for (const auto& island : sleeping) for (uint32_t s : island) if (s >= n) return false;
+    for (uint32_t i : freeIsl) if (i >= sleeping.size()) return false;
+    for (const SavedTouch& t : touches) if (t.a >= n || t.b >= n) return false;
+    if (!broadphase.Restore(bp)) return false;
+
+    // nothing can fail from here on
+    states = std::move(st);
+    boxes.Resize(n);
+    queryTree.Clear();
+    for (size_t i = 0; i < n; ++i) {
+        const SavedBody& sb = saved[i];
+        BasePart* p = reinterpret_cast<BasePart*>((uintptr_t)sb.part);
+        std::memcpy(p->CF.R, sb.R, sizeof(sb.R));
+        p->CF.p = { sb.position.x, sb.position.y, sb.position.z };
+        p->PhysicsSlot = (uint32_t)i;
+        p->PropertyChanged(kTransformProps);
+
+        PhysicsBody& b = bodies[i];
+        b.part = p;
+        b.box = PartBounds(*p);
+        b.proxy = sb.proxy;
+        b.queryLeaf = sb.canCollide ? AabbTree::kNull : queryTree.CreateProxy(QueryFatBox(b.box), (uint32_t)i);
+        b.body = sb.body;
+        b.weld = sb.weld;
+        b.anchored = sb.anchored != 0;
+        b.canCollide = sb.canCollide != 0;
+        boxes.Set(i, PartBox(*p));
+    }
+    weldSlots = std::move(wSlots);
+    weldOffsets = std::move(wOffsets);
+    weldGroup = std::move(wGroup);
+    weldStart = std::move(wStart);
+
+    contacts = std::move(cs);
+    contactIndex.clear();
+    for (size_t i = 0; i < contacts.size(); ++i) contactIndex[PairKey(contacts[i].proxyA, contacts[i].proxyB)] = (uint32_t)i;
+    droppedProxies = std::move(dropped);
+    proxyDropped.assign(handles, 0);
+    for (uint32_t h : droppedProxies) proxyDropped[h] = 1;
+    newPairs.clear();
+
+    awakeList = std::move(awake);
+    awakePos.assign(n, 0);
+    for (size_t k = 0; k < awakeList.size(); ++k) awakePos[awakeList[k]] = (uint32_t)k;
+    sleepingIslands = std::move(sleeping);
+    freeIslands = std::move(freeIsl);
+    moved.clear();  // nothing to interpolate from
+
+    touching.clear();
+    for (const SavedTouch& t : touches) touching.push_back({ t.key, bodies[t.a].part, bodies[t.b].part });
+    touchingPrev.clear();
+    touchEvents.clear();
+    touchRemoved.clear();
+    touchKept.clear();
+
+    clock.SetState(cl);
+    // the CFrames written above are this world's own, not edits to sync
+    ChangeJournal::Get().Read(cursor, [](const ChangeJournal::Record&){});
+    return true;
+}
+
+uint64_t PhysicsWorld::StateHash() const {
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&](const void* data, size_t n){
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+    };
+    mix(states.position.data(), states.position.size() * sizeof(Vector3));
+    mix(states.orientation.data(), states.orientation.size() * sizeof(Quaternion));
+    mix(states.linearVelocity.data(), states.linearVelocity.size() * sizeof(Vector3));
+    mix(states.angularVelocity.data(), states.angularVelocity.size() * sizeof(Vector3));
+    return h;
+}
@@ -0,0 +1,267 @@
+#pragma once
+#include <raylib.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "bootstrap/ChangeJournal.h"
+#include "core/datatypes/CFrame.h"
+#include "subsystems/physics/Collision.h"
+#include "subsystems/physics/RigidBody.h"
+#include "subsystems/physics/SimulationClock.h"
+#include "subsystems/physics/Solver.h"
+
+struct BasePart;
+struct Instance;
+struct Workspace;
+
+// Per-part state the physics world derives from BasePart properties.
+struct PhysicsBody {
+    BasePart* part;      // owner; removed before the part can leave the workspace
+    Aabb      box;       // world AABB of the oriented part
+    uint32_t  proxy;     // broadphase handle; Broadphase::kNoProxy unless CanCollide
+    int32_t   queryLeaf; // leaf in the query-only tree while not CanCollide, else AabbTree::kNull
+    uint32_t  body;      // slot whose state moves the part: its own unless welded to other parts
+    uint32_t  weld;      // index in the weld arrays while in an assembly, else PhysicsWorld::kNoWeld
+    bool      anchored;  // also set for every part of an assembly with an anchored part
+    bool      canCollide;
+};
+
+// Where to draw a body between the last two steps.
+struct InterpolatedPose {
+    BasePart* part;
+    CFrame    cframe;
+};
+
+// Which parts a spatial query may return. Listed instances match themselves
+// and their descendants.
+struct QueryFilter {
+    std::vector<const Instance*> instances;  // sorted
+    bool include{false};            // only the listed subtrees, rather than everything else
+    bool respectCanCollide{false};  // skip parts with CanCollide off
+
+    bool Accepts(const BasePart& p) const;
+};
+
+// Retained copy of the workspace's parts for simulation. Like the renderer's
+// RenderScene it follows the ChangeJournal, so parts that did not change cost
+// nothing per step. Anchored parts live in the broadphase's static tree;
+// parts that do not collide live in a separate tree that only queries use.
+//
+// Unanchored parts are simulated: each step the awake bodies are grouped into
+// islands by the contacts between them, islands are solved in parallel on the
+// TaskScheduler, and the resulting poses are written back to the parts. An
+// island whose bodies have all been nearly still for kTimeToSleep goes to
+// sleep as a unit and costs nothing until something touches or edits one of
+// its bodies.
+//
+// The main loop steps the world at the fixed rate of Clock(); the renderer
+// draws moving bodies interpolated between the last two steps. Stepping is
+// deterministic on any number of threads: new pairs are taken in handle
+// order, contacts keep their order in the cache, each island is solved on one
+// thread in contact order and the parallel stages write disjoint results. Each step also
+// diffs the set of touching pairs against the previous one, and PhysicsSync
+// turns the transitions into Touched / TouchEnded signals.
+//
+// Parts welded into an assembly (see Assemblies) are simulated as one body:
+// the state of the first part's slot holds the assembly's centre of mass,
+// mass and inertia, the other slots hold no mass, and each part keeps its
+// offset from that frame. Contacts on any of the parts act on the shared
+// body, and each step writes every part's pose from it in one pass. An
+// assembly with an anchored part is anchored as a whole.
+class PhysicsWorld {
+public:
+    static constexpr uint32_t kNoWeld = 0xFFFFFFFFu;
+
+    static constexpr float kGravity     = 196.2f;      // studs/s^2
+    static constexpr float kTimeToSleep = 0.5f;        // seconds
+
+    struct Stats {
+        uint32_t bodies{0};
+        uint32_t bodiesUpdated{0};  // bodies refreshed from journal records by the last Step
+        uint32_t pairsFound{0};     // new broadphase candidate pairs
+        uint32_t pairsFiltered{0};  // overlapping pairs the broadphase dropped by collision group
+        uint32_t contacts{0};       // cached pairs collided by the last Step
+        uint32_t touching{0};       // of those, pairs with contact points
+        uint32_t points{0};
+        uint32_t awakeBodies{0};
+        uint32_t islands{0};        // solved by the last Step
+        uint32_t assemblies{0};     // welded groups of parts, each simulated as one body
+        uint32_t sleepingIslands{0};
+        float    syncMs{0.0f};      // journal records in, poses out
+        float    broadphaseMs{0.0f};
+        float    narrowphaseMs{0.0f};
+        float    solveMs{0.0f};
+        uint32_t touchingPairs{0};  // pairs of CanTouch parts in contact after the last Step
+        uint32_t touchEvents{0};    // touches it began or ended
+        float    touchMs{0.0f};     // diffing the touching pairs against the previous step
+    };
+
+    // A touch that began or ended in the last Step. Parts removed since the
+    // step before are kept alive until the next Step, so both pointers are
+    // valid until then.
+    struct TouchEvent {
+        BasePart* a;
+        BasePart* b;
+        bool      began;  // false: the touch ended
+    };
+
+    static PhysicsWorld& Get();
+
+    // Apply pending journal records (full rebuild on first use or when the
+    // workspace changes), gather new candidate pairs, collide the cached pairs
+    // that involve an awake body, solve the awake islands and write their
+    // poses back to the parts.
+    void Step(const std::shared_ptr<Workspace>& ws, double dt);
+    void Reset();
+
+    // masks[g] bit h: parts in collision groups g and h collide (see
+    // PhysicsService). Kept across Reset; wakes every body.
+    void SetCollisionGroupMasks(const uint32_t* masks);
+
+    struct RayHit {
+        BasePart* part;      // null on a miss
+        Vector3   position;
+        Vector3   normal;    // outward normal of the face hit
+        float     distance;  // studs from the origin
+    };
+
+    // Nearest part hit by the segment from 'origin' to origin + direction;
+    // rays that start inside a part do not hit it. Pending journal records are
+    // applied first, so the query sees this frame's edits.
+    bool Raycast(const std::shared_ptr<Workspace>& ws, Vector3 origin, Vector3 direction,
+                 const QueryFilter* filter, RayHit& hit);
+    // 'count' rays, cast in parallel on the TaskScheduler.
+    void RaycastMany(const std::shared_ptr<Workspace>& ws, const Vector3* origins, const Vector3* directions,
+                     size_t count, const QueryFilter* filter, RayHit* hits);
+
+    // Parts overlapping a box, a sphere or another part, by exact tests
+    // against each part's oriented box. 'out' is cleared and holds at most
+    // 'maxParts' parts (0: no limit), in no particular order. Pending journal
+    // records are applied first, as for Raycast.
+    void GetPartsInBox(const std::shared_ptr<Workspace>& ws, const CFrame& cframe, Vector3 size,
+                       const QueryFilter* filter, size_t maxParts, std::vector<BasePart*>& out);
+    void GetPartsInRadius(const std::shared_ptr<Workspace>& ws, Vector3 center, float radius,
+                          const QueryFilter* filter, size_t maxParts, std::vector<BasePart*>& out);
+    // 'part' itself is never returned; it need not be in the workspace.
+    void GetPartsInPart(const std::shared_ptr<Workspace>& ws, const BasePart& part,
+                        const QueryFilter* filter, size_t maxParts, std::vector<BasePart*>& out);
+
+    // -------- snapshots --------
+    // The whole simulation state in one contiguous buffer: bodies with their
+    // poses and velocities, broadphase proxies with their fat boxes, cached
+    // contacts with their impulses, sleeping islands, touching pairs, the
+    // welded groups and the clock's progress. Pending journal records are applied first. Stepping
+    // after a Restore repeats the steps taken after the Snapshot bit for bit.
+    // Settings, the step rate and collision group masks are configuration and
+    // are not saved. Parts are referenced by address, so a snapshot is only
+    // good in the process that took it.
+    void Snapshot(const std::shared_ptr<Workspace>& ws, std::vector<uint8_t>& out);
+    // The workspace must hold the same parts as when 'data' was taken, with
+    // the same Size, Anchored, CanCollide, CollisionGroup and welds; otherwise this
+    // returns false and changes nothing. Parts get their saved CFrames back.
+    bool Restore(const std::shared_ptr<Workspace>& ws, const uint8_t* data, size_t size);
+    // FNV-1a over every body's pose and velocities, for comparing runs.
+    uint64_t StateHash() const;
+
+    // Touched / TouchEnded transitions of the last Step, in pair order.
+    const std::vector<TouchEvent>& TouchEvents() const { return touchEvents; }
+
+    // Poses of the bodies the last Step moved, 'alpha' of the way from before
+    // it to after it. Parts a script has moved since are left out.
+    void InterpolatedPoses(float alpha, std::vector<InterpolatedPose>& out) const;
+
+    SimulationClock& Clock() { return clock; }
+    const std::vector<PhysicsBody>&    Bodies() const { return bodies; }
+    const RigidBodyStates&             States() const { return states; }
+    const std::vector<BroadphasePair>& NewPairs() const { return newPairs; }  // broadphase handles
+    const std::vector<Contact>&        Contacts() const { return contacts; }
+    const Broadphase& GetBroadphase() const { return broadphase; }
+    SolverSettings&   Settings() { return settings; }
+    const Stats& GetStats() const { return stats; }
+
+private:
+    int32_t find(const BasePart* p) const;
+    void add(BasePart* p);
+    void remove(int32_t slot);
+    void refresh(uint32_t slot, uint32_t groups);
+    void sync(const std::shared_ptr<Workspace>& ws);
+    void dropProxy(uint32_t proxy);
+    void anchor(uint32_t slot);
+
+    // assemblies
+    void updateAssemblies();
+    void dissolveAssemblies();
+    void mergeAssembly(const std::vector<uint32_t>& slots, bool anchored);
+    CFrame partPose(uint32_t slot) const;
+    bool matchesPose(uint32_t slot) const;
+    void updateContacts();
+    void updateTouches();
+    void solve(float dt);
+    void writePoses();
+    bool castRay(const RaySegment& ray, const QueryFilter* filter, RayHit& hit) const;
+    template <class Test>
+    void overlap(const Aabb& bounds, const QueryFilter* filter, size_t maxParts, const BasePart* skip,
+                 Test&& test, std::vector<BasePart*>& out) const;
+
+    // sleeping
+    void wake(uint32_t slot);
+    void sleep(uint32_t slot);
+    void wakeIsland(uint32_t island);
+    void wakeBody(uint32_t slot);           // the body, or the island it sleeps in
+    void wakeAround(const Aabb& box);       // every sleeping body whose fat box overlaps
+    void sleepIsland(const uint32_t* slots, size_t count);
+
+    std::vector<PhysicsBody>    bodies;
+    RigidBodyStates             states;  // by body slot
+    BoxSoA                      boxes;   // by body slot
+    Broadphase                  broadphase;
+    AabbTree                    queryTree;  // parts without CanCollide; seen by queries only
+    std::vector<BroadphasePair> newPairs;
+
+    std::vector<Contact>                   contacts;
+    std::unordered_map<uint64_t, uint32_t> contactIndex;  // proxyA << 32 | proxyB
+    std::vector<uint32_t>                  droppedProxies;  // removed since the last updateContacts
+    std::vector<uint8_t>                   proxyDropped;    // by handle
+    std::vector<BroadphasePair>            slotPairs;       // every contact as the slots of its parts
+    std::vector<BroadphasePair>            bodyPairs;       // ... and of the bodies that move them
+    std::vector<BroadphasePair>            activePairs;     // contacts with an awake body, for the narrowphase
+    std::vector<uint32_t>                  activeIds;
+    std::vector<ContactManifold>           manifolds;
+
+    std::vector<uint32_t>              awakeList;     // awake body slots
+    std::vector<uint32_t>              awakePos;      // by body slot: index in awakeList
+    std::vector<std::vector<uint32_t>> sleepingIslands;
+    std::vector<uint32_t>              freeIslands;
+    IslandBuilder                      islands;
+    std::vector<float>                 islandSleep;
+    SolverSettings                     settings;
+    std::vector<uint32_t>              moved;          // slots stepped by the last Step
+    std::vector<Vector3>               movedFrom;      // their poses before it
+    std::vector<Quaternion>            movedFromRot;
+    SimulationClock                    clock;
+
+    // welded parts, grouped by assembly; the group's body is its first part's slot
+    std::vector<uint32_t> weldSlots;
+    std::vector<CFrame>   weldOffsets;     // pose in the body's frame, by index
+    std::vector<uint32_t> weldGroup;       // by index
+    std::vector<uint32_t> weldStart;       // by group, plus one
+    uint64_t              assemblyVersion{0};
+    bool                  assembliesDirty{false};
+
+    // touches: contacts between CanTouch parts, by broadphase pair key
+    struct Touch {
+        uint64_t  key;
+        BasePart* a;
+        BasePart* b;
+    };
+    std::vector<Touch>                     touching;       // sorted by key
+    std::vector<Touch>                     touchingPrev;
+    std::vector<TouchEvent>                touchEvents;
+    std::vector<std::shared_ptr<Instance>> touchRemoved;   // parts removed since the last diff
+    std::vector<std::shared_ptr<Instance>> touchKept;      // parts removed before it, named by touchEvents
+
+    ChangeJournal::Cursor cursor{ ChangeJournal::kNoCursor };
+    std::weak_ptr<Workspace> workspace;
+    Stats stats;
+};
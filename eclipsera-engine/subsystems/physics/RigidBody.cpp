@@ -0,0 +1,124 @@
+#include "subsystems/physics/RigidBody.h"
+#include "core/datatypes/CFrame.h"
+#include <cmath>
+
+static constexpr float kMaxAngularSpeed = 100.0f;  // rad/s; keeps thin parts from spinning up without bound
+
+MassProperties BoxMassProperties(Vector3 size, float density) {
+    const float mass = density * size.x * size.y * size.z;
+    if (!(mass > 0.0f)) return { 0.0f, { 0.0f, 0.0f, 0.0f } };
+    const float xx = size.x * size.x, yy = size.y * size.y, zz = size.z * size.z;
+    const float k = 12.0f / mass;
+    return { 1.0f / mass, { k / (yy + zz), k / (xx + zz), k / (xx + yy) } };
+}
+
+void RigidBodyStates::Resize(size_t n) {
+    position.resize(n);
+    orientation.resize(n, Quaternion{ 0.0f, 0.0f, 0.0f, 1.0f });
+    linearVelocity.resize(n);
+    angularVelocity.resize(n);
+    invMass.resize(n);
+    invInertiaLocal.resize(n);
+    invInertiaWorld.resize(n);
+    friction.resize(n);
+    elasticity.resize(n);
+    sleepTime.resize(n);
+    sleepIsland.resize(n, kNoIsland);
+    awake.resize(n);
+}
+
+void RigidBodyStates::Move(size_t dst, size_t src) {
+    position[dst]        = position[src];
+    orientation[dst]     = orientation[src];
+    linearVelocity[dst]  = linearVelocity[src];
+    angularVelocity[dst] = angularVelocity[src];
+    invMass[dst]         = invMass[src];
+    invInertiaLocal[dst] = invInertiaLocal[src];
+    invInertiaWorld[dst] = invInertiaWorld[src];
+    friction[dst]        = friction[src];
+    elasticity[dst]      = elasticity[src];
+    sleepTime[dst]       = sleepTime[src];
+    sleepIsland[dst]     = sleepIsland[src];
+    awake[dst]           = awake[src];
+}
+
+// -------- poses --------
+void PoseFromCFrame(const CFrame& cf, Vector3& position, Quaternion& q) {
+    const float* R = cf.R;
+    position = { cf.p.x, cf.p.y, cf.p.z };
+    const float trace = R[0] + R[4] + R[8];
+    if (trace > 0.0f) {
+        const float s = 2.0f * std::sqrt(trace + 1.0f);
+        q = { (R[7] - R[5]) / s, (R[2] - R[6]) / s, (R[3] - R[1]) / s, 0.25f * s };
+    } else if (R[0] > R[4] && R[0] > R[8]) {
+        const float s = 2.0f * std::sqrt(1.0f + R[0] - R[4] - R[8]);
+        q = { 0.25f * s, (R[1] + R[3]) / s, (R[2] + R[6]) / s, (R[7] - R[5]) / s };
+    } else if (R[4] > R[8]) {
+        const float s = 2.0f * std::sqrt(1.0f + R[4] - R[0] - R[8]);
+        q = { (R[1] + R[3]) / s, 0.25f * s, (R[5] + R[7]) / s, (R[2] - R[6]) / s };
+    } else {
+        const float s = 2.0f * std::sqrt(1.0f + R[8] - R[0] - R[4]);
+        q = { (R[2] + R[6]) / s, (R[5] + R[7]) / s, 0.25f * s, (R[3] - R[1]) / s };
+    }
+    const float len = std::sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w);
+    q = { q.x / len, q.y / len, q.z / len, q.w / len };
+}
+
+void RotationFromQuaternion(Quaternion q, float R[9]) {
+    const float xx = q.x*q.x, yy = q.y*q.y, zz = q.z*q.z;
+    const float xy = q.x*q.y, xz = q.x*q.z, yz = q.y*q.z;
+    const float wx = q.w*q.x, wy = q.w*q.y, wz = q.w*q.z;
+    R[0] = 1.0f - 2.0f*(yy + zz); R[1] = 2.0f*(xy - wz);        R[2] = 2.0f*(xz + wy);
+    R[3] = 2.0f*(xy + wz);        R[4] = 1.0f - 2.0f*(xx + zz); R[5] = 2.0f*(yz - wx);
+    R[6] = 2.0f*(xz - wy);        R[7] = 2.0f*(yz + wx);        R[8] = 1.0f - 2.0f*(xx + yy);
+}
+
+// -------- integration --------
+void UpdateWorldInertia(RigidBodyStates& s, const uint32_t* slots, size_t n) {
+    for (size_t k = 0; k < n; ++k) {
+        const uint32_t i = slots[k];
+        // I^-1 world = R diag(I^-1 local) R^T
+        float R[9];
+        RotationFromQuaternion(s.orientation[i], R);
+        const Vector3 d = s.invInertiaLocal[i];
+        float* m = s.invInertiaWorld[i].m;
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                m[r*3 + c] = R[r*3]*d.x*R[c*3] + R[r*3 + 1]*d.y*R[c*3 + 1] + R[r*3 + 2]*d.z*R[c*3 + 2];
+    }
+}
+
+void IntegrateVelocities(RigidBodyStates& s, const uint32_t* slots, size_t n, Vector3 gravity, float dt) {
+    for (size_t k = 0; k < n; ++k) {
+        const uint32_t i = slots[k];
+        if (s.invMass[i] == 0.0f) continue;
+        Vector3& v = s.linearVelocity[i];
+        v = { v.x + gravity.x * dt, v.y + gravity.y * dt, v.z + gravity.z * dt };
+    }
+}
+
+void IntegratePositions(RigidBodyStates& s, const uint32_t* slots, size_t n, float dt) {
+    for (size_t k = 0; k < n; ++k) {
+        const uint32_t i = slots[k];
+        if (s.invMass[i] == 0.0f) continue;
+        const Vector3 v = s.linearVelocity[i];
+        Vector3& w = s.angularVelocity[i];
+        const float speed = std::sqrt(w.x*w.x + w.y*w.y + w.z*w.z);
+        if (speed > kMaxAngularSpeed) w = { w.x * kMaxAngularSpeed / speed, w.y * kMaxAngularSpeed / speed, w.z * kMaxAngularSpeed / speed };
+
+        Vector3& p = s.position[i];
+        p = { p.x + v.x * dt, p.y + v.y * dt, p.z + v.z * dt };
+
+        // q += 0.5 * dt * (w, 0) * q
+        Quaternion& q = s.orientation[i];
+        const float h = 0.5f * dt;
+        const Quaternion dq = {
+            h * ( w.x*q.w + w.y*q.z - w.z*q.y),
+            h * ( w.y*q.w + w.z*q.x - w.x*q.z),
+            h * ( w.z*q.w + w.x*q.y - w.y*q.x),
+            h * (-w.x*q.x - w.y*q.y - w.z*q.z) };
+        q = { q.x + dq.x, q.y + dq.y, q.z + dq.z, q.w + dq.w };
+        const float len = std::sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w);
+        q = { q.x / len, q.y / len, q.z / len, q.w / len };
+    }
+}
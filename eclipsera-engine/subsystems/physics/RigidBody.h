@@ -0,0 +1,61 @@
+#pragma once
+#include <raylib.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct CFrame;
+
+// Row-major 3x3 matrix, laid out like CFrame::R.
+struct Mat3 {
+    float m[9];
+};
+
+// Inverse mass and inverse principal inertia of a solid box.
+struct MassProperties {
+    float   invMass;
+    Vector3 invInertia;  // about the box's own axes
+};
+
+MassProperties BoxMassProperties(Vector3 size, float density);
+
+// Simulation state of every body, one array per quantity, indexed by body
+// slot like PhysicsWorld::Bodies(). Anchored bodies keep zero inverse mass and
+// inertia and are never awake.
+struct RigidBodyStates {
+    static constexpr uint32_t kNoIsland = 0xFFFFFFFFu;
+
+    std::vector<Vector3>    position;
+    std::vector<Quaternion> orientation;
+    std::vector<Vector3>    linearVelocity, angularVelocity;
+    std::vector<float>      invMass;
+    std::vector<Vector3>    invInertiaLocal;
+    std::vector<Mat3>       invInertiaWorld;  // refreshed for awake bodies by UpdateWorldInertia
+    std::vector<float>      friction, elasticity;
+    std::vector<float>      sleepTime;        // seconds spent below the sleep thresholds
+    std::vector<uint32_t>   sleepIsland;      // kNoIsland unless asleep
+    std::vector<uint8_t>    awake;
+
+    size_t Size() const { return position.size(); }
+    void Resize(size_t n);
+    void Move(size_t dst, size_t src);
+
+    // f(array) for every per-body array, stopping at the first false; for snapshots.
+    template <class States, class F>
+    static bool ForEachArray(States& s, F&& f) {
+        return f(s.position) && f(s.orientation) && f(s.linearVelocity) && f(s.angularVelocity)
+            && f(s.invMass) && f(s.invInertiaLocal) && f(s.invInertiaWorld) && f(s.friction)
+            && f(s.elasticity) && f(s.sleepTime) && f(s.sleepIsland) && f(s.awake);
+    }
+};
+
+void PoseFromCFrame(const CFrame& cf, Vector3& position, Quaternion& orientation);
+// Unit quaternion to a row-major rotation matrix (CFrame::R layout).
+void RotationFromQuaternion(Quaternion q, float R[9]);
+
+// Refresh invInertiaWorld from the current orientation for the listed slots.
+void UpdateWorldInertia(RigidBodyStates& s, const uint32_t* slots, size_t n);
+// Apply gravity to the listed slots.
+void IntegrateVelocities(RigidBodyStates& s, const uint32_t* slots, size_t n, Vector3 gravity, float dt);
+// Advance poses by the solved velocities for the listed slots.
+void IntegratePositions(RigidBodyStates& s, const uint32_t* slots, size_t n, float dt);
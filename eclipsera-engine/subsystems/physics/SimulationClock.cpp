@@ -0,0 +1,41 @@
+#include "subsystems/physics/SimulationClock.h"
+#include <algorithm>
+#include <cmath>
+
+void SimulationClock::SetRate(double stepsPerSecond) {
+    rate = std::clamp(stepsPerSecond, 1.0, 10000.0);
+    step = 1.0 / rate;
+    maxSteps = std::max(1, (int)(kMaxCatchUpTime * rate));
+    accumulator = std::min(accumulator, step * 0.999);
+}
+
+int SimulationClock::Advance(double frameDt) {
+    if (!(frameDt > 0.0)) return 0;
+    accumulator += frameDt;
+    int n = (int)std::floor(accumulator / step);
+    if (n > maxSteps) {
+        dropped += (uint64_t)(n - maxSteps);
+        n = maxSteps;
+        accumulator = std::fmod(accumulator, step);
+    } else {
+        accumulator -= n * step;
+    }
+    accumulator = std::clamp(accumulator, 0.0, step * 0.999);
+    time += n * step;
+    steps += (uint64_t)n;
+    return n;
+}
+
+void SimulationClock::Reset() {
+    accumulator = 0.0;
+    time = 0.0;
+    steps = 0;
+    dropped = 0;
+}
+
+void SimulationClock::SetState(const State& s) {
+    accumulator = std::clamp(s.accumulator, 0.0, step * 0.999);
+    time = s.time;
+    steps = s.steps;
+    dropped = s.dropped;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+// Fixed-rate simulation clock. Each frame adds its real duration to an
+// accumulator and runs as many whole steps as it holds, at most
+// kMaxCatchUpTime worth; time beyond that is dropped, so a long hitch slows
+// the simulation down instead of snowballing into ever longer frames. What is
+// left in the accumulator is how far the frame is past the last step, which
+// the renderer uses to interpolate.
+class SimulationClock {
+public:
+    static constexpr double kDefaultRate    = 240.0;  // steps per second
+    static constexpr double kMaxCatchUpTime = 0.1;    // seconds of steps one frame may run
+
+    void   SetRate(double stepsPerSecond);
+    double Rate() const { return rate; }
+    double StepSize() const { return step; }
+    int    MaxStepsPerFrame() const { return maxSteps; }
+
+    // Add a frame's duration; returns the number of steps to run now.
+    int    Advance(double frameDt);
+    // Fraction of a step accumulated past the last step, in [0, 1).
+    float  Alpha() const { return (float)(accumulator / step); }
+    // Simulated seconds at the end of the steps handed out so far.
+    double Time() const { return time; }
+    uint64_t Steps() const { return steps; }
+    uint64_t DroppedSteps() const { return dropped; }
+    void   Reset();
+
+    // Progress without the rate, for PhysicsWorld snapshots.
+    struct State {
+        double   accumulator, time;
+        uint64_t steps, dropped;
+    };
+    State  GetState() const { return { accumulator, time, steps, dropped }; }
+    void   SetState(const State& s);
+
+private:
+    double   rate{kDefaultRate};
+    double   step{1.0 / kDefaultRate};
+    int      maxSteps{(int)(kMaxCatchUpTime * kDefaultRate)};
+    double   accumulator{0.0};
+    double   time{0.0};
+    uint64_t steps{0};
+    uint64_t dropped{0};
+};
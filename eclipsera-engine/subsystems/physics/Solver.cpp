@@ -0,0 +1,301 @@
+#include "subsystems/physics/Solver.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// -------- islands --------
+uint32_t IslandBuilder::find(uint32_t slot) {
+    while (parent[slot] != slot) {
+        parent[slot] = parent[parent[slot]];
+        slot = parent[slot];
+    }
+    return slot;
+}
+
+void IslandBuilder::Build(const RigidBodyStates& s, const uint32_t* awakeBodies, size_t bodyCount,
+                          const Contact* cs, const BroadphasePair* bodyPairs, size_t contactCount) {
+    constexpr uint32_t kNone = 0xFFFFFFFFu;
+    if (parent.size() < s.Size()) { parent.resize(s.Size()); islandOf.resize(s.Size()); }
+    for (size_t k = 0; k < bodyCount; ++k) parent[awakeBodies[k]] = awakeBodies[k];
+
+    auto moving = [&](uint32_t slot){ return s.awake[slot] && s.invMass[slot] > 0.0f; };
+    for (size_t c = 0; c < contactCount; ++c) {
+        if (cs[c].manifold.count == 0) continue;
+        const uint32_t a = bodyPairs[c].a, b = bodyPairs[c].b;
+        if (!moving(a) || !moving(b)) continue;
+        const uint32_t ra = find(a), rb = find(b);
+        if (ra != rb) parent[ra] = rb;
+    }
+
+    // number the roots, then bucket bodies and contacts by island
+    uint32_t count = 0;
+    for (size_t k = 0; k < bodyCount; ++k) islandOf[awakeBodies[k]] = kNone;
+    for (size_t k = 0; k < bodyCount; ++k) {
+        const uint32_t r = find(awakeBodies[k]);
+        if (islandOf[r] == kNone) islandOf[r] = count++;
+    }
+
+    bodyStart.assign(count + 1, 0);
+    for (size_t k = 0; k < bodyCount; ++k) ++bodyStart[islandOf[find(awakeBodies[k])] + 1];
+    for (uint32_t i = 0; i < count; ++i) bodyStart[i + 1] += bodyStart[i];
+    bodies.resize(bodyCount);
+    for (size_t k = 0; k < bodyCount; ++k) {
+        const uint32_t i = islandOf[find(awakeBodies[k])];
+        bodies[bodyStart[i]++] = awakeBodies[k];
+    }
+    for (uint32_t i = count; i > 0; --i) bodyStart[i] = bodyStart[i - 1];
+    bodyStart[0] = 0;
+
+    contactIsland.resize(contactCount);
+    contactStart.assign(count + 1, 0);
+    for (size_t c = 0; c < contactCount; ++c) {
+        contactIsland[c] = kNone;
+        if (cs[c].manifold.count == 0) continue;
+        const uint32_t a = bodyPairs[c].a, b = bodyPairs[c].b;
+        const uint32_t owner = moving(a) ? a : moving(b) ? b : kNone;
+        if (owner == kNone) continue;
+        contactIsland[c] = islandOf[find(owner)];
+        ++contactStart[contactIsland[c] + 1];
+    }
+    for (uint32_t i = 0; i < count; ++i) contactStart[i + 1] += contactStart[i];
+    contacts.resize(contactStart[count]);
+    for (size_t c = 0; c < contactCount; ++c)
+        if (contactIsland[c] != kNone) contacts[contactStart[contactIsland[c]]++] = (uint32_t)c;
+    for (uint32_t i = count; i > 0; --i) contactStart[i] = contactStart[i - 1];
+    contactStart[0] = 0;
+}
+
+// -------- contact solver --------
+namespace {
+struct PointConstraint {
+    Vector3 rA, rB;              // anchors relative to the centres at the start of the step
+    float   normalMass, tangentMass[2];
+    float   adjustedSeparation;  // separation minus the anchors' offset along the normal
+    float   relativeVelocity;    // normal velocity before the solve, for restitution
+    float   normalImpulse, tangentImpulse[2];
+    float   maxNormalImpulse;
+};
+
+struct ContactConstraint {
+    uint32_t         a, b;
+    Vector3          normal, tangent[2];
+    float            friction, restitution;
+    Vector3          startA, startB;        // centres at the start of the step
+    Quaternion       startQA, startQB;      // conjugated orientations at the start of the step
+    int              count;
+    PointConstraint  points[ContactManifold::kMaxPoints];
+    ContactManifold* manifold;
+};
+}
+
+static inline Vector3 Add(Vector3 a, Vector3 b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+static inline Vector3 Sub(Vector3 a, Vector3 b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+static inline Vector3 Scale(Vector3 a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+static inline float   Dot(Vector3 a, Vector3 b) { return a.x*b.x + a.y*b.y + a.z*b.z; }
+static inline Vector3 Cross(Vector3 a, Vector3 b) { return { a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x }; }
+static inline Vector3 Mul(const Mat3& m, Vector3 v) {
+    return { m.m[0]*v.x + m.m[1]*v.y + m.m[2]*v.z, m.m[3]*v.x + m.m[4]*v.y + m.m[5]*v.z, m.m[6]*v.x + m.m[7]*v.y + m.m[8]*v.z };
+}
+static inline Quaternion Conjugate(Quaternion q) { return { -q.x, -q.y, -q.z, q.w }; }
+static inline Quaternion QMul(Quaternion a, Quaternion b) {
+    return { a.w*b.x + a.x*b.w + a.y*b.z - a.z*b.y,
+             a.w*b.y - a.x*b.z + a.y*b.w + a.z*b.x,
+             a.w*b.z + a.x*b.y - a.y*b.x + a.z*b.w,
+             a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z };
+}
+static inline Vector3 Rotate(Quaternion q, Vector3 v) {
+    const Vector3 u = { q.x, q.y, q.z };
+    const Vector3 t = Scale(Cross(u, v), 2.0f);
+    return Add(Add(v, Scale(t, q.w)), Cross(u, t));
+}
+
+static void Tangents(Vector3 n, Vector3& t1, Vector3& t2) {
+    t1 = std::fabs(n.x) >= 0.57735f ? Vector3{ n.y, -n.x, 0.0f } : Vector3{ 0.0f, n.z, -n.y };
+    t1 = Scale(t1, 1.0f / std::sqrt(Dot(t1, t1)));
+    t2 = Cross(n, t1);
+}
+
+static const Mat3 kZeroInertia{};
+
+namespace {
+// Velocities of the two bodies of one constraint, copied in and out so the
+// inner loops work on locals. Bodies that are not awake (anchored, or asleep
+// in another island) act as immovable.
+struct BodyPair {
+    RigidBodyStates& s;
+    const ContactConstraint& c;
+    float   mA, mB;
+    const Mat3 *iA, *iB;
+    Vector3 vA, wA, vB, wB;
+
+    BodyPair(RigidBodyStates& st, const ContactConstraint& cc) : s(st), c(cc) {
+        mA = s.awake[c.a] ? s.invMass[c.a] : 0.0f;
+        mB = s.awake[c.b] ? s.invMass[c.b] : 0.0f;
+        iA = mA > 0.0f ? &s.invInertiaWorld[c.a] : &kZeroInertia;
+        iB = mB > 0.0f ? &s.invInertiaWorld[c.b] : &kZeroInertia;
+        vA = s.linearVelocity[c.a]; wA = s.angularVelocity[c.a];
+        vB = s.linearVelocity[c.b]; wB = s.angularVelocity[c.b];
+    }
+    void store() {
+        if (mA > 0.0f) { s.linearVelocity[c.a] = vA; s.angularVelocity[c.a] = wA; }
+        if (mB > 0.0f) { s.linearVelocity[c.b] = vB; s.angularVelocity[c.b] = wB; }
+    }
+    Vector3 relative(const PointConstraint& p) const {
+        return Sub(Add(vB, Cross(wB, p.rB)), Add(vA, Cross(wA, p.rA)));
+    }
+    void apply(const PointConstraint& p, Vector3 P) {
+        vA = Sub(vA, Scale(P, mA)); wA = Sub(wA, Mul(*iA, Cross(p.rA, P)));
+        vB = Add(vB, Scale(P, mB)); wB = Add(wB, Mul(*iB, Cross(p.rB, P)));
+    }
+};
+}
+
+static float EffectiveMass(float mA, float mB, const Mat3& iA, const Mat3& iB, Vector3 rA, Vector3 rB, Vector3 d) {
+    const Vector3 ra = Cross(rA, d), rb = Cross(rB, d);
+    const float k = mA + mB + Dot(ra, Mul(iA, ra)) + Dot(rb, Mul(iB, rb));
+    return k > 0.0f ? 1.0f / k : 0.0f;
+}
+
+static void WarmStart(RigidBodyStates& s, std::vector<ContactConstraint>& cs) {
+    for (ContactConstraint& c : cs) {
+        BodyPair bp(s, c);
+        for (int q = 0; q < c.count; ++q) {
+            const PointConstraint& p = c.points[q];
+            bp.apply(p, Add(Scale(c.normal, p.normalImpulse),
+                            Add(Scale(c.tangent[0], p.tangentImpulse[0]), Scale(c.tangent[1], p.tangentImpulse[1]))));
+        }
+        bp.store();
+    }
+}
+
+// One Gauss-Seidel pass. Points are visited forwards or backwards on
+// alternate passes ('reverse'); a fixed order leaves a residual spin in the
+// same direction every step, which tips tall stacks over time.
+static void Solve(RigidBodyStates& s, std::vector<ContactConstraint>& cs, float h, bool useBias, bool reverse,
+                  const SolverSettings& st) {
+    const float invH = 1.0f / h;
+    for (ContactConstraint& c : cs) {
+        BodyPair bp(s, c);
+        // how far the bodies moved since the narrowphase ran
+        const Quaternion dqA = QMul(s.orientation[c.a], c.startQA), dqB = QMul(s.orientation[c.b], c.startQB);
+        const Vector3 dp = Sub(Sub(s.position[c.b], c.startB), Sub(s.position[c.a], c.startA));
+
+        for (int k = 0; k < c.count; ++k) {
+            PointConstraint& p = c.points[reverse ? c.count - 1 - k : k];
+            const Vector3 d = Add(dp, Sub(Rotate(dqB, p.rB), Rotate(dqA, p.rA)));
+            const float sep = Dot(d, c.normal) + p.adjustedSeparation;
+            // speculative points may close their gap this substep; penetrating ones get pushed out
+            float target = 0.0f;
+            if (sep > 0.0f) target = -sep * invH;
+            else if (useBias) target = std::min(st.baumgarte * std::max(0.0f, -sep - st.linearSlop) * invH, st.maxPushoutSpeed);
+            const float vn = Dot(bp.relative(p), c.normal);
+            const float old = p.normalImpulse;
+            p.normalImpulse = std::max(old + p.normalMass * (target - vn), 0.0f);
+            p.maxNormalImpulse = std::max(p.maxNormalImpulse, p.normalImpulse);
+            bp.apply(p, Scale(c.normal, p.normalImpulse - old));
+        }
+        for (int k = 0; k < c.count; ++k) {
+            PointConstraint& p = c.points[reverse ? c.count - 1 - k : k];
+            const float maxFriction = c.friction * p.normalImpulse;
+            for (int t = 0; t < 2; ++t) {
+                const float vt = Dot(bp.relative(p), c.tangent[t]);
+                const float old = p.tangentImpulse[t];
+                p.tangentImpulse[t] = std::clamp(old - p.tangentMass[t] * vt, -maxFriction, maxFriction);
+                bp.apply(p, Scale(c.tangent[t], p.tangentImpulse[t] - old));
+            }
+        }
+        bp.store();
+    }
+}
+
+float StepIsland(RigidBodyStates& s, const uint32_t* bodies, size_t bodyCount,
+                 Contact* contacts, const BroadphasePair* bodyPairs, const uint32_t* contactIds, size_t contactCount,
+                 Vector3 gravity, float dt, const SolverSettings& st) {
+    thread_local std::vector<ContactConstraint> cs;
+    const int substeps = std::max(st.substeps, 1);
+    const float h = dt / (float)substeps;
+
+    UpdateWorldInertia(s, bodies, bodyCount);
+
+    cs.resize(contactCount);
+    for (size_t k = 0; k < contactCount; ++k) {
+        const uint32_t id = contactIds[k];
+        ContactManifold& m = contacts[id].manifold;
+        ContactConstraint& c = cs[k];
+        c.a = bodyPairs[id].a;
+        c.b = bodyPairs[id].b;
+        c.normal = m.normal;
+        Tangents(c.normal, c.tangent[0], c.tangent[1]);
+        c.friction = std::sqrt(s.friction[c.a] * s.friction[c.b]);
+        c.restitution = std::max(s.elasticity[c.a], s.elasticity[c.b]);
+        c.startA = s.position[c.a];
+        c.startB = s.position[c.b];
+        c.startQA = Conjugate(s.orientation[c.a]);
+        c.startQB = Conjugate(s.orientation[c.b]);
+        c.count = m.count;
+        c.manifold = &m;
+
+        const BodyPair bp(s, c);
+        for (int q = 0; q < m.count; ++q) {
+            const ContactPoint& mp = m.points[q];
+            PointConstraint& p = c.points[q];
+            p.rA = Sub(mp.position, c.startA);
+            p.rB = Sub(mp.position, c.startB);
+            p.normalMass = EffectiveMass(bp.mA, bp.mB, *bp.iA, *bp.iB, p.rA, p.rB, c.normal);
+            p.tangentMass[0] = EffectiveMass(bp.mA, bp.mB, *bp.iA, *bp.iB, p.rA, p.rB, c.tangent[0]);
+            p.tangentMass[1] = EffectiveMass(bp.mA, bp.mB, *bp.iA, *bp.iB, p.rA, p.rB, c.tangent[1]);
+            p.adjustedSeparation = mp.separation - Dot(Sub(p.rB, p.rA), c.normal);
+            p.relativeVelocity = Dot(bp.relative(p), c.normal);
+            // the tangent basis is a function of the normal, so it holds still with it
+            p.normalImpulse = mp.normalImpulse;
+            p.tangentImpulse[0] = mp.tangentImpulse[0];
+            p.tangentImpulse[1] = mp.tangentImpulse[1];
+            p.maxNormalImpulse = 0.0f;
+        }
+    }
+
+    // substeps: gravity, warm start, biased solve, move, relax
+    bool reverse = false;
+    for (int i = 0; i < substeps; ++i) {
+        IntegrateVelocities(s, bodies, bodyCount, gravity, h);
+        WarmStart(s, cs);
+        for (int k = 0; k < st.velocityIterations; ++k, reverse = !reverse) Solve(s, cs, h, true, reverse, st);
+        IntegratePositions(s, bodies, bodyCount, h);
+        for (int k = 0; k < st.relaxIterations; ++k, reverse = !reverse) Solve(s, cs, h, false, reverse, st);
+    }
+
+    // restitution: bounce points that were closing fast and took an impulse
+    for (ContactConstraint& c : cs) {
+        if (c.restitution == 0.0f) continue;
+        BodyPair bp(s, c);
+        for (int q = 0; q < c.count; ++q) {
+            PointConstraint& p = c.points[q];
+            if (p.relativeVelocity > -st.restitutionThreshold || p.maxNormalImpulse == 0.0f) continue;
+            const float vn = Dot(bp.relative(p), c.normal);
+            const float old = p.normalImpulse;
+            p.normalImpulse = std::max(old - p.normalMass * (vn + c.restitution * p.relativeVelocity), 0.0f);
+            bp.apply(p, Scale(c.normal, p.normalImpulse - old));
+        }
+        bp.store();
+    }
+
+    for (const ContactConstraint& c : cs) {
+        for (int q = 0; q < c.count; ++q) {
+            ContactPoint& mp = c.manifold->points[q];
+            mp.normalImpulse = c.points[q].normalImpulse;
+            mp.tangentImpulse[0] = c.points[q].tangentImpulse[0];
+            mp.tangentImpulse[1] = c.points[q].tangentImpulse[1];
+        }
+    }
+
+    float minSleep = FLT_MAX;
+    const float lin2 = st.sleepLinearSpeed * st.sleepLinearSpeed, ang2 = st.sleepAngularSpeed * st.sleepAngularSpeed;
+    for (size_t k = 0; k < bodyCount; ++k) {
+        const uint32_t i = bodies[k];
+        const Vector3 v = s.linearVelocity[i], w = s.angularVelocity[i];
+        if (Dot(v, v) > lin2 || Dot(w, w) > ang2) s.sleepTime[i] = 0.0f;
+        else s.sleepTime[i] += dt;
+        minSleep = std::min(minSleep, s.sleepTime[i]);
+    }
+    return minSleep;
+}
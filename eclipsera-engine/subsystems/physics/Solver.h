@@ -0,0 +1,60 @@
+#pragma once
+#include <raylib.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "subsystems/physics/Collision.h"
+#include "subsystems/physics/RigidBody.h"
+
+struct SolverSettings {
+    int   substeps{8};
+    int   velocityIterations{2};        // per substep
+    int   relaxIterations{1};           // per substep
+    float baumgarte{0.2f};              // fraction of the penetration removed per step
+    float linearSlop{0.01f};            // studs of penetration left alone
+    float maxPushoutSpeed{10.0f};       // studs/s
+    float restitutionThreshold{5.0f};   // closing speed (studs/s) below which contacts do not bounce
+    float sleepLinearSpeed{0.3f};       // studs/s
+    float sleepAngularSpeed{0.1f};      // rad/s
+};
+
+// Awake bodies grouped by the touching contacts between them, as flat arrays
+// with offsets. Anchored bodies are never members; a contact against one
+// belongs to the other body's island, so islands share no bodies that move and
+// can be stepped on different threads.
+class IslandBuilder {
+public:
+    // 'bodyPairs' are the body slots of each contact, in step with 'contacts'.
+    // Only contacts with points and at least one listed body are used.
+    void Build(const RigidBodyStates& s, const uint32_t* awakeBodies, size_t bodyCount,
+               const Contact* contacts, const BroadphasePair* bodyPairs, size_t contactCount);
+
+    size_t Count() const { return bodyStart.empty() ? 0 : bodyStart.size() - 1; }
+    const uint32_t* Bodies(size_t i) const { return bodies.data() + bodyStart[i]; }
+    size_t BodyCount(size_t i) const { return bodyStart[i + 1] - bodyStart[i]; }
+    const uint32_t* Contacts(size_t i) const { return contacts.data() + contactStart[i]; }  // indices into Build's contacts
+    size_t ContactCount(size_t i) const { return contactStart[i + 1] - contactStart[i]; }
+
+private:
+    uint32_t find(uint32_t slot);
+
+    std::vector<uint32_t> parent;       // union-find by body slot; only awake entries are meaningful
+    std::vector<uint32_t> islandOf;     // by body slot, for roots
+    std::vector<uint32_t> bodies, bodyStart;
+    std::vector<uint32_t> contacts, contactStart;
+    std::vector<uint32_t> contactIsland;
+};
+
+// Step one island with a sequential-impulse contact solver (Catto), split
+// into substeps that reuse the manifolds from the narrowphase: each applies
+// gravity, warm starts from the accumulated impulses, solves with a
+// penetration bias, moves the bodies and relaxes without the bias so the
+// pushout does not turn into bounce. Point separations are tracked through
+// the substeps from the bodies' motion. Restitution is applied last; friction
+// is clamped per tangent by the normal impulse. Accumulated impulses are
+// written back into the manifolds for the next step. Returns the smallest
+// sleep time in the island, after advancing each body's by dt (or resetting it
+// when the body moves).
+float StepIsland(RigidBodyStates& s, const uint32_t* bodies, size_t bodyCount,
+                 Contact* contacts, const BroadphasePair* bodyPairs, const uint32_t* contactIds, size_t contactCount,
+                 Vector3 gravity, float dt, const SolverSettings& settings);
@@ -0,0 +1,56 @@
+-- Broadphase benchmark
+-- COUNT unanchored parts in a grid with gaps narrower than the broadphase
+-- margin, so every part has candidate pairs with its neighbours. Each frame
+-- MOVE_FRACTION of them jitter in place. The time between PreSimulation and
+-- PostSimulation is the physics step: journal sync plus pair finding for the
+-- parts that left their fat boxes. Try COUNT 10000 / 100000 with
+-- MOVE_FRACTION 0.01 / 0.1.
+
+local RunService = game:GetService("RunService")
+
+local COUNT = 10000
+local MOVE_FRACTION = 0.01
+local MOVERS = math.max(1, math.floor(COUNT * MOVE_FRACTION))
+local SIDE = math.ceil(COUNT ^ (1 / 3))
+local SPACING = 2.1
+
+local base = Instance.new("Part")
+base.Anchored = false
+base.Size = Vector3.new(2, 2, 2)
+
+local parts = table.create(COUNT)
+local home = table.create(COUNT)
+local t0 = os.clock()
+for i = 1, COUNT do
+	local p = base:Clone()
+	local x = (i - 1) % SIDE
+	local y = ((i - 1) // SIDE) % SIDE
+	local z = (i - 1) // (SIDE * SIDE)
+	home[i] = Vector3.new((x - SIDE / 2) * SPACING, 1 + y * SPACING, (z - SIDE / 2) * SPACING)
+	p.Position = home[i]
+	p.Parent = workspace
+	parts[i] = p
+end
+print(string.format("built %d parts in %.2f s", COUNT, os.clock() - t0))
+
+local rng = Random.new(1)
+local cursor = 1
+local stepStart = 0
+local frames, stepTime = 0, 0
+
+RunService.PreSimulation:Connect(function()
+	for _ = 1, MOVERS do
+		local h = home[cursor]
+		parts[cursor].Position = h + Vector3.new(rng:NextNumber(-0.3, 0.3), rng:NextNumber(-0.3, 0.3), rng:NextNumber(-0.3, 0.3))
+		cursor = cursor % COUNT + 1
+	end
+	stepStart = os.clock()
+end)
+
+RunService.PostSimulation:Connect(function()
+	stepTime += os.clock() - stepStart
+	frames += 1
+	if frames % 120 == 0 then
+		print(string.format("%d parts, %d moving: physics step %.3f ms", COUNT, MOVERS, stepTime * 1000 / frames))
+	end
+end)
@@ -0,0 +1,58 @@
+-- Narrowphase benchmark
+-- COUNT unanchored boxes packed in a grid with random rotations, spaced so
+-- most neighbours overlap slightly. Every cached contact pair runs the
+-- separating-axis test and builds its manifold each step, so the physics
+-- step time is dominated by the narrowphase. Each frame MOVE_FRACTION of the
+-- boxes re-roll their rotation. Try COUNT 10000 / 50000.
+
+local RunService = game:GetService("RunService")
+
+local COUNT = 10000
+local MOVE_FRACTION = 0.05
+local MOVERS = math.max(1, math.floor(COUNT * MOVE_FRACTION))
+local SIDE = math.ceil(COUNT ^ (1 / 3))
+local SPACING = 2.2
+
+local rng = Random.new(1)
+local function randomRotation()
+	return CFrame.Angles(rng:NextNumber(0, math.pi * 2), rng:NextNumber(0, math.pi * 2), rng:NextNumber(0, math.pi * 2))
+end
+
+local base = Instance.new("Part")
+base.Anchored = false
+base.Size = Vector3.new(2, 2, 2)
+
+local parts = table.create(COUNT)
+local home = table.create(COUNT)
+local t0 = os.clock()
+for i = 1, COUNT do
+	local p = base:Clone()
+	local x = (i - 1) % SIDE
+	local y = ((i - 1) // SIDE) % SIDE
+	local z = (i - 1) // (SIDE * SIDE)
+	home[i] = CFrame.new((x - SIDE / 2) * SPACING, 1 + y * SPACING, (z - SIDE / 2) * SPACING)
+	p.CFrame = home[i] * randomRotation()
+	p.Parent = workspace
+	parts[i] = p
+end
+print(string.format("built %d parts in %.2f s", COUNT, os.clock() - t0))
+
+local cursor = 1
+local stepStart = 0
+local frames, stepTime = 0, 0
+
+RunService.PreSimulation:Connect(function()
+	for _ = 1, MOVERS do
+		parts[cursor].CFrame = home[cursor] * randomRotation()
+		cursor = cursor % COUNT + 1
+	end
+	stepStart = os.clock()
+end)
+
+RunService.PostSimulation:Connect(function()
+	stepTime += os.clock() - stepStart
+	frames += 1
+	if frames % 120 == 0 then
+		print(string.format("%d boxes, %d re-rotated: physics step %.3f ms", COUNT, MOVERS, stepTime * 1000 / frames))
+	end
+end)
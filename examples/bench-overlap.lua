@@ -0,0 +1,67 @@
+-- Spatial query benchmark
+-- COUNT anchored parts scattered over a square field. QUERIES random points
+-- are looked up three ways: the naive scan (every descendant, distance
+-- computed in Lua), workspace:GetPartBoundsInRadius and
+-- workspace:GetPartBoundsInBox. The scan tests part centres only, so it finds
+-- slightly fewer parts than the exact queries, which test each part's box.
+-- Runs headless: --headless --no-place --path examples/bench-overlap.lua
+
+local COUNT = 100000
+local EXTENT = 2000
+local QUERIES = 200
+local RADIUS = 20
+
+local rng = Random.new(1)
+local base = Instance.new("Part")
+base.Anchored = true
+base.Size = Vector3.new(2, 2, 2)
+
+local t0 = os.clock()
+for _ = 1, COUNT do
+	local p = base:Clone()
+	p.Position = Vector3.new(rng:NextNumber(-EXTENT / 2, EXTENT / 2), rng:NextNumber(0, 50), rng:NextNumber(-EXTENT / 2, EXTENT / 2))
+	p.Parent = workspace
+end
+print(string.format("built %d parts in %.2f s", COUNT, os.clock() - t0))
+
+local points = table.create(QUERIES)
+for i = 1, QUERIES do
+	points[i] = Vector3.new(rng:NextNumber(-EXTENT / 2, EXTENT / 2), 25, rng:NextNumber(-EXTENT / 2, EXTENT / 2))
+end
+
+local function report(name, seconds, found)
+	print(string.format("%-22s %8.3f ms/query, %d parts found", name, seconds * 1000 / QUERIES, found))
+end
+
+-- naive scan
+local found = 0
+t0 = os.clock()
+for i = 1, QUERIES do
+	local c = points[i]
+	for _, d in workspace:GetDescendants() do
+		if d:IsA("BasePart") and (d.Position - c).Magnitude <= RADIUS then
+			found += 1
+		end
+	end
+end
+report("GetDescendants scan", os.clock() - t0, found)
+
+-- the first query syncs the physics world; keep it out of the timing
+workspace:GetPartBoundsInRadius(points[1], RADIUS)
+
+found = 0
+t0 = os.clock()
+for i = 1, QUERIES do
+	found += #workspace:GetPartBoundsInRadius(points[i], RADIUS)
+end
+report("GetPartBoundsInRadius", os.clock() - t0, found)
+
+local params = OverlapParams.new()
+params.MaxParts = 16
+local size = Vector3.new(RADIUS * 2, 50, RADIUS * 2)
+found = 0
+t0 = os.clock()
+for i = 1, QUERIES do
+	found += #workspace:GetPartBoundsInBox(CFrame.new(points[i]), size, params)
+end
+report("GetPartBoundsInBox (16)", os.clock() - t0, found)
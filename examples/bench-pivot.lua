@@ -0,0 +1,70 @@
+-- Assembly move benchmark
+-- COUNT anchored parts are spun about a centre for FRAMES frames, the way
+-- visual-wireframe-sphere.lua does it, three ways: a Lua loop that rewrites
+-- every part's CFrame from a table of relative CFrames, Model:PivotTo on the
+-- unwelded parts, and PivotTo on the same parts welded into one assembly.
+
+local COUNT = 10000
+local FRAMES = 200
+
+local rng = Random.new(1)
+local center = CFrame.new(0, 20, 0)
+
+local model = Instance.new("Model")
+local parts = table.create(COUNT)
+local rel = table.create(COUNT)
+for i = 1, COUNT do
+	local p = Instance.new("Part")
+	p.Anchored = true
+	p.CanCollide = false
+	p.Size = Vector3.new(0.3, 0.3, 1)
+	p.CFrame = center * CFrame.new(rng:NextNumber(-15, 15), rng:NextNumber(-15, 15), rng:NextNumber(-15, 15))
+		* CFrame.Angles(rng:NextNumber(0, 6), rng:NextNumber(0, 6), 0)
+	p.Parent = model
+	parts[i] = p
+	rel[i] = center:ToObjectSpace(p.CFrame)
+end
+model.WorldPivot = center
+model.Parent = workspace
+
+local function spin(frame)
+	local angle = frame * math.rad(1)
+	return center * CFrame.Angles(angle * 0.5, angle, 0)
+end
+
+local function run(label, move)
+	local t0 = os.clock()
+	for frame = 1, FRAMES do
+		move(spin(frame))
+	end
+	local dt = os.clock() - t0
+	print(string.format("%-22s %8.3f ms/frame  %6.1f ns/part", label, dt * 1000 / FRAMES, dt * 1e9 / (FRAMES * COUNT)))
+	return dt
+end
+
+local loop = run("Lua CFrame loop", function(cf)
+	for i = 1, COUNT do
+		parts[i].CFrame = cf * rel[i]
+	end
+end)
+
+local pivot = run("Model:PivotTo", function(cf)
+	model:PivotTo(cf)
+end)
+
+for i = 2, COUNT do
+	local w = Instance.new("WeldConstraint")
+	w.Part0 = parts[1]
+	w.Part1 = parts[i]
+	w.Parent = parts[i]
+end
+model.PrimaryPart = parts[1]
+local root = parts[1].CFrame
+-- the first move groups the welds; keep it out of the timing
+model:PivotTo(root)
+
+local welded = run("welded PivotTo", function(cf)
+	model:PivotTo(cf * rel[1])
+end)
+
+print(string.format("PivotTo %.1fx, welded %.1fx faster than the Lua loop", loop / pivot, loop / welded))
@@ -0,0 +1,65 @@
+-- Rigid-body solver benchmark
+-- STACKS towers of HEIGHT unanchored 2-stud cubes on an anchored floor, spread
+-- out so each tower is its own island. The towers settle, then fall asleep
+-- and stop costing anything; every KNOCK_EVERY frames one of them is hit from
+-- the side, which wakes just that island. The time between PreSimulation and
+-- PostSimulation is the physics step: sync, broadphase, narrowphase for the
+-- pairs with an awake body, and the island solve.
+
+local RunService = game:GetService("RunService")
+
+local STACKS = 100
+local HEIGHT = 10
+local KNOCK_EVERY = 60
+local SIDE = math.ceil(math.sqrt(STACKS))
+local SPACING = 6
+
+local floor = Instance.new("Part")
+floor.Anchored = true
+floor.Size = Vector3.new(SIDE * SPACING + 8, 1, SIDE * SPACING + 8)
+floor.Position = Vector3.new(0, -0.5, 0)
+floor.Parent = workspace
+
+local base = Instance.new("Part")
+base.Anchored = false
+base.Size = Vector3.new(2, 2, 2)
+
+local stacks = table.create(STACKS)
+local t0 = os.clock()
+for s = 1, STACKS do
+	local x = ((s - 1) % SIDE - SIDE / 2) * SPACING
+	local z = ((s - 1) // SIDE - SIDE / 2) * SPACING
+	local tower = table.create(HEIGHT)
+	for h = 1, HEIGHT do
+		local p = base:Clone()
+		p.Position = Vector3.new(x, 1 + (h - 1) * 2, z)
+		p.Parent = workspace
+		tower[h] = p
+	end
+	stacks[s] = tower
+end
+print(string.format("built %d towers of %d in %.2f s", STACKS, HEIGHT, os.clock() - t0))
+
+local rng = Random.new(1)
+local stepStart = 0
+local frames, stepTime = 0, 0
+
+RunService.PreSimulation:Connect(function()
+	if frames > 0 and frames % KNOCK_EVERY == 0 then
+		-- a script move teleports the part and wakes the tower it belongs to
+		local tower = stacks[rng:NextInteger(1, STACKS)]
+		local p = tower[rng:NextInteger(1, HEIGHT)]
+		if p.Parent then
+			p.Position = p.Position + Vector3.new(0.5, 0, 0)
+		end
+	end
+	stepStart = os.clock()
+end)
+
+RunService.PostSimulation:Connect(function()
+	stepTime += os.clock() - stepStart
+	frames += 1
+	if frames % 120 == 0 then
+		print(string.format("%d bodies in %d towers: physics step %.3f ms", STACKS * HEIGHT, STACKS, stepTime * 1000 / frames))
+	end
+end)
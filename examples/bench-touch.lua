@@ -0,0 +1,58 @@
+-- Touch event benchmark
+-- COUNT unanchored 2-stud cubes dropped in a grid onto an anchored floor, with
+-- Touched and TouchEnded connected on every cube. They land, settle into
+-- resting contact and fall asleep; from then on the touching pairs are
+-- re-diffed every step but produce no events. Every BUMP_EVERY steps a row of
+-- cubes is lifted a little, so its touches end and begin again when it lands.
+-- Run with --fast-sim to get the engine's own touch timings: the per-step diff
+-- of the touching pairs and the signal dispatch time.
+
+local RunService = game:GetService("RunService")
+
+local SIDE = 60
+local COUNT = SIDE * SIDE
+local SPACING = 2.5
+local BUMP_EVERY = 30
+
+local floor = Instance.new("Part")
+floor.Anchored = true
+floor.Size = Vector3.new(SIDE * SPACING + 8, 1, SIDE * SPACING + 8)
+floor.Position = Vector3.new(0, -0.5, 0)
+floor.Parent = workspace
+
+local began, ended = 0, 0
+local function onTouched() began += 1 end
+local function onTouchEnded() ended += 1 end
+
+local base = Instance.new("Part")
+base.Size = Vector3.new(2, 2, 2)
+local rows = table.create(SIDE)
+for z = 1, SIDE do
+	local row = table.create(SIDE)
+	for x = 1, SIDE do
+		local p = base:Clone()
+		p.Position = Vector3.new((x - SIDE / 2) * SPACING, 1.5, (z - SIDE / 2) * SPACING)
+		p.Touched:Connect(onTouched)
+		p.TouchEnded:Connect(onTouchEnded)
+		p.Parent = workspace
+		row[x] = p
+	end
+	rows[z] = row
+end
+
+local steps, bumped = 0, 0
+RunService.PreSimulation:Connect(function()
+	steps += 1
+	if steps % BUMP_EVERY == 0 then
+		bumped = bumped % SIDE + 1
+		for _, p in rows[bumped] do
+			p.Position = p.Position + Vector3.new(0, 0.5, 0)
+		end
+	end
+end)
+
+RunService.PostSimulation:Connect(function()
+	if steps % 240 == 0 then
+		print(string.format("%d cubes, step %d: %d Touched and %d TouchEnded so far", COUNT, steps, began, ended))
+	end
+end)
@@ -1,5 +1,5 @@
 -- Advanced Luau scripting
--- CFrame, math, rotation, RunService, RenderStepped
+-- CFrame, math, rotation, Model:PivotTo, RunService, RenderStepped
 
 --[[
 Wireframe Sphere Demo (Lat + Lon)
@@ -16,6 +16,12 @@ local sphereCenter = Vector3.new(0, 20, 0)
 local color = Color3.fromRGB(255, 255, 0)
 local transparency = 0
 
+-- Every part goes in one model, pivoted about the sphere's center
+local model = Instance.new("Model")
+model.Name = "WireframeSphere"
+model.WorldPivot = CFrame.new(sphereCenter)
+model.Parent = workspace
+
 -- Part template
 local function createPart()
 	local p = Instance.new("Part")
@@ -24,16 +30,13 @@ local function createPart()
 	p.Size = Vector3.new(thickness, thickness, 1)
 	p.Color = color
 	p.Transparency = transparency
-	p.Parent = workspace
+	p.Parent = model
 	return p
 end
 
--- Storage
-local parts = {}
-local rel = {}
 local centerCF = CFrame.new(sphereCenter)
 
--- Helper to connect two points with a part and cache local-space transform
+-- Helper to connect two points with a part
 local function connectPoints(p1, p2)
 	local dir = p2 - p1
 	if dir.Magnitude <= 1e-6 then return end
@@ -41,8 +44,6 @@ local function connectPoints(p1, p2)
 	local part = createPart()
 	part.Size = Vector3.new(thickness, thickness, dir.Magnitude)
 	part.CFrame = CFrame.new(mid, p2)
-	table.insert(parts, part)
-	table.insert(rel, centerCF:ToObjectSpace(part.CFrame))
 end
 
 -- Longitude (vertical great circles)
@@ -91,12 +92,9 @@ for j = 1, segments - 1 do
 	end
 end
 
--- Rigid rotation about center
+-- Rigid rotation about center: one PivotTo moves every part natively
 local angle = 0
 RunService.RenderStepped:Connect(function(dt)
 	angle += dt * math.rad(20)
-	local spin = centerCF * CFrame.Angles(angle * 0.5, angle, 0)
-	for i = 1, #parts do
-		parts[i].CFrame = spin * rel[i]
-	end
+	model:PivotTo(centerCF * CFrame.Angles(angle * 0.5, angle, 0))
 end)